@@ -3,9 +3,52 @@
 #include <string.h>
 
 static const size_t BASE_CAPACITY = 8;
+static const size_t BASE_INLINE_EDGES = 3;
+static const size_t MAX_INLINE_EDGE_BYTES = 48;
 
 const uint32_t INVALID_ADJGRAPH_NODE = UINT32_MAX;
 
+DEFINE_TYPED_ORDERED_SET(id, uint32_t, DEFAULT_LESS_THAN)
+
+static inline ordered_set_t* in_edges_adj_graph(const adjacency_graph_t* graph, uint32_t id)
+{
+    return graph->in_edges_ + id;
+}
+
+static inline size_t align_slot_adj(size_t bytes)
+{
+    return (bytes + 7) & ~(size_t)7;
+}
+
+/* Number of edges stored in the node record, fewer than BASE_INLINE_EDGES when the edge data is large */
+static inline size_t inline_edges_adj(size_t edge_element_size)
+{
+    size_t pair_size = sizeof(uint32_t) + edge_element_size;
+    return pair_size * BASE_INLINE_EDGES <= MAX_INLINE_EDGE_BYTES ? BASE_INLINE_EDGES : MAX_INLINE_EDGE_BYTES / pair_size;
+}
+
+static inline size_t slot_size_adj(size_t node_element_size, size_t edge_element_size)
+{
+    return sizeof(ordered_map_t) + align_slot_adj(node_element_size)
+        + align_slot_adj(inline_edges_adj(edge_element_size) * (sizeof(uint32_t) + edge_element_size));
+}
+
+static inline void* inline_edges_buffer_adj(const adjacency_graph_t* graph, uint32_t id)
+{
+    return (void*)get_edgelist_adj_graph(graph, id) + sizeof(ordered_map_t) + align_slot_adj(graph->node_element_size_);
+}
+
+/* Points the edge lists still stored in their node record to the record's new address after the array moved */
+static void relocate_inline_edges_adj(adjacency_graph_t* graph)
+{
+    for (uint32_t i = 0; i < graph->nodes_; ++i)
+    {
+        ordered_map_t* edge_list = get_edgelist_adj_graph(graph, i);
+        if (edge_list->borrowed_)
+            edge_list->data_ = inline_edges_buffer_adj(graph, i);
+    }
+}
+
 adjacency_graph_t create_adj_graph(size_t capacity, size_t node_element_size, size_t edge_element_size)
 {
     adjacency_graph_t out;
@@ -14,13 +57,16 @@ adjacency_graph_t create_adj_graph(size_t capacity, size_t node_element_size, si
     out.edge_element_size_ = edge_element_size;
     out.capacity_ = capacity;
     out.nodes_ = 0;
-    out.data_ = malloc((node_element_size + sizeof(ordered_map_t)) * capacity);
+    out.data_ = malloc(slot_size_adj(node_element_size, edge_element_size) * capacity);
+    out.in_edges_ = NULL;
+    out.free_nodes_ = create_array_list(0, sizeof(uint32_t));
 
     return out;
 }
 
 void destroy_adj_graph(adjacency_graph_t* graph)
 {
+    set_in_edge_index_adj_graph(graph, 0);
     for (size_t i = 0; i < graph->nodes_; ++i)
     {
         if (is_valid_node_adj(graph, i))
@@ -30,6 +76,7 @@ void destroy_adj_graph(adjacency_graph_t* graph)
     graph->capacity_ = 0;
     graph->node_element_size_ = 0;
     graph->edge_element_size_ = 0;
+    destroy_array_list(&graph->free_nodes_);
     free(graph->data_);
     graph->data_ = NULL;
 }
@@ -38,32 +85,45 @@ void reserve_adj_graph(adjacency_graph_t* graph, size_t capacity)
 {
     if (capacity > graph->capacity_)
     {
-        graph->data_ = realloc(graph->data_, (graph->node_element_size_ + sizeof(ordered_map_t)) * capacity);
+        void* old_data = graph->data_;
+        graph->data_ = realloc(graph->data_, slot_size_adj(graph->node_element_size_, graph->edge_element_size_) * capacity);
+        if (graph->data_ != old_data)
+            relocate_inline_edges_adj(graph);
+        if (graph->in_edges_ != NULL)
+            graph->in_edges_ = (ordered_set_t*)realloc(graph->in_edges_, capacity * sizeof(ordered_set_t));
         graph->capacity_ = capacity;
     }
 }
 
 void reuse_adj_graph(adjacency_graph_t* graph, size_t capacity, size_t node_element_size, size_t edge_element_size)
 {
-    if ((node_element_size + sizeof(ordered_map_t)) * capacity > (graph->node_element_size_ + sizeof(ordered_map_t)) * graph->capacity_)
+    /* Every node is removed, add_node_adj_graph creates new edge lists */
+    for (size_t i = 0; i < graph->nodes_; ++i)
     {
-        graph->data_ = realloc(graph->data_, (node_element_size + sizeof(ordered_map_t)) * capacity);
-        graph->capacity_ = capacity;
+        if (is_valid_node_adj(graph, i))
+            destroy_ordered_map(get_edgelist_adj_graph(graph, i));
+        if (graph->in_edges_ != NULL)
+            destroy_ordered_set(in_edges_adj_graph(graph, i));
     }
-    else
+
+    size_t old_slot_size = slot_size_adj(graph->node_element_size_, graph->edge_element_size_);
+    size_t slot_size = slot_size_adj(node_element_size, edge_element_size);
+    if (slot_size * capacity > old_slot_size * graph->capacity_)
     {
-        graph->capacity_ = ((graph->node_element_size_ + sizeof(ordered_map_t)) * graph->capacity_) / (node_element_size + sizeof(ordered_map_t));
+        graph->data_ = realloc(graph->data_, slot_size * capacity);
+        graph->capacity_ = capacity;
     }
-
-    for (size_t i = 0; i < graph->nodes_; ++i)
+    else
     {
-        if (is_valid_node_adj(graph, i))
-            reuse_ordered_map(get_edgelist_adj_graph(graph, i), sizeof(uint32_t), edge_element_size, 1, index_compare_func);
+        graph->capacity_ = (old_slot_size * graph->capacity_) / slot_size;
     }
+    if (graph->in_edges_ != NULL)
+        graph->in_edges_ = (ordered_set_t*)realloc(graph->in_edges_, graph->capacity_ * sizeof(ordered_set_t));
 
     graph->nodes_ = 0;
     graph->node_element_size_ = node_element_size;
     graph->edge_element_size_ = edge_element_size;
+    reuse_array_list(&graph->free_nodes_, 0, sizeof(uint32_t));
 }
 
 size_t next_adj_graph_capacity(size_t current_capacity)
@@ -73,7 +133,7 @@ size_t next_adj_graph_capacity(size_t current_capacity)
 
 uint32_t get_node_id_adj(adjacency_graph_t* graph, const void* node)
 {
-    return ((uintptr_t)node - (uintptr_t)graph->data_) / (graph->node_element_size_ + sizeof(ordered_map_t));
+    return ((uintptr_t)node - (uintptr_t)graph->data_) / slot_size_adj(graph->node_element_size_, graph->edge_element_size_);
 }
 
 void* get_node_adj_graph(const adjacency_graph_t* graph, uint32_t id)
@@ -93,19 +153,47 @@ int index_compare_func(const void* left, const void* right)
 
 uint32_t add_node_adj_graph(adjacency_graph_t* graph, const void* node_data)
 {
-    if (graph->nodes_ == graph->capacity_)
-        reserve_adj_graph(graph, next_adj_graph_capacity(graph->capacity_));
+    uint32_t id;
+
+    if (graph->free_nodes_.size_ != 0)
+    {
+        pop_back_array_list(&graph->free_nodes_, &id);
+        if (graph->in_edges_ != NULL)
+            destroy_ordered_set(in_edges_adj_graph(graph, id));
+    }
+    else
+    {
+        if (graph->nodes_ == graph->capacity_)
+            reserve_adj_graph(graph, next_adj_graph_capacity(graph->capacity_));
+        id = graph->nodes_++;
+    }
 
-    ordered_map_t* edge_list = get_edgelist_adj_graph(graph, graph->nodes_);
-    *edge_list = create_ordered_map(sizeof(uint32_t), graph->edge_element_size_, edgelist_capacity_adj(graph->nodes_), index_compare_func);
-    memcpy((void*)edge_list + sizeof(ordered_map_t), node_data, graph->node_element_size_);
+    init_edgelist_adj_graph(graph, id, 0);
+    memcpy(get_node_adj_graph(graph, id), node_data, graph->node_element_size_);
+    if (graph->in_edges_ != NULL)
+        *in_edges_adj_graph(graph, id) = create_id_oset(0);
 
-    return graph->nodes_++;
+    return id;
 }
 
 ordered_map_t* get_edgelist_adj_graph(const adjacency_graph_t* graph, uint32_t id)
 {
-    return graph->data_ + ((graph->node_element_size_ + sizeof(ordered_map_t)) * id);
+    return graph->data_ + (slot_size_adj(graph->node_element_size_, graph->edge_element_size_) * id);
+}
+
+void init_edgelist_adj_graph(adjacency_graph_t* graph, uint32_t id, size_t capacity)
+{
+    ordered_map_t* edge_list = get_edgelist_adj_graph(graph, id);
+    size_t inline_edges = inline_edges_adj(graph->edge_element_size_);
+
+    if (inline_edges != 0 && capacity <= inline_edges)
+        *edge_list = create_ordered_map_in_buffer(sizeof(uint32_t), graph->edge_element_size_, inline_edges_buffer_adj(graph, id), inline_edges, index_compare_func);
+    else
+    {
+        capacity = capacity ? capacity : edgelist_capacity_adj(graph->nodes_);
+        *edge_list = create_ordered_map(sizeof(uint32_t), graph->edge_element_size_, capacity, index_compare_func);
+    }
+    set_key_kind_ordered_map(edge_list, KEY_KIND_UINT32);
 }
 
 static size_t great_bit(size_t val)
@@ -127,15 +215,97 @@ size_t edgelist_capacity_adj(size_t nodes)
 void extract_node_adj_graph(adjacency_graph_t* graph, uint32_t id, void* data)
 {
     memcpy(data, get_node_adj_graph(graph, id), graph->node_element_size_);
-    destroy_ordered_map(get_edgelist_adj_graph(graph, id));
+    delete_node_adj_agraph(graph, id);
 }
 
 void delete_node_adj_agraph(adjacency_graph_t* graph, uint32_t id)
 {
+    if (!is_valid_node_adj(graph, id))
+        return;
+
     disconnect_allto_adj_graph(graph, id);
-    destroy_ordered_map(get_edgelist_adj_graph(graph, id));
-    //memset(get_node_adj_graph(graph, id), 0, graph->node_element_size_);
-    //--graph->nodes_;
+    if (graph->in_edges_ != NULL)
+    {
+        disconnect_allfrom_adj_graph(graph, id);
+        destroy_ordered_set(in_edges_adj_graph(graph, id));
+    }
+    ordered_map_t* edge_list = get_edgelist_adj_graph(graph, id);
+    destroy_ordered_map(edge_list);
+    push_back_array_list(&graph->free_nodes_, &id);
+}
+
+array_list_t compact_adj_graph(adjacency_graph_t* graph)
+{
+    const uint32_t invalid = INVALID_ADJGRAPH_NODE;
+    size_t slot_size = slot_size_adj(graph->node_element_size_, graph->edge_element_size_);
+    array_list_t remap = create_array_list(graph->nodes_, sizeof(uint32_t));
+    resize_array_list(&remap, graph->nodes_);
+    fill_array_list(&remap, &invalid);
+
+    uint32_t* new_ids = (uint32_t*)remap.data_;
+    uint32_t nodes = 0;
+    for (uint32_t i = 0; i < graph->nodes_; ++i)
+    {
+        if (!is_valid_node_adj(graph, i))
+        {
+            if (graph->in_edges_ != NULL)
+                destroy_ordered_set(in_edges_adj_graph(graph, i));
+            continue;
+        }
+
+        /* A node only moves towards the front, to a slot that is already free */
+        new_ids[i] = nodes;
+        if (nodes != i)
+        {
+            memcpy(graph->data_ + nodes * slot_size, graph->data_ + i * slot_size, slot_size);
+            ordered_map_t* edge_list = get_edgelist_adj_graph(graph, nodes);
+            if (edge_list->borrowed_)
+                edge_list->data_ = inline_edges_buffer_adj(graph, nodes);
+            if (graph->in_edges_ != NULL)
+                graph->in_edges_[nodes] = graph->in_edges_[i];
+        }
+        ++nodes;
+    }
+
+    /* The new ids keep the order of the old ones, so the keys are rewritten in place and stay sorted */
+    span_t run;
+    for (uint32_t i = 0; i < nodes; ++i)
+    {
+        const ordered_map_t* edge_list = get_edgelist_adj_graph(graph, i);
+        for (size_t j = 0; j < edge_list->size_; j += run.count_)
+        {
+            run = keys_span_ordered_map(edge_list, j);
+            for (size_t k = 0; k < run.count_; ++k)
+            {
+                uint32_t* key = (uint32_t*)at_span(&run, k);
+                *key = new_ids[*key];
+            }
+        }
+
+        if (graph->in_edges_ != NULL)
+        {
+            const ordered_set_t* sources = in_edges_adj_graph(graph, i);
+            for (size_t j = 0; j < sources->size_; j += run.count_)
+            {
+                run = span_ordered_set(sources, j);
+                for (size_t k = 0; k < run.count_; ++k)
+                {
+                    uint32_t* source = (uint32_t*)at_span(&run, k);
+                    *source = new_ids[*source];
+                }
+            }
+        }
+    }
+
+    graph->nodes_ = nodes;
+    graph->capacity_ = nodes ? nodes : 1;
+    graph->data_ = realloc(graph->data_, graph->capacity_ * slot_size);
+    relocate_inline_edges_adj(graph);
+    if (graph->in_edges_ != NULL)
+        graph->in_edges_ = (ordered_set_t*)realloc(graph->in_edges_, graph->capacity_ * sizeof(ordered_set_t));
+    resize_array_list(&graph->free_nodes_, 0);
+
+    return remap;
 }
 
 void* get_edge_adj_graph(const adjacency_graph_t* graph, uint32_t source, uint32_t destination)
@@ -151,16 +321,22 @@ void set_edge_adj_graph(adjacency_graph_t* graph, uint32_t source, uint32_t dest
 void add_edge_adj_graph(adjacency_graph_t* graph, uint32_t source, uint32_t destination, const void* data)
 {
     insert_pair_ordered_map(get_edgelist_adj_graph(graph, source), &destination, data);
+    if (graph->in_edges_ != NULL && is_valid_node_adj(graph, destination))
+        insert_id_oset(in_edges_adj_graph(graph, destination), source);
 }
 
 void extract_edge_adj_graph(adjacency_graph_t* graph, uint32_t source, uint32_t destination, void* data)
 {
     extract_pair_ordered_map(get_edgelist_adj_graph(graph, source), &destination, data);
+    if (graph->in_edges_ != NULL && is_valid_node_adj(graph, destination))
+        remove_id_oset(in_edges_adj_graph(graph, destination), source);
 }
 
 void delete_edge_adj_graph(adjacency_graph_t* graph, uint32_t source, uint32_t destination)
 {
     remove_pair_ordered_map(get_edgelist_adj_graph(graph, source), &destination);
+    if (graph->in_edges_ != NULL && is_valid_node_adj(graph, destination))
+        remove_id_oset(in_edges_adj_graph(graph, destination), source);
 }
 
 void connect_allto_adj_graph(adjacency_graph_t* graph, uint32_t destination, const void* data)
@@ -183,6 +359,15 @@ void connect_allfrom_adj_graph(adjacency_graph_t* graph, uint32_t source, const
 
 void disconnect_allto_adj_graph(adjacency_graph_t* graph, uint32_t destination)
 {
+    if (graph->in_edges_ != NULL)
+    {
+        ordered_set_t* sources = in_edges_adj_graph(graph, destination);
+        for (size_t i = 0; i < sources->size_; ++i)
+            remove_pair_ordered_map(get_edgelist_adj_graph(graph, get_id_oset(sources, i)), &destination);
+        sources->size_ = 0;
+        return;
+    }
+
     for (uint32_t i = 0; i < graph->nodes_; ++i)
     {
         if (is_valid_node_adj(graph, i))
@@ -196,11 +381,12 @@ void disconnect_allto_adj_graph(adjacency_graph_t* graph, uint32_t destination)
 
 void disconnect_allfrom_adj_graph(adjacency_graph_t* graph, uint32_t source)
 {
+    /* Removing from the back keeps the index of the edges not visited yet */
     ordered_map_t* edge_list = get_edgelist_adj_graph(graph, source);
-    for (size_t i = 0; i < edge_list->size_; ++i)
+    for (size_t i = edge_list->size_; i-- > 0;)
     {
-        uint32_t dest = *(uint32_t*)get_key_ordered_map(edge_list, i);
-        remove_pair_ordered_map(edge_list, &dest);
+        uint32_t dest = *(const uint32_t*)get_key_ordered_map(edge_list, i);
+        delete_edge_adj_graph(graph, source, dest);
     }
 }
 
@@ -227,6 +413,18 @@ void connect_allfrom_if_adj_graph(adjacency_graph_t* graph, uint32_t source, con
 void disconnect_allto_if_adj_graph(adjacency_graph_t* graph, uint32_t destination, DISCONNECT_PREDICATE_FUNC predicate)
 {
     const void* dest_node = get_node_adj_graph(graph, destination);
+    if (graph->in_edges_ != NULL)
+    {
+        ordered_set_t* sources = in_edges_adj_graph(graph, destination);
+        for (size_t i = sources->size_; i-- > 0;)
+        {
+            uint32_t source = get_id_oset(sources, i);
+            if (predicate(get_node_adj_graph(graph, source), dest_node, get_edge_adj_graph(graph, source, destination)))
+                delete_edge_adj_graph(graph, source, destination);
+        }
+        return;
+    }
+
     for (uint32_t i = 0; i < graph->nodes_; ++i)
     {
         if (is_valid_node_adj(graph, i))
@@ -243,14 +441,88 @@ void disconnect_allfrom_if_adj_graph(adjacency_graph_t* graph, uint32_t source,
 {
     ordered_map_t* edge_list = get_edgelist_adj_graph(graph, source);
     const void* source_node = get_node_adj_graph(graph, source);
-    for (size_t i = 0; i < edge_list->size_; ++i)
+    for (size_t i = edge_list->size_; i-- > 0;)
     {
-        uint32_t dest = *(uint32_t*)get_key_ordered_map(edge_list, i);
+        uint32_t dest = *(const uint32_t*)get_key_ordered_map(edge_list, i);
         if (predicate(source_node, get_node_adj_graph(graph, dest), get_edge_adj_graph(graph, source, dest)))
-            remove_pair_ordered_map(edge_list, &dest);
+            delete_edge_adj_graph(graph, source, dest);
+    }
+}
+
+void set_in_edge_index_adj_graph(adjacency_graph_t* graph, int enabled)
+{
+    if (!enabled)
+    {
+        if (graph->in_edges_ != NULL)
+        {
+            for (uint32_t i = 0; i < graph->nodes_; ++i)
+                destroy_ordered_set(in_edges_adj_graph(graph, i));
+            free(graph->in_edges_);
+            graph->in_edges_ = NULL;
+        }
+        return;
+    }
+    if (graph->in_edges_ != NULL)
+        return;
+
+    /* Count the in-degrees first so every set is allocated once with its final size */
+    size_t* degrees = (size_t*)calloc(graph->nodes_ + 1, sizeof(size_t));
+    span_t run;
+    for (uint32_t i = 0; i < graph->nodes_; ++i)
+    {
+        if (!is_valid_node_adj(graph, i))
+            continue;
+
+        const ordered_map_t* edge_list = get_edgelist_adj_graph(graph, i);
+        for (size_t j = 0; j < edge_list->size_; j += run.count_)
+        {
+            run = keys_span_ordered_map(edge_list, j);
+            for (size_t k = 0; k < run.count_; ++k)
+                ++degrees[*(const uint32_t*)at_span(&run, k)];
+        }
+    }
+
+    graph->in_edges_ = (ordered_set_t*)malloc((graph->capacity_ ? graph->capacity_ : 1) * sizeof(ordered_set_t));
+    for (uint32_t i = 0; i < graph->nodes_; ++i)
+        *in_edges_adj_graph(graph, i) = create_id_oset(degrees[i]);
+    free(degrees);
+
+    /* The sources are visited in increasing order, so every insertion appends to its set */
+    for (uint32_t i = 0; i < graph->nodes_; ++i)
+    {
+        if (!is_valid_node_adj(graph, i))
+            continue;
+
+        const ordered_map_t* edge_list = get_edgelist_adj_graph(graph, i);
+        for (size_t j = 0; j < edge_list->size_; j += run.count_)
+        {
+            run = keys_span_ordered_map(edge_list, j);
+            for (size_t k = 0; k < run.count_; ++k)
+            {
+                uint32_t destination = *(const uint32_t*)at_span(&run, k);
+                if (is_valid_node_adj(graph, destination))
+                    insert_id_oset(in_edges_adj_graph(graph, destination), i);
+            }
+        }
     }
 }
 
+const ordered_set_t* get_in_edges_adj_graph(const adjacency_graph_t* graph, uint32_t id)
+{
+    return graph->in_edges_ != NULL ? in_edges_adj_graph(graph, id) : NULL;
+}
+
+size_t in_degree_adj_graph(const adjacency_graph_t* graph, uint32_t id)
+{
+    if (graph->in_edges_ != NULL)
+        return in_edges_adj_graph(graph, id)->size_;
+
+    size_t count = 0;
+    for (uint32_t i = 0; i < graph->nodes_; ++i)
+        count += is_valid_node_adj(graph, i) && contains_ordered_map(get_edgelist_adj_graph(graph, i), &id);
+    return count;
+}
+
 uint32_t search_node_adj_graph(const adjacency_graph_t* graph, SEARCH_PREDICATE_FUNC predicate)
 {
     for (size_t i = 0; i < graph->nodes_; ++i)
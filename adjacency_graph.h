@@ -12,7 +12,9 @@
  * 
  */
 
+#include "array_list.h"
 #include "ordered_map.h"
+#include "ordered_set.h"
 
 /**
  * @details Implementation
@@ -24,11 +26,17 @@
  * struct adjacency_node {
  *     ordered_map_t edge_list;
  *     char data[];
+ *     char inline_edges[];
  * };
  * 
  * where data are the bytes of the node data and edge_list is the list of edges where the connection is defined
  * as a directional arrow from the node owning the list to the node stored in the list of edges.
  * 
+ * inline_edges (8 byte aligned, as is every record) is the storage of the first edges of the node: up to three
+ * (id, edge data) pairs, fewer when the edge data is large. A new edge list uses it as its buffer (see
+ * create_ordered_map_in_buffer) and only moves to the heap when the node gets more edges, so the typical node with
+ * a few edges costs no allocation and has its edges next to its data.
+ * 
  * Each node has a unique id representing its position in the graph given by a uint32_t value.
  * 
  * The edge_list is an ordered map struct with the intend to access and search edge data in O(log N).
@@ -36,6 +44,16 @@
  * 
  * The maximum number of valid nodes is given UINT32_MAX - 1.
  * 
+ * A deleted node keeps its slot with an empty, zero capacity edge list (the node is not valid), so searches through
+ * a stale id find no edges. The ids of the deleted slots are kept in the free_nodes_ list: add_node_adj_graph takes
+ * the id of the last deleted node before growing the array, and compact_adj_graph moves the valid nodes to the
+ * front and removes the deleted slots.
+ * 
+ * The graph can also keep an index of the incoming edges (set_in_edge_index_adj_graph): an array parallel to the
+ * nodes with an ordered set of the source ids of the edges arriving to each node. The index is updated by every
+ * function adding or removing edges, so finding the predecessors of a node, removing all the edges to a node and
+ * deleting a node take time proportional to its degree instead of a search through the edge list of every node.
+ * 
  */
 
 /**
@@ -46,6 +64,9 @@
  * @var nodes_ number of nodes currently stored
  * @var node_element_size_ size in bytes of the node's type
  * @var edge_element_size_ size in bytes of the edge's type
+ * @var in_edges_ array of capacity_ ordered sets with the source ids of the edges arriving to each node,
+ *      NULL if the graph does not keep the index of incoming edges
+ * @var free_nodes_ list of the uint32_t ids of the deleted nodes, in order of deletion
  */
 typedef struct adjacency_graph_st
 {
@@ -54,6 +75,8 @@ typedef struct adjacency_graph_st
     size_t nodes_;
     size_t node_element_size_;
     size_t edge_element_size_;
+    ordered_set_t* in_edges_;
+    array_list_t free_nodes_;
 } adjacency_graph_t;
 
 /**
@@ -133,6 +156,7 @@ void set_node_adj_graph(adjacency_graph_t* graph, uint32_t id, const void* data)
 
 /**
  * @brief Creates a node in the adjacency graph with the given data and returns its id.
+ *        The id of a deleted node is reused if there is one.
  * 
  * @param graph graph in which the node is added/created
  * @param node_data const pointer of the data to be stored in the node
@@ -142,6 +166,7 @@ uint32_t add_node_adj_graph(adjacency_graph_t* graph, const void* node_data);
 
 /**
  * @brief Removes the node with the given id from the graph and returns its data.
+ *        All the edges from and to the node are removed.
  * 
  * @param graph graph from which the node will be removed
  * @param id id of the node to be removed
@@ -151,12 +176,24 @@ void extract_node_adj_graph(adjacency_graph_t* graph, uint32_t id, void* data);
 
 /**
  * @brief Removes the node with the given id from the adjacency graph.
+ *        All the edges from and to the node are removed, in time proportional to its degree if the graph keeps
+ *        the index of incoming edges, else with a search through the edge list of every node.
  * 
  * @param graph graph from which the node will be removed
  * @param id id of the node to be removed
  */
 void delete_node_adj_agraph(adjacency_graph_t* graph, uint32_t id);
 
+/**
+ * @brief Moves the valid nodes to the front of the graph keeping their order, removes the deleted slots and
+ *        releases the unused capacity. The keys of the edge lists (and the sets of incoming edges) are rewritten
+ *        in one pass, as the new ids keep the order of the old ones.
+ * 
+ * @param graph graph to be compacted
+ * @return array_list_t list of uint32_t with the new id of every old id, INVALID_ADJGRAPH_NODE for the deleted nodes
+ */
+array_list_t compact_adj_graph(adjacency_graph_t* graph);
+
 /**
  * @brief Get the list of edges with node with the given id as source.
  * 
@@ -166,6 +203,16 @@ void delete_node_adj_agraph(adjacency_graph_t* graph, uint32_t id);
  */
 ordered_map_t* get_edgelist_adj_graph(const adjacency_graph_t* graph, uint32_t id);
 
+/**
+ * @brief Creates the empty list of edges of a node slot that has none (a new or deleted slot), stored in the
+ *        node record if the capacity fits in its inline edges. Does not release the previous edge list.
+ * 
+ * @param graph graph owning the slot
+ * @param id id of the node
+ * @param capacity number of edges the list should hold, 0 for the default of a new node
+ */
+void init_edgelist_adj_graph(adjacency_graph_t* graph, uint32_t id, size_t capacity);
+
 /**
  * @brief Calculates the capacity for the edgelist of a newly created node.
  * 
@@ -245,7 +292,8 @@ void connect_allto_adj_graph(adjacency_graph_t* graph, uint32_t destination, con
 void connect_allfrom_adj_graph(adjacency_graph_t* graph, uint32_t source, const void* data);
 
 /**
- * @brief Removes all edges in the adjacency graph that have the given node as destination
+ * @brief Removes all edges in the adjacency graph that have the given node as destination.
+ *        Only visits the sources of the edges if the graph keeps the index of incoming edges.
  * 
  * @param graph graph from which the edges will be removed from
  * @param destination id of the destination node
@@ -260,6 +308,35 @@ void disconnect_allto_adj_graph(adjacency_graph_t* graph, uint32_t destination);
  */
 void disconnect_allfrom_adj_graph(adjacency_graph_t* graph, uint32_t source);
 
+/**
+ * @brief Starts or stops keeping the index of incoming edges of the graph.
+ *        Starting it builds the index from the current edges, each set allocated with its exact size.
+ * 
+ * @param graph graph to be modified
+ * @param enabled 1 to keep the index, 0 to release it
+ */
+void set_in_edge_index_adj_graph(adjacency_graph_t* graph, int enabled);
+
+/**
+ * @brief Gets the ordered set of the ids of the nodes with an edge to the given node (its predecessors).
+ *        The set is owned by the graph and changes when edges are added or removed.
+ * 
+ * @param graph graph from which the edges will be retrieved
+ * @param id id of the destination node of the edges
+ * @return const ordered_set_t* set of uint32_t source ids, NULL if the graph does not keep the index of incoming edges
+ */
+const ordered_set_t* get_in_edges_adj_graph(const adjacency_graph_t* graph, uint32_t id);
+
+/**
+ * @brief Returns the number of edges arriving to the given node.
+ *        Searches the edge list of every node if the graph does not keep the index of incoming edges.
+ * 
+ * @param graph graph where the edges are counted
+ * @param id id of the destination node of the edges
+ * @return size_t number of incoming edges
+ */
+size_t in_degree_adj_graph(const adjacency_graph_t* graph, uint32_t id);
+
 /**
  * @brief Function signature of the function as predicate in the connect_if function
  *        It takes in the data of the source node and destination node
@@ -1,5 +1,15 @@
 #include "algorithm.h"
 
+#include <stdlib.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ALGORITHM_X86
+#endif
+
+/* Ranges up to this size are finished with a linear scan instead of more halving steps */
+static const size_t LINEAR_SEARCH_THRESHOLD = 16;
+
 const void* linear_search(const void* element, const void* array, size_t element_count, size_t element_size, EQUALS_FUNC equal_func)
 {
     for (size_t i = 0; i < element_count; ++i)
@@ -54,7 +64,367 @@ int sorted_array_contains(const void* element, const void* array, size_t element
 {
     if (element_count == 0) return 0;
     const void* position = binary_search(element, array, element_count, element_size, order_func);
-    if (!(order_func(position, element) || order_func(element, position)))
+    if (position != array + element_count * element_size && !(order_func(position, element) || order_func(element, position)))
         return 1;
     return 0;
-}
\ No newline at end of file
+}
+
+/*
+ * Search kernels of the built-in key kinds.
+ * before_X(value, key, upper) is value < key for a lower bound and value <= key for an upper bound,
+ * so the bound is the number of elements that come before the key.
+ */
+#define DEFINE_SEARCH_KERNEL(type, name)                                                                        \
+static inline type load_##name(const void* pointer)                                                             \
+{                                                                                                               \
+    type value;                                                                                                 \
+    memcpy(&value, pointer, sizeof(type));                                                                      \
+    return value;                                                                                               \
+}                                                                                                               \
+                                                                                                                \
+static inline int before_##name(type value, type key, int upper)                                                \
+{                                                                                                               \
+    return upper ? !(key < value) : value < key;                                                                \
+}                                                                                                               \
+                                                                                                                \
+static size_t count_before_##name(const void* array, size_t count, size_t stride, type key, int upper)          \
+{                                                                                                               \
+    size_t before = 0;                                                                                          \
+    for (size_t i = 0; i < count; ++i)                                                                          \
+        before += before_##name(load_##name(array + i * stride), key, upper);                                   \
+    return before;                                                                                              \
+}                                                                                                               \
+                                                                                                                \
+static size_t bound_##name(const void* element, const void* array, size_t count, size_t stride, int upper)     \
+{                                                                                                               \
+    type key = load_##name(element);                                                                            \
+    const void* base = array;                                                                                   \
+    size_t n = count;                                                                                           \
+    while (n > LINEAR_SEARCH_THRESHOLD)                                                                         \
+    {                                                                                                           \
+        size_t half = n / 2;                                                                                    \
+        base = before_##name(load_##name(base + half * stride), key, upper) ? base + half * stride : base;      \
+        n -= half;                                                                                              \
+    }                                                                                                           \
+    return ((uintptr_t)base - (uintptr_t)array) / stride + count_before_simd_##name(base, n, stride, key, upper); \
+}
+
+#ifdef ALGORITHM_X86
+/* The AVX2 kernels are compiled for AVX2 on any build and only called when the CPU supports it */
+static int has_avx2(void)
+{
+    static int supported = -1;
+    if (supported < 0)
+    {
+        __builtin_cpu_init();
+        supported = __builtin_cpu_supports("avx2");
+    }
+    return supported;
+}
+
+__attribute__((target("avx2")))
+static size_t count_before_avx2_epi32(const void* array, size_t count, int32_t key, int32_t flip, int upper)
+{
+    __m256i keys = _mm256_set1_epi32(key ^ flip);
+    __m256i flips = _mm256_set1_epi32(flip);
+    size_t before = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i values = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(array + i * sizeof(int32_t))), flips);
+        __m256i mask = upper ? _mm256_cmpgt_epi32(values, keys) : _mm256_cmpgt_epi32(keys, values);
+        int bits = __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+        before += upper ? 8 - bits : bits;
+    }
+    for (; i < count; ++i)
+    {
+        int32_t value;
+        memcpy(&value, array + i * sizeof(int32_t), sizeof(int32_t));
+        value ^= flip;
+        before += upper ? !((key ^ flip) < value) : value < (key ^ flip);
+    }
+    return before;
+}
+
+__attribute__((target("avx2")))
+static size_t count_before_avx2_epi64(const void* array, size_t count, int64_t key, int64_t flip, int upper)
+{
+    __m256i keys = _mm256_set1_epi64x(key ^ flip);
+    __m256i flips = _mm256_set1_epi64x(flip);
+    size_t before = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256i values = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(array + i * sizeof(int64_t))), flips);
+        __m256i mask = upper ? _mm256_cmpgt_epi64(values, keys) : _mm256_cmpgt_epi64(keys, values);
+        int bits = __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(mask)));
+        before += upper ? 4 - bits : bits;
+    }
+    for (; i < count; ++i)
+    {
+        int64_t value;
+        memcpy(&value, array + i * sizeof(int64_t), sizeof(int64_t));
+        value ^= flip;
+        before += upper ? !((key ^ flip) < value) : value < (key ^ flip);
+    }
+    return before;
+}
+
+__attribute__((target("avx2")))
+static size_t count_before_avx2_pd(const void* array, size_t count, double key, int upper)
+{
+    __m256d keys = _mm256_set1_pd(key);
+    size_t before = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256d values = _mm256_loadu_pd((const double*)(array + i * sizeof(double)));
+        __m256d mask = upper ? _mm256_cmp_pd(values, keys, _CMP_LE_OQ) : _mm256_cmp_pd(values, keys, _CMP_LT_OQ);
+        before += __builtin_popcount(_mm256_movemask_pd(mask));
+    }
+    for (; i < count; ++i)
+    {
+        double value;
+        memcpy(&value, array + i * sizeof(double), sizeof(double));
+        before += upper ? !(key < value) : value < key;
+    }
+    return before;
+}
+
+#define count_before_simd_u32(array, count, stride, key, upper) ((stride) == sizeof(uint32_t) && has_avx2() ? \
+    count_before_avx2_epi32(array, count, (int32_t)(key), INT32_MIN, upper) : count_before_u32(array, count, stride, key, upper))
+#define count_before_simd_i32(array, count, stride, key, upper) ((stride) == sizeof(int32_t) && has_avx2() ? \
+    count_before_avx2_epi32(array, count, key, 0, upper) : count_before_i32(array, count, stride, key, upper))
+#define count_before_simd_u64(array, count, stride, key, upper) ((stride) == sizeof(uint64_t) && has_avx2() ? \
+    count_before_avx2_epi64(array, count, (int64_t)(key), INT64_MIN, upper) : count_before_u64(array, count, stride, key, upper))
+#define count_before_simd_i64(array, count, stride, key, upper) ((stride) == sizeof(int64_t) && has_avx2() ? \
+    count_before_avx2_epi64(array, count, key, 0, upper) : count_before_i64(array, count, stride, key, upper))
+#define count_before_simd_f64(array, count, stride, key, upper) ((stride) == sizeof(double) && has_avx2() ? \
+    count_before_avx2_pd(array, count, key, upper) : count_before_f64(array, count, stride, key, upper))
+#else
+#define count_before_simd_u32 count_before_u32
+#define count_before_simd_i32 count_before_i32
+#define count_before_simd_u64 count_before_u64
+#define count_before_simd_i64 count_before_i64
+#define count_before_simd_f64 count_before_f64
+#endif
+
+DEFINE_SEARCH_KERNEL(uint32_t, u32)
+DEFINE_SEARCH_KERNEL(int32_t, i32)
+DEFINE_SEARCH_KERNEL(uint64_t, u64)
+DEFINE_SEARCH_KERNEL(int64_t, i64)
+DEFINE_SEARCH_KERNEL(double, f64)
+
+static size_t bound_custom(const void* element, const void* array, size_t count, size_t stride, int upper, LESS_THAN_FUNC order_func)
+{
+    const void* base = array;
+    size_t n = count;
+    while (n > 1)
+    {
+        size_t half = n / 2;
+        const void* middle = base + half * stride;
+        base = (upper ? !order_func(element, middle) : order_func(middle, element)) ? middle : base;
+        n -= half;
+    }
+    size_t index = ((uintptr_t)base - (uintptr_t)array) / stride;
+    if (n == 1 && (upper ? !order_func(element, base) : order_func(base, element)))
+        ++index;
+    return index;
+}
+
+static size_t bound_kind(const void* element, const void* array, size_t count, size_t stride, key_kind_t kind, LESS_THAN_FUNC order_func, int upper)
+{
+    /* An empty range may come from a destroyed container, whose element size is 0 */
+    if (count == 0)
+        return 0;
+
+    switch (kind)
+    {
+    case KEY_KIND_UINT32: return bound_u32(element, array, count, stride, upper);
+    case KEY_KIND_INT32: return bound_i32(element, array, count, stride, upper);
+    case KEY_KIND_UINT64: return bound_u64(element, array, count, stride, upper);
+    case KEY_KIND_INT64: return bound_i64(element, array, count, stride, upper);
+    case KEY_KIND_DOUBLE: return bound_f64(element, array, count, stride, upper);
+    default: return bound_custom(element, array, count, stride, upper, order_func);
+    }
+}
+
+size_t lower_bound_kind(const void* element, const void* array, size_t element_count, size_t element_size, key_kind_t kind, LESS_THAN_FUNC order_func)
+{
+    return bound_kind(element, array, element_count, element_size, kind, order_func, 0);
+}
+
+size_t upper_bound_kind(const void* element, const void* array, size_t element_count, size_t element_size, key_kind_t kind, LESS_THAN_FUNC order_func)
+{
+    return bound_kind(element, array, element_count, element_size, kind, order_func, 1);
+}
+
+const void* binary_search_kind(const void* element, const void* array, size_t element_count, size_t element_size, key_kind_t kind, LESS_THAN_FUNC order_func)
+{
+    return array + lower_bound_kind(element, array, element_count, element_size, kind, order_func) * element_size;
+}
+
+int sorted_array_contains_kind(const void* element, const void* array, size_t element_count, size_t element_size, key_kind_t kind, LESS_THAN_FUNC order_func)
+{
+    size_t index = lower_bound_kind(element, array, element_count, element_size, kind, order_func);
+    return index < element_count && !less_than_kind(element, array + index * element_size, kind, order_func);
+}
+
+static void eytzinger_fill(void* out, const void* array, size_t* next, size_t slot, size_t element_count, size_t element_size)
+{
+    if (slot > element_count)
+        return;
+
+    eytzinger_fill(out, array, next, 2 * slot, element_count, element_size);
+    memcpy(out + (slot - 1) * element_size, array + (*next)++ * element_size, element_size);
+    eytzinger_fill(out, array, next, 2 * slot + 1, element_count, element_size);
+}
+
+void eytzinger_layout(void* out, const void* array, size_t element_count, size_t element_size)
+{
+    size_t next = 0;
+    eytzinger_fill(out, array, &next, 1, element_count, element_size);
+}
+
+size_t eytzinger_lower_bound(const void* element, const void* layout, size_t element_count, size_t element_size, key_kind_t kind, LESS_THAN_FUNC order_func)
+{
+    /* Slots are 1 based while descending, the children of slot k are 2k and 2k + 1 */
+    size_t slot = 1;
+    while (slot <= element_count)
+    {
+        __builtin_prefetch(layout + (16 * slot - 1) * element_size);
+        slot = 2 * slot + less_than_kind(layout + (slot - 1) * element_size, element, kind, order_func);
+    }
+
+    /* Undo the right turns taken after the last left turn, which was the lower bound */
+    slot >>= __builtin_ffsll(~(long long)slot);
+    return slot != 0 ? slot - 1 : SIZE_MAX;
+}
+/* Unsigned integer with the same order as the key, so the keys of every built-in kind are radix sorted as unsigned */
+static inline uint64_t radix_key(const void* element, key_kind_t kind)
+{
+    switch (kind)
+    {
+    case KEY_KIND_UINT32: { uint32_t key; memcpy(&key, element, sizeof(key)); return key; }
+    case KEY_KIND_INT32:  { uint32_t key; memcpy(&key, element, sizeof(key)); return key ^ 0x80000000u; }
+    case KEY_KIND_UINT64: { uint64_t key; memcpy(&key, element, sizeof(key)); return key; }
+    case KEY_KIND_INT64:  { uint64_t key; memcpy(&key, element, sizeof(key)); return key ^ ((uint64_t)1 << 63); }
+    default:              { uint64_t key; memcpy(&key, element, sizeof(key)); return key >> 63 ? ~key : key | ((uint64_t)1 << 63); }
+    }
+}
+
+typedef struct radix_entry_st
+{
+    uint64_t key;
+    size_t index;
+} radix_entry;
+
+/* Digits of 11 bits sort 32 bit keys in 3 passes and 64 bit keys in 6, with histograms that fit in L1 */
+#define RADIX_BITS 11
+#define RADIX_DIGITS (1 << RADIX_BITS)
+
+static void radix_order(size_t* order, const void* array, size_t count, size_t size, key_kind_t kind)
+{
+    size_t key_bits = kind == KEY_KIND_UINT32 || kind == KEY_KIND_INT32 ? 32 : 64;
+    size_t passes = (key_bits + RADIX_BITS - 1) / RADIX_BITS;
+    radix_entry* entries = (radix_entry*)malloc(count * sizeof(radix_entry));
+    radix_entry* buffer = (radix_entry*)malloc(count * sizeof(radix_entry));
+    size_t (*histogram)[RADIX_DIGITS] = calloc(passes, sizeof(*histogram));
+
+    /* One pass over the array builds the histograms of every digit */
+    for (size_t i = 0; i < count; ++i)
+    {
+        entries[i].key = radix_key(array + i * size, kind);
+        entries[i].index = i;
+        for (size_t pass = 0; pass < passes; ++pass)
+            ++histogram[pass][(entries[i].key >> (RADIX_BITS * pass)) & (RADIX_DIGITS - 1)];
+    }
+
+    for (size_t pass = 0; pass < passes; ++pass)
+    {
+        size_t shift = RADIX_BITS * pass;
+        /* A digit shared by every key does not change the order */
+        if (histogram[pass][(entries[0].key >> shift) & (RADIX_DIGITS - 1)] == count)
+            continue;
+
+        size_t offset = 0;
+        for (size_t digit = 0; digit < RADIX_DIGITS; ++digit)
+        {
+            size_t digit_count = histogram[pass][digit];
+            histogram[pass][digit] = offset;
+            offset += digit_count;
+        }
+        for (size_t i = 0; i < count; ++i)
+            buffer[histogram[pass][(entries[i].key >> shift) & (RADIX_DIGITS - 1)]++] = entries[i];
+
+        radix_entry* temp = entries;
+        entries = buffer;
+        buffer = temp;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+        order[i] = entries[i].index;
+
+    free(entries);
+    free(buffer);
+    free(histogram);
+}
+
+static void merge_order(size_t* order, const void* array, size_t count, size_t size, LESS_THAN_FUNC order_func)
+{
+    const size_t run = 16;
+    size_t* source = order;
+    size_t* destination = (size_t*)malloc(count * sizeof(size_t));
+    size_t* buffer = destination;
+
+    /* Insertion sort of short runs, then bottom up merges of pairs of runs */
+    for (size_t i = 0; i < count; ++i)
+    {
+        size_t j = i;
+        for (; j % run != 0 && order_func(array + i * size, array + order[j - 1] * size); --j)
+            order[j] = order[j - 1];
+        order[j] = i;
+    }
+
+    for (size_t width = run; width < count; width *= 2)
+    {
+        for (size_t low = 0; low < count; low += 2 * width)
+        {
+            size_t middle = low + width < count ? low + width : count;
+            size_t high = low + 2 * width < count ? low + 2 * width : count;
+            size_t left = low, right = middle, out = low;
+
+            while (left < middle && right < high)
+            {
+                /* Ties take the left element, which keeps the sort stable */
+                if (order_func(array + source[right] * size, array + source[left] * size))
+                    destination[out++] = source[right++];
+                else
+                    destination[out++] = source[left++];
+            }
+            while (left < middle)
+                destination[out++] = source[left++];
+            while (right < high)
+                destination[out++] = source[right++];
+        }
+
+        size_t* temp = source;
+        source = destination;
+        destination = temp;
+    }
+
+    if (source != order)
+        memcpy(order, source, count * sizeof(size_t));
+    free(buffer);
+}
+
+void stable_order_kind(size_t* order, const void* array, size_t element_count, size_t element_size, key_kind_t kind, LESS_THAN_FUNC order_func)
+{
+    if (element_count == 0)
+        return;
+
+    if (kind == KEY_KIND_CUSTOM)
+        merge_order(order, array, element_count, element_size, order_func);
+    else
+        radix_order(order, array, element_count, element_size, kind);
+}
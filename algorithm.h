@@ -13,6 +13,8 @@
  */
 
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 
 /**
  * @brief Function signature of the comparison of two pieces of data.
@@ -26,6 +28,69 @@ typedef int(*LESS_THAN_FUNC)(const void* left, const void* right);
  */
 typedef int(*EQUALS_FUNC)(const void* left, const void* right);
 
+/**
+ * @brief Value comparison used by the typed container specializations (DEFINE_TYPED_ORDERED_SET, ...)
+ *        for types with a built-in < operator. Other types pass their own macro or inline function
+ *        taking the two values.
+ */
+#define DEFAULT_LESS_THAN(left, right) ((left) < (right))
+
+/**
+ * @brief Built-in key types that the search kernels can compare without calling a comparison function.
+ *        The key is always read from the start of each element, so arrays of records ordered by a leading
+ *        key of one of these types can be searched directly.
+ * 
+ * KEY_KIND_CUSTOM compares through the given LESS_THAN_FUNC
+ * KEY_KIND_UINT32, KEY_KIND_INT32, KEY_KIND_UINT64, KEY_KIND_INT64 and KEY_KIND_DOUBLE compare the key in
+ * ascending order of the given type
+ */
+typedef enum data_key_kind_en
+{
+    KEY_KIND_CUSTOM,
+    KEY_KIND_UINT32,
+    KEY_KIND_INT32,
+    KEY_KIND_UINT64,
+    KEY_KIND_INT64,
+    KEY_KIND_DOUBLE
+} key_kind_t;
+
+/**
+ * @brief Compares the keys at the start of the two given elements as *left < *right.
+ *        Built-in key kinds are compared inline, KEY_KIND_CUSTOM calls the order function.
+ * 
+ * @param left pointer to the left element
+ * @param right pointer to the right element
+ * @param kind kind of the keys
+ * @param order_func pointer to the comparison function (only used by KEY_KIND_CUSTOM)
+ * @return 1 if left is less than right, else 0
+ */
+static inline int less_than_kind(const void* left, const void* right, key_kind_t kind, LESS_THAN_FUNC order_func)
+{
+    switch (kind)
+    {
+    case KEY_KIND_UINT32: { uint32_t l, r; memcpy(&l, left, sizeof(l)); memcpy(&r, right, sizeof(r)); return l < r; }
+    case KEY_KIND_INT32:  { int32_t l, r;  memcpy(&l, left, sizeof(l)); memcpy(&r, right, sizeof(r)); return l < r; }
+    case KEY_KIND_UINT64: { uint64_t l, r; memcpy(&l, left, sizeof(l)); memcpy(&r, right, sizeof(r)); return l < r; }
+    case KEY_KIND_INT64:  { int64_t l, r;  memcpy(&l, left, sizeof(l)); memcpy(&r, right, sizeof(r)); return l < r; }
+    case KEY_KIND_DOUBLE: { double l, r;   memcpy(&l, left, sizeof(l)); memcpy(&r, right, sizeof(r)); return l < r; }
+    default: return order_func(left, right);
+    }
+}
+
+/**
+ * @brief Compares the keys at the start of the two given elements for equivalence (neither is less than the other)
+ * 
+ * @param left pointer to the left element
+ * @param right pointer to the right element
+ * @param kind kind of the keys
+ * @param order_func pointer to the comparison function (only used by KEY_KIND_CUSTOM)
+ * @return 1 if the keys are equivalent, else 0
+ */
+static inline int equal_kind(const void* left, const void* right, key_kind_t kind, LESS_THAN_FUNC order_func)
+{
+    return !(less_than_kind(left, right, kind, order_func) || less_than_kind(right, left, kind, order_func));
+}
+
 /**
  * @brief Searches the address of an element in the given array
  *        If the element is not in the array, the function returns NULL
@@ -78,4 +143,105 @@ int array_contains(const void* element, const void* array, size_t element_count,
  */
 int sorted_array_contains(const void* element, const void* array, size_t element_count, size_t element_size, LESS_THAN_FUNC equal_func);
 
+/**
+ * @brief Returns the index of the first element of the sorted array that is not less than the given element.
+ *        Built-in key kinds use a branchless search that finishes with a linear scan of the last few elements
+ *        (vectorized with AVX2 when the CPU supports it and the elements are only the keys).
+ *        If every element is less than the given one, the function returns element_count
+ * 
+ * @param element pointer to the element to be searched
+ * @param array pointer to the array to be searched
+ * @param element_count number of elements in the array
+ * @param element_size size in bytes of each of the element's data type (the stride between keys)
+ * @param kind kind of the keys
+ * @param order_func pointer to the comparison function (only used by KEY_KIND_CUSTOM)
+ * @return size_t index of the lower bound
+ */
+size_t lower_bound_kind(const void* element, const void* array, size_t element_count, size_t element_size, key_kind_t kind, LESS_THAN_FUNC order_func);
+
+/**
+ * @brief Returns the index of the first element of the sorted array that is greater than the given element.
+ *        If no element is greater than the given one, the function returns element_count
+ * 
+ * @param element pointer to the element to be searched
+ * @param array pointer to the array to be searched
+ * @param element_count number of elements in the array
+ * @param element_size size in bytes of each of the element's data type (the stride between keys)
+ * @param kind kind of the keys
+ * @param order_func pointer to the comparison function (only used by KEY_KIND_CUSTOM)
+ * @return size_t index of the upper bound
+ */
+size_t upper_bound_kind(const void* element, const void* array, size_t element_count, size_t element_size, key_kind_t kind, LESS_THAN_FUNC order_func);
+
+/**
+ * @brief Searches the address of an element in the given sorted array with the kernel of the key kind
+ *        If the element is not in the array, the function returns the position were it would be if it was
+ * 
+ * @param element pointer to the element to be search
+ * @param array pointer to the array to be searched
+ * @param element_count number of elements in the array
+ * @param element_size size in bytes of each of the element's data type
+ * @param kind kind of the keys
+ * @param order_func pointer to the comparison function (only used by KEY_KIND_CUSTOM)
+ * @return pointer to the address of the (possible) position of the element
+ */
+const void* binary_search_kind(const void* element, const void* array, size_t element_count, size_t element_size, key_kind_t kind, LESS_THAN_FUNC order_func);
+
+/**
+ * @brief Searches the existance of an element in the sorted array with the kernel of the key kind
+ *        If the element is in the array return 1, else returns 0
+ * 
+ * @param element pointer to the element to be search
+ * @param array pointer to the array to be searched
+ * @param element_count number of elements in the array
+ * @param element_size size in bytes of each of the element's data type
+ * @param kind kind of the keys
+ * @param order_func pointer to the comparison function (only used by KEY_KIND_CUSTOM)
+ * @return 1 if contains, 0 if does not contain
+ */
+int sorted_array_contains_kind(const void* element, const void* array, size_t element_count, size_t element_size, key_kind_t kind, LESS_THAN_FUNC order_func);
+
+/**
+ * @brief Copies a sorted array into the Eytzinger (breadth first binary tree) layout.
+ *        Slot 0 of the output stores the root, and the children of the slot i are the slots 2i + 1 and 2i + 2,
+ *        so the first levels of every search share the same few cache lines and the next probes can be prefetched.
+ *        Useful for large arrays that are searched many times and rarely modified.
+ * 
+ * @param out pointer to the output array (element_count elements, must not overlap the input)
+ * @param array pointer to the sorted array
+ * @param element_count number of elements in the array
+ * @param element_size size in bytes of each of the element's data type
+ */
+void eytzinger_layout(void* out, const void* array, size_t element_count, size_t element_size);
+
+/**
+ * @brief Returns the slot in an Eytzinger layout of the first element that is not less than the given element.
+ *        If every element is less than the given one, the function returns SIZE_MAX
+ * 
+ * @param element pointer to the element to be searched
+ * @param layout pointer to the array in Eytzinger layout
+ * @param element_count number of elements in the array
+ * @param element_size size in bytes of each of the element's data type
+ * @param kind kind of the keys
+ * @param order_func pointer to the comparison function (only used by KEY_KIND_CUSTOM)
+ * @return size_t slot of the lower bound
+ */
+size_t eytzinger_lower_bound(const void* element, const void* layout, size_t element_count, size_t element_size, key_kind_t kind, LESS_THAN_FUNC order_func);
+
+/**
+ * @brief Computes the stable sorted order of the elements of an array without moving them:
+ *        array[order[0]], array[order[1]], ... are in ascending order of their keys, and elements with
+ *        equivalent keys keep their relative order.
+ *        Built-in key kinds are sorted with an LSD radix sort of their keys (skipping the bytes shared by
+ *        every key), KEY_KIND_CUSTOM with a merge sort calling the order function.
+ * 
+ * @param order pointer to the output array of element_count indices
+ * @param array pointer to the array to be sorted
+ * @param element_count number of elements in the array
+ * @param element_size size in bytes of each of the element's data type
+ * @param kind kind of the keys
+ * @param order_func pointer to the comparison function (only used by KEY_KIND_CUSTOM)
+ */
+void stable_order_kind(size_t* order, const void* array, size_t element_count, size_t element_size, key_kind_t kind, LESS_THAN_FUNC order_func);
+
 #endif /* DATA_ALGORITHM_H */
\ No newline at end of file
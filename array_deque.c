@@ -0,0 +1,179 @@
+#include "array_deque.h"
+
+#include <string.h>
+
+static const size_t BASE_CAPACITY = 8;
+
+static size_t physical_index_array_deque(const array_deque_t* deque, size_t index)
+{
+    size_t position = deque->head_ + index;
+    return position < deque->capacity_ ? position : position - deque->capacity_;
+}
+
+array_deque_t create_array_deque(size_t capacity, size_t element_size)
+{
+    array_deque_t out;
+
+    out.capacity_ = capacity;
+    out.size_ = 0;
+    out.element_size_ = element_size;
+    out.head_ = 0;
+    out.data_ = malloc(element_size * capacity);
+
+    return out;
+}
+
+void destroy_array_deque(array_deque_t* deque)
+{
+    deque->size_ = 0;
+    deque->capacity_ = 0;
+    deque->element_size_ = 0;
+    deque->head_ = 0;
+    free(deque->data_);
+    deque->data_ = NULL;
+}
+
+void reuse_array_deque(array_deque_t* deque, size_t capacity, size_t element_size)
+{
+    if (capacity * element_size > deque->element_size_ * deque->capacity_)
+    {
+        deque->data_ = realloc(deque->data_, capacity * element_size);
+        deque->capacity_ = capacity;
+    }
+    else
+        deque->capacity_ = (deque->capacity_ * deque->element_size_) / element_size;
+    deque->element_size_ = element_size;
+    deque->size_ = 0;
+    deque->head_ = 0;
+}
+
+void reserve_array_deque(array_deque_t* deque, size_t new_capacity)
+{
+    if (deque->capacity_ < new_capacity)
+    {
+        size_t old_capacity = deque->capacity_;
+        deque->data_ = realloc(deque->data_, new_capacity * deque->element_size_);
+        deque->capacity_ = new_capacity;
+
+        if (deque->head_ + deque->size_ > old_capacity)
+        {
+            /* The ring wrapped around the old buffer, unroll the front segment to the end of the new buffer */
+            size_t front_count = old_capacity - deque->head_;
+            size_t new_head = new_capacity - front_count;
+            memmove(deque->data_ + new_head * deque->element_size_, deque->data_ + deque->head_ * deque->element_size_,
+                front_count * deque->element_size_);
+            deque->head_ = new_head;
+        }
+    }
+}
+
+size_t next_array_deque_capacity(size_t current_capacity)
+{
+    return current_capacity ? current_capacity * 2 : BASE_CAPACITY;
+}
+
+void clear_array_deque(array_deque_t* deque)
+{
+    deque->size_ = 0;
+    deque->head_ = 0;
+}
+
+void push_front_array_deque(array_deque_t* deque, const void* element)
+{
+    if (deque->size_ == deque->capacity_)
+        reserve_array_deque(deque, next_array_deque_capacity(deque->capacity_));
+    deque->head_ = deque->head_ ? deque->head_ - 1 : deque->capacity_ - 1;
+    ++deque->size_;
+    memcpy(deque->data_ + deque->head_ * deque->element_size_, element, deque->element_size_);
+}
+
+void push_back_array_deque(array_deque_t* deque, const void* element)
+{
+    if (deque->size_ == deque->capacity_)
+        reserve_array_deque(deque, next_array_deque_capacity(deque->capacity_));
+    set_element_array_deque(deque, deque->size_++, element);
+}
+
+void pop_front_array_deque(array_deque_t* deque, void* element)
+{
+    if (deque->size_ != 0)
+    {
+        memcpy(element, deque->data_ + deque->head_ * deque->element_size_, deque->element_size_);
+        deque->head_ = physical_index_array_deque(deque, 1);
+        if (--deque->size_ == 0)
+            deque->head_ = 0;
+    }
+}
+
+void pop_back_array_deque(array_deque_t* deque, void* element)
+{
+    if (deque->size_ != 0)
+    {
+        memcpy(element, get_element_array_deque(deque, deque->size_ - 1), deque->element_size_);
+        if (--deque->size_ == 0)
+            deque->head_ = 0;
+    }
+}
+
+void* get_element_array_deque(const array_deque_t* deque, size_t index)
+{
+    return index < deque->size_ ? deque->data_ + (physical_index_array_deque(deque, index) * deque->element_size_) : NULL;
+}
+
+void set_element_array_deque(array_deque_t* deque, size_t index, const void* value)
+{
+    memcpy(get_element_array_deque(deque, index), value, deque->element_size_);
+}
+
+void* front_array_deque(const array_deque_t* deque)
+{
+    return get_element_array_deque(deque, 0);
+}
+
+void* back_array_deque(const array_deque_t* deque)
+{
+    return get_element_array_deque(deque, deque->size_ - 1);
+}
+
+int contains_array_deque(const array_deque_t* deque, const void* element, EQUALS_FUNC equal_func)
+{
+    size_t first_count = deque->capacity_ - deque->head_;
+    if (first_count >= deque->size_)
+        return array_contains(element, deque->data_ + deque->head_ * deque->element_size_, deque->size_, deque->element_size_, equal_func);
+    return array_contains(element, deque->data_ + deque->head_ * deque->element_size_, first_count, deque->element_size_, equal_func)
+        || array_contains(element, deque->data_, deque->size_ - first_count, deque->element_size_, equal_func);
+}
+
+array_deque_t create_int_adeque(size_t capacity)
+{
+    return create_array_deque(capacity, sizeof(int));
+}
+
+void push_front_int_adeque(array_deque_t* deque, int value)
+{
+    push_front_array_deque(deque, &value);
+}
+
+void push_back_int_adeque(array_deque_t* deque, int value)
+{
+    push_back_array_deque(deque, &value);
+}
+
+int pop_front_int_adeque(array_deque_t* deque)
+{
+    int temp;
+    pop_front_array_deque(deque, &temp);
+    return temp;
+}
+
+int pop_back_int_adeque(array_deque_t* deque)
+{
+    int temp;
+    pop_back_array_deque(deque, &temp);
+    return temp;
+}
+
+int get_int_adeque(const array_deque_t* deque, size_t index)
+{
+    return *(int*)get_element_array_deque(deque, index);
+}
@@ -0,0 +1,223 @@
+#ifndef DATA_ARRAY_DEQUE_H
+#define DATA_ARRAY_DEQUE_H
+
+/**
+ * @file array_deque.h
+ * @author Edwin Solis (esolis6@gatech.edu)
+ * @brief A type adjustable implementation of a ring buffer based double ended queue
+ * @version 0.1
+ * @date 2021-10-20
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <stdlib.h>
+#include "algorithm.h"
+
+/**
+ * @details Implementation
+ * 
+ * The deque is an array list variant whose first element does not need to live at the start of the buffer.
+ * The elements are stored in a circular buffer starting at head_ and wrapping around the end of the buffer,
+ * so pushing and popping at both ends are O(1) operations (amortized for pushes).
+ * 
+ * Indexing is relative to the front of the deque, so the index based accessors behave the same as the ones
+ * of the array list. When the buffer grows, the wrapped part of the ring is unrolled so the elements are
+ * contiguous again in the new buffer.
+ * 
+ */
+
+/**
+ * @brief Struct representing an array deque
+ * 
+ * @var capacity_ stores the maximum number of elements that the deque can store
+ * @var size_ stores the current number of elements in the deque
+ * @var element_size_ stores the size in bytes of the datatype being stored
+ * @var head_ stores the position in the buffer of the first element
+ * @var data_ stores the pointer to the buffer of data
+ */
+typedef struct data_array_deque_st
+{
+    size_t capacity_;
+    size_t size_;
+    size_t element_size_;
+    size_t head_;
+    void* data_;
+} array_deque_t;
+
+/**
+ * @brief Create an array deque object with the given parameters
+ * 
+ * @param capacity the initial capacity of the deque
+ * @param element_size size in bytes of the data to be stored
+ * @return array_deque_t
+ */
+array_deque_t create_array_deque(size_t capacity, size_t element_size);
+
+/**
+ * @brief Destroys the given instance of the array deque and releases its resources
+ * 
+ * @param deque the deque to be destroyed
+ */
+void destroy_array_deque(array_deque_t* deque);
+
+/**
+ * @brief Reuses a previously created array deque and resets its parameters
+ * 
+ * @param deque deque to be reused
+ * @param capacity the new desired capacity of the deque
+ * @param element_size the size in bytes of the new element type
+ */
+void reuse_array_deque(array_deque_t* deque, size_t capacity, size_t element_size);
+
+/**
+ * @brief Resizes the data buffer of the deque to the given capacity.
+ *        If the elements wrap around the end of the old buffer, they are unrolled into the new buffer.
+ * 
+ * @param deque deque to be resized
+ * @param new_capacity new capacity of the deque
+ */
+void reserve_array_deque(array_deque_t* deque, size_t new_capacity);
+
+/**
+ * @brief Returns the next capacity for a resized buffer from a previous known capacity
+ * 
+ * @param current_capacity old capacity of the buffer
+ * @return size_t new capacity of the buffer
+ */
+size_t next_array_deque_capacity(size_t current_capacity);
+
+/**
+ * @brief Removes all the elements of the deque while keeping its buffer
+ * 
+ * @param deque deque to be cleared
+ */
+void clear_array_deque(array_deque_t* deque);
+
+/**
+ * @brief Adds the given element to the front of the deque in O(1).
+ * 
+ * @param deque deque to be added to
+ * @param element pointer to the data of the element to be added
+ */
+void push_front_array_deque(array_deque_t* deque, const void* element);
+
+/**
+ * @brief Adds the given element to the back of the deque in O(1).
+ * 
+ * @param deque deque to be added to
+ * @param element pointer to the data of the element to be added
+ */
+void push_back_array_deque(array_deque_t* deque, const void* element);
+
+/**
+ * @brief Removes the first element in the deque and returns it
+ * 
+ * @param deque deque to be removed from
+ * @param element pointer where the element data will be copied to
+ */
+void pop_front_array_deque(array_deque_t* deque, void* element);
+
+/**
+ * @brief Removes the last element in the deque and returns it
+ * 
+ * @param deque deque to be removed from
+ * @param element pointer where the element data will be copied to
+ */
+void pop_back_array_deque(array_deque_t* deque, void* element);
+
+/**
+ * @brief Gets the address of the element at the given index (counted from the front) in the deque.
+ * 
+ * @param deque deque from which the element is retrieved
+ * @param index index of the element to be retrieved
+ * @return void* pointer to the element data, NULL if the index is out of range
+ */
+void* get_element_array_deque(const array_deque_t* deque, size_t index);
+
+/**
+ * @brief Sets the value of the entry at the given index with the value passed.
+ * 
+ * @param deque deque in which the value is set
+ * @param index index of the element to be set
+ * @param value const pointer to the data which will be copied
+ */
+void set_element_array_deque(array_deque_t* deque, size_t index, const void* value);
+
+/**
+ * @brief Returns a pointer to the first element in the deque.
+ * 
+ * @param deque deque from which the value is retrieved
+ * @return void* pointer to the first element
+ */
+void* front_array_deque(const array_deque_t* deque);
+
+/**
+ * @brief Returns a pointer to the last element in the deque.
+ * 
+ * @param deque deque from which the value is retrieved
+ * @return void* pointer to the last element
+ */
+void* back_array_deque(const array_deque_t* deque);
+
+/**
+ * @brief Returns if the given element is in the deque.
+ * 
+ * @param deque deque to be searched in
+ * @param element element to be search
+ * @param equal_func pointer to the data equality function
+ * @return 1 if contains, 0 if not contains
+ */
+int contains_array_deque(const array_deque_t* deque, const void* element, EQUALS_FUNC equal_func);
+
+/**
+ * @brief Wrapper for creating an int specialized array deque
+ * 
+ * @param capacity initial capacity of the deque
+ * @return array_deque_t of ints
+ */
+array_deque_t create_int_adeque(size_t capacity);
+
+/**
+ * @brief Wrapper for pushing an element to the front of an int specialized array deque
+ * 
+ * @param deque deque to be added into
+ * @param value value to be added
+ */
+void push_front_int_adeque(array_deque_t* deque, int value);
+
+/**
+ * @brief Wrapper for pushing an element to the back of an int specialized array deque
+ * 
+ * @param deque deque to be added into
+ * @param value value to be added
+ */
+void push_back_int_adeque(array_deque_t* deque, int value);
+
+/**
+ * @brief Wrapper for removing and getting the first element in an int specialized array deque
+ * 
+ * @param deque deque to be removed from
+ * @return int value removed from the front
+ */
+int pop_front_int_adeque(array_deque_t* deque);
+
+/**
+ * @brief Wrapper for removing and getting the last element in an int specialized array deque
+ * 
+ * @param deque deque to be removed from
+ * @return int value removed from the back
+ */
+int pop_back_int_adeque(array_deque_t* deque);
+
+/**
+ * @brief Getter wrapper for an int specialized array deque
+ * 
+ * @param deque deque to be retrieved from
+ * @param index index of the element to get
+ * @return int value at the given index
+ */
+int get_int_adeque(const array_deque_t* deque, size_t index);
+
+#endif /* DATA_ARRAY_DEQUE_H */
@@ -11,36 +11,97 @@ array_list_t create_array_list(size_t capacity, size_t element_size)
     out.size_ = 0;
     out.element_size_ = element_size;
     out.data_ = malloc(element_size * capacity);
+    out.mapping_ = NULL;
 
     return out;
 }
 
+/* "DSALIST1" */
+static const uint64_t MAPPED_ARRAY_LIST_MAGIC = 0x315453494C415344ULL;
+
+array_list_t create_mapped_array_list(const char* path, size_t capacity, size_t element_size)
+{
+    array_list_t out;
+
+    out.capacity_ = 0;
+    out.size_ = 0;
+    out.element_size_ = element_size;
+    out.data_ = NULL;
+    out.mapping_ = create_mapped_file(path, capacity * element_size);
+    if (out.mapping_ != NULL)
+    {
+        out.capacity_ = capacity;
+        out.data_ = data_mapped_file(out.mapping_);
+        write_header_mapped_file(out.mapping_, MAPPED_ARRAY_LIST_MAGIC, element_size, 0, 0, 0);
+    }
+
+    return out;
+}
+
+array_list_t open_mapped_array_list(const char* path, int read_only)
+{
+    array_list_t out;
+
+    out.capacity_ = 0;
+    out.size_ = 0;
+    out.element_size_ = 0;
+    out.data_ = NULL;
+    out.mapping_ = open_mapped_file(path, MAPPED_ARRAY_LIST_MAGIC, read_only);
+    if (out.mapping_ != NULL)
+    {
+        const mapped_header_t* header = header_mapped_file(out.mapping_);
+        out.element_size_ = header->element_size_;
+        out.size_ = header->count_;
+        out.capacity_ = data_bytes_mapped_file(out.mapping_) / out.element_size_;
+        out.data_ = data_mapped_file(out.mapping_);
+    }
+
+    return out;
+}
+
+void sync_array_list(array_list_t* list)
+{
+    if (list->mapping_ != NULL)
+        write_header_mapped_file(list->mapping_, MAPPED_ARRAY_LIST_MAGIC, list->element_size_, list->size_, 0, 1);
+}
+
+int verify_mapped_array_list(const array_list_t* list)
+{
+    return list->mapping_ != NULL && verify_mapped_file(list->mapping_);
+}
+
 void destroy_array_list(array_list_t* list)
 {
+    if (list->mapping_ != NULL)
+    {
+        write_header_mapped_file(list->mapping_, MAPPED_ARRAY_LIST_MAGIC, list->element_size_, list->size_, 0, 0);
+        close_mapped_file(list->mapping_);
+        list->mapping_ = NULL;
+    }
+    else
+        free(list->data_);
     list->size_ = 0;
     list->capacity_ = 0;
     list->element_size_ = 0;
-    free(list->data_);
     list->data_ = NULL;
 }
 
 void reuse_array_list(array_list_t* list, size_t capacity, size_t element_size)
 {
-    if (capacity * element_size > list->element_size_ * list->capacity_)
-    {
-        list->data_ = malloc(capacity * element_size);
-        list->capacity_ = capacity;
-    }
-    else
-        list->capacity_ = (list->capacity_ * list->element_size_) / element_size;
+    list->capacity_ = (list->capacity_ * list->element_size_) / element_size;
     list->element_size_ = element_size;
     list->size_ = 0;
+    reserve_array_list(list, capacity);
 }
 
 void resize_array_list(array_list_t* list, size_t new_size)
 {
     if (new_size > list->capacity_)
-        reserve_array_list(list, next_array_list_capacity(list->capacity_));
+    {
+        size_t next_capacity = next_array_list_capacity(list->capacity_);
+        if (!reserve_array_list(list, next_capacity > new_size ? next_capacity : new_size))
+            return;
+    }
     // else if (new_size > list->size_)
     //     memset(list->data_ + list->size_ * list->element_size_, 0, (new_size - list->size_) * list->element_size_);
 
@@ -49,23 +110,31 @@ void resize_array_list(array_list_t* list, size_t new_size)
 
 void swap_array_list(array_list_t* left, array_list_t* right)
 {
-    array_list_t temp = {
-        .capacity_ = right->capacity_,
-        .size_ = right->size_,
-        .element_size_ = right->element_size_,
-        .data_ = right->data_
-    };
+    array_list_t temp = *right;
     *right = *left;
     *left = temp;
 }
 
-void reserve_array_list(array_list_t* list, size_t new_capacity)
+int reserve_array_list(array_list_t* list, size_t new_capacity)
 {
     if (list->capacity_ < new_capacity)
     {
-        list->data_ = realloc(list->data_, new_capacity * list->element_size_);
+        if (list->mapping_ != NULL)
+        {
+            if (!grow_mapped_file(list->mapping_, new_capacity * list->element_size_))
+                return 0;
+            list->data_ = data_mapped_file(list->mapping_);
+        }
+        else
+        {
+            void* data = realloc(list->data_, new_capacity * list->element_size_);
+            if (data == NULL)
+                return 0;
+            list->data_ = data;
+        }
         list->capacity_ = new_capacity;
     }
+    return 1;
 }
 
 size_t next_array_list_capacity(size_t current_capacity)
@@ -75,15 +144,15 @@ size_t next_array_list_capacity(size_t current_capacity)
 
 void push_back_array_list(array_list_t* list, const void* element)
 {
-    if (list->size_ == list->capacity_)
-        reserve_array_list(list, next_array_list_capacity(list->capacity_));
+    if (list->size_ == list->capacity_ && !reserve_array_list(list, next_array_list_capacity(list->capacity_)))
+        return;
     set_element_array_list(list, list->size_++, element);
 }
 
 void push_front_array_list(array_list_t* list, const void* element)
 {
-    if (list->size_ == list->capacity_)
-        reserve_array_list(list, next_array_list_capacity(list->capacity_));
+    if (list->size_ == list->capacity_ && !reserve_array_list(list, next_array_list_capacity(list->capacity_)))
+        return;
     if (list->size_ != 0)
     {
         memmove(list->data_ + list->element_size_, list->data_, list->element_size_ * list->size_);
@@ -104,8 +173,8 @@ void insert_array_list(array_list_t* list, size_t index, const void* element)
     {
         if (index < list->size_)
         {
-            if (list->size_ == list->capacity_)
-                reserve_array_list(list, next_array_list_capacity(list->capacity_));
+            if (list->size_ == list->capacity_ && !reserve_array_list(list, next_array_list_capacity(list->capacity_)))
+                return;
             memmove(get_element_array_list(list, index + 1), get_element_array_list(list, index), list->element_size_ * (list->size_ - index));
             set_element_array_list(list, index, element);
             ++list->size_;
@@ -185,6 +254,11 @@ void* back_array_list(const array_list_t* list)
     return get_element_array_list(list, list->size_ - 1);
 }
 
+span_t span_array_list(const array_list_t* list)
+{
+    return create_span(list->data_, list->element_size_, list->size_);
+}
+
 int contains_array_list(const array_list_t* list, const void* element, EQUALS_FUNC equal_func)
 {
     return array_contains(element, list->data_, list->size_, list->element_size_, equal_func);
@@ -193,65 +267,4 @@ int contains_array_list(const array_list_t* list, const void* element, EQUALS_FU
 int contains_sorted_array_list(const array_list_t* list, const void* element, LESS_THAN_FUNC order_func)
 {
     return sorted_array_contains(element, list->data_, list->size_, list->element_size_, order_func);
-}
-
-array_list_t create_int_alist(size_t capacity)
-{
-    return create_array_list(capacity, sizeof(int));
-}
-
-void push_front_int_alist(array_list_t* list, int value)
-{
-    push_front_array_list(list, &value);
-}
-
-void push_back_int_alist(array_list_t* list, int value)
-{
-    push_back_array_list(list, &value);
-}
-
-void insert_int_alist(array_list_t* list, size_t index, int value)
-{
-    insert_array_list(list, index, &value);
-}
-
-int pop_front_int_alist(array_list_t* list)
-{
-    int temp;
-    pop_front_array_list(list, &temp);
-    return temp;
-}
-
-int pop_back_int_alist(array_list_t* list)
-{
-    int temp;
-    pop_back_array_list(list, &temp);
-    return temp;
-}
-
-int remove_int_alist(array_list_t* list, size_t index)
-{
-    int temp;
-    remove_array_list(list, index, &temp);
-    return temp;
-}
-
-int get_int_alist(const array_list_t* list, size_t index)
-{
-    return *(int*)get_element_array_list(list, index);
-}
-
-void set_int_alist(array_list_t* list, size_t index, int value)
-{
-    set_element_array_list(list, index, &value);
-}
-
-int front_int_alist(const array_list_t* list)
-{
-    return *(int*)front_array_list(list);
-}
-
-int back_int_alist(const array_list_t* list)
-{
-    return *(int*)back_array_list(list);
 }
\ No newline at end of file
@@ -14,6 +14,8 @@
 
 #include <stdlib.h>
 #include "algorithm.h"
+#include "span.h"
+#include "mapped_file.h"
 
 /**
  * @brief Struct representing an array list
@@ -22,6 +24,7 @@
  * @var size_ stores the current number of elements in the list
  * @var element_size_ stores the size in bytes of the datatype being stored
  * @var data_ stores the pointer to the buffer of data
+ * @var mapping_ stores the file holding the buffer of a file backed list, NULL if the buffer is in the heap
  */
 typedef struct data_array_list_st
 {
@@ -29,6 +32,7 @@ typedef struct data_array_list_st
     size_t size_;
     size_t element_size_;
     void* data_;
+    mapped_file_t* mapping_;
 } array_list_t;
 
 /**
@@ -40,6 +44,47 @@ typedef struct data_array_list_st
  */
 array_list_t create_array_list(size_t capacity, size_t element_size_);
 
+/**
+ * @brief Create an array list stored in the file at the given path, which is created or truncated.
+ *        The buffer is the file mapped in memory, so the list is used as any other list and its elements reach
+ *        the file without copies. The buffer grows by growing the file. See mapped_file.h.
+ *        If the file cannot be created the list has a NULL data_ and a capacity of 0.
+ * 
+ * @param path path of the file
+ * @param capacity the initial capacity of the array list
+ * @param element_size size in bytes of the data to be stored
+ * @return array_list_t
+ */
+array_list_t create_mapped_array_list(const char* path, size_t capacity, size_t element_size);
+
+/**
+ * @brief Opens an array list stored in a file by a mapped list, without reading or copying its elements.
+ *        A list opened read-only must not be modified, its pages are shared with every process opening the file.
+ *        If the file cannot be opened or does not hold a list the list has a NULL data_ and a capacity of 0.
+ * 
+ * @param path path of the file
+ * @param read_only 1 to open the list read-only, 0 to open it for writing
+ * @return array_list_t
+ */
+array_list_t open_mapped_array_list(const char* path, int read_only);
+
+/**
+ * @brief Writes the size, element size and checksum of a mapped list to its file and waits for the file to
+ *        reach the disk. Does nothing on lists in the heap or opened read-only.
+ *        destroy_array_list also writes them, without waiting for the disk.
+ * 
+ * @param list the array list to be synced
+ */
+void sync_array_list(array_list_t* list);
+
+/**
+ * @brief Returns if the elements of a mapped list match the checksum written in its file by the last sync
+ * 
+ * @param list the mapped array list to be verified
+ * @return 1 if they match, 0 if they do not or the list is not mapped
+ */
+int verify_mapped_array_list(const array_list_t* list);
+
 /**
  * @brief Destroys the given instance of the array list and releases its resources
  * 
@@ -59,6 +104,7 @@ void reuse_array_list(array_list_t* list, size_t capacity, size_t element_size);
 /**
  * @brief Resizes the given array list to be given size
  *        If the new size is greater than the current size, the new spots will contain garbage values.
+ *        The size is left as it was if the list could not grow to the new size (see reserve_array_list).
  * 
  * @param list list to be resized
  * @param new_size new size of the list
@@ -75,11 +121,14 @@ void swap_array_list(array_list_t* left, array_list_t* right);
 
 /**
  * @brief Resizes the data buffer of the array list to the given capacity
+ *        The buffer of a mapped list cannot grow if it was opened read-only or its file could not grow,
+ *        then the list is left as it was.
  * 
  * @param list list to be resized
  * @param new_capacity new capacity of the list
+ * @return int 1 if the list can hold new_capacity elements, 0 if its buffer could not grow
  */
-void reserve_array_list(array_list_t* list, size_t new_capacity);
+int reserve_array_list(array_list_t* list, size_t new_capacity);
 
 /**
  * @brief Returns the next capacity for a resized buffer from a previous known capacity
@@ -91,6 +140,7 @@ size_t next_array_list_capacity(size_t current_capacity);
 
 /**
  * @brief Adds the given element to the front of the list.
+ *        The element is not added if the list is full and its buffer could not grow (see reserve_array_list).
  * 
  * @param list list to be added to
  * @param element pointer to the data of the element to be added
@@ -99,6 +149,7 @@ void push_front_array_list(array_list_t* list, const void* element);
 
 /**
  * @brief Adds the given element to the back of the list.
+ *        The element is not added if the list is full and its buffer could not grow (see reserve_array_list).
  * 
  * @param list list to be added to
  * @param element pointer to the data of the element to be added
@@ -108,6 +159,7 @@ void push_back_array_list(array_list_t* list, const void* element);
 /**
  * @brief Adds the given element to the given index in the list.
  *        The index must be smaller than the size of the list
+ *        The element is not added if the list is full and its buffer could not grow (see reserve_array_list).
  * 
  * @param list list to be added to
  * @param index index of the position where the element will be added
@@ -191,6 +243,14 @@ void* front_array_list(const array_list_t* list);
  */
 void* back_array_list(const array_list_t* list);
 
+/**
+ * @brief Returns a span over the elements of the array list, valid until the list is modified
+ * 
+ * @param list list to be viewed
+ * @return span_t span of size_ elements
+ */
+span_t span_array_list(const array_list_t* list);
+
 /**
  * @brief Returns if the given element is in the array list.
  * 
@@ -212,95 +272,108 @@ int contains_array_list(const array_list_t* list, const void* element, EQUALS_FU
 int contains_sorted_array_list(const array_list_t* list, const void* element, LESS_THAN_FUNC order_func);
 
 /**
- * @brief Wrapper for creating an int specialized array list
- * 
- * @param capacity initial capacity of the list
- * @return array_list_t of ints
- */
-array_list_t create_int_alist(size_t capacity);
-
-/**
- * @brief Wrapper for pushing an element to the front of an int specialized array list
- * 
- * @param list list to be added into
- * @param value value to be added
- */
-void push_front_int_alist(array_list_t* list, int value);
-
-/**
- * @brief Wrapper for pushing an element to the back of an int specialized array list
- * 
- * @param list list to be added into
- * @param value value to be added
- */
-void push_back_int_alist(array_list_t* list, int value);
-
-/**
- * @brief Wrapper for adding an element to the given index of an int specialized array list
- * 
- * @param list list to be added into
- * @param index index where the element will be added in
- * @param value value to be added
- */
-void insert_int_alist(array_list_t* list, size_t index, int value);
-
-/**
- * @brief Wrapper for removing and getting the first element in an int specialized array list
- * 
- * @param list list to be removed from
- * @return int value removed from the front
- */
-int pop_front_int_alist(array_list_t* list);
-
-/**
- * @brief Wrapper for removing and getting the last element in an int specialized array list
- * 
- * @param list list to be removed from
- * @return int value removed from the back
- */
-int pop_back_int_alist(array_list_t* list);
-
-/**
- * @brief Wrapper for removing and getting the element at the given index in an int specialized array list
- * 
- * @param list list to be removed from
- * @param index index where the value is removed
- * @return int value removed from the list
- */
-int remove_int_alist(array_list_t* list, size_t index);
-
-/**
- * @brief Getter wrapper for an int specialized array list
- * 
- * @param list list to be retrieved from
- * @param index index of the element to get
- * @return int value at the given index
- */
-int get_int_alist(const array_list_t* list, size_t index);
-
-/**
- * @brief Wrapper for setting the value of an element in an int specialized array list
- * 
- * @param list list where the element is set
- * @param index index of the element entry
- * @param value value to be set
- */
-void set_int_alist(array_list_t* list, size_t index, int value);
-
-/**
- * @brief Wrapper for getting the first element of an int specialized array list
- * 
- * @param list list to be retrieved from
- * @return int value at the front
- */
-int front_int_alist(const array_list_t* list);
-
-/**
- * @brief Wrapper for getting the last element of an int specialized array list
- * 
- * @param list list to be retrieved from
- * @return int value at the back
- */
-int back_int_alist(const array_list_t* list);
+ * @brief Stamps out a typed specialization of the array list for the element type T.
+ *        The generated functions work on a regular array_list_t with element_size_ == sizeof(T), so a list
+ *        can be passed to both the typed and the generic functions. Elements are read and written with
+ *        plain assignments instead of memcpy calls of element_size_ bytes, which the compiler can inline
+ *        and vectorize.
+ * 
+ * Generated functions, with xxx the given tag:
+ * create_xxx_alist(capacity)
+ * data_xxx_alist(list): T* pointer to the first element
+ * push_front_xxx_alist(list, value), push_back_xxx_alist(list, value), insert_xxx_alist(list, index, value):
+ * do not add the value if the list is full and could not grow
+ * pop_front_xxx_alist(list), pop_back_xxx_alist(list), remove_xxx_alist(list, index): return the removed
+ * value, or a zeroed T if there is no element to remove
+ * get_xxx_alist(list, index), set_xxx_alist(list, index, value), front_xxx_alist(list), back_xxx_alist(list):
+ * without bounds checks
+ * 
+ * @param tag name of the specialization used in the generated function names
+ * @param T type of the elements
+ */
+#define DEFINE_TYPED_ARRAY_LIST(tag, T)                                                                         \
+static inline array_list_t create_##tag##_alist(size_t capacity)                                                \
+{                                                                                                               \
+    return create_array_list(capacity, sizeof(T));                                                              \
+}                                                                                                               \
+                                                                                                                \
+static inline T* data_##tag##_alist(const array_list_t* list)                                                   \
+{                                                                                                               \
+    return (T*)list->data_;                                                                                     \
+}                                                                                                               \
+                                                                                                                \
+static inline void push_back_##tag##_alist(array_list_t* list, T value)                                         \
+{                                                                                                               \
+    if (list->size_ == list->capacity_ && !reserve_array_list(list, next_array_list_capacity(list->capacity_))) \
+        return;                                                                                                 \
+    ((T*)list->data_)[list->size_++] = value;                                                                   \
+}                                                                                                               \
+                                                                                                                \
+static inline void insert_##tag##_alist(array_list_t* list, size_t index, T value)                              \
+{                                                                                                               \
+    if (index > list->size_)                                                                                    \
+        return;                                                                                                 \
+    if (list->size_ == list->capacity_ && !reserve_array_list(list, next_array_list_capacity(list->capacity_))) \
+        return;                                                                                                 \
+    T* data = (T*)list->data_;                                                                                  \
+    memmove(data + index + 1, data + index, (list->size_ - index) * sizeof(T));                                 \
+    data[index] = value;                                                                                        \
+    ++list->size_;                                                                                              \
+}                                                                                                               \
+                                                                                                                \
+static inline void push_front_##tag##_alist(array_list_t* list, T value)                                        \
+{                                                                                                               \
+    insert_##tag##_alist(list, 0, value);                                                                       \
+}                                                                                                               \
+                                                                                                                \
+static inline T remove_##tag##_alist(array_list_t* list, size_t index)                                          \
+{                                                                                                               \
+    T out = {0};                                                                                                \
+    if (index < list->size_)                                                                                    \
+    {                                                                                                           \
+        T* data = (T*)list->data_;                                                                              \
+        out = data[index];                                                                                      \
+        memmove(data + index, data + index + 1, (--list->size_ - index) * sizeof(T));                           \
+    }                                                                                                           \
+    return out;                                                                                                 \
+}                                                                                                               \
+                                                                                                                \
+static inline T pop_front_##tag##_alist(array_list_t* list)                                                     \
+{                                                                                                               \
+    return remove_##tag##_alist(list, 0);                                                                       \
+}                                                                                                               \
+                                                                                                                \
+static inline T pop_back_##tag##_alist(array_list_t* list)                                                      \
+{                                                                                                               \
+    T out = {0};                                                                                                \
+    if (list->size_ != 0)                                                                                       \
+        out = ((T*)list->data_)[--list->size_];                                                                 \
+    return out;                                                                                                 \
+}                                                                                                               \
+                                                                                                                \
+static inline T get_##tag##_alist(const array_list_t* list, size_t index)                                       \
+{                                                                                                               \
+    return ((const T*)list->data_)[index];                                                                      \
+}                                                                                                               \
+                                                                                                                \
+static inline void set_##tag##_alist(array_list_t* list, size_t index, T value)                                 \
+{                                                                                                               \
+    ((T*)list->data_)[index] = value;                                                                           \
+}                                                                                                               \
+                                                                                                                \
+static inline T front_##tag##_alist(const array_list_t* list)                                                   \
+{                                                                                                               \
+    return ((const T*)list->data_)[0];                                                                          \
+}                                                                                                               \
+                                                                                                                \
+static inline T back_##tag##_alist(const array_list_t* list)                                                    \
+{                                                                                                               \
+    return ((const T*)list->data_)[list->size_ - 1];                                                            \
+}
+
+/**
+ * @brief int specialization of the array list (create_int_alist, push_back_int_alist, get_int_alist, ...)
+ */
+DEFINE_TYPED_ARRAY_LIST(int, int)
 
 #endif /* array_list_t_H */
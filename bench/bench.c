@@ -0,0 +1,906 @@
+/*
+ * Microbenchmarks of the containers and algorithms of the library.
+ *
+ * Every case is run for the sizes 1e2, 1e3, ... up to its own limit (and --max-size), with 4 byte (int) and
+ * 64 byte payloads. Each run happens in a forked child process so the peak RSS reported belongs to that run only,
+ * and is repeated until it has been timed for at least --min-time milliseconds.
+ *
+ * Usage: bench [--min-size N] [--max-size N] [--min-time MS] [--filter TEXT]
+ * The results are written to stdout as one JSON document.
+ */
+
+#include "array_list.h"
+#include "stack.h"
+#include "ordered_set.h"
+#include "ordered_map.h"
+#include "heap.h"
+#include "linked_list.h"
+#include "matrix_ops.h"
+#include "adjacency_graph.h"
+#include "csr_graph.h"
+#include "graph_algorithm.h"
+#include "graph_file.h"
+#include "parallel_graph_algorithm.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <alloca.h>
+#include <time.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#define PAYLOAD_INT 4
+#define PAYLOAD_WIDE 64
+
+typedef struct bench_result_st
+{
+    size_t ops;
+    double ns;
+} bench_result;
+
+/* Runs one repetition of a case: the setup is not timed, the measured part adds its time and operations to result */
+typedef void (*BENCH_FUNC)(size_t size, size_t payload, bench_result* result);
+
+typedef struct bench_case_st
+{
+    const char* name;
+    BENCH_FUNC func;
+    size_t max_int;     /* largest size run with the int payload (0 to skip it) */
+    size_t max_wide;    /* largest size run with the 64 byte payload (0 to skip it) */
+} bench_case;
+
+typedef struct bench_report_st
+{
+    size_t ops;
+    double ns;
+    long peak_rss_kb;
+} bench_report;
+
+static volatile uint64_t sink;
+
+static double now_ns(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * 1e9 + time.tv_nsec;
+}
+
+static uint64_t random_state = 0x9E3779B97F4A7C15ull;
+
+static uint64_t next_random(void)
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    return random_state;
+}
+
+/* Payloads are ordered by the integer at their start, 32 bits wide for the int payload and 64 bits for the wide one */
+static void make_payload(void* payload, size_t payload_size, uint64_t key)
+{
+    memset(payload, 0, payload_size);
+    if (payload_size == PAYLOAD_INT)
+        *(uint32_t*)payload = (uint32_t)key;
+    else
+        *(uint64_t*)payload = key;
+}
+
+static int less_uint32(const void* left, const void* right)
+{
+    return *(const uint32_t*)left < *(const uint32_t*)right;
+}
+
+static int less_uint64(const void* left, const void* right)
+{
+    return *(const uint64_t*)left < *(const uint64_t*)right;
+}
+
+static LESS_THAN_FUNC payload_less(size_t payload_size)
+{
+    return payload_size == PAYLOAD_INT ? less_uint32 : less_uint64;
+}
+
+static key_kind_t payload_kind(size_t payload_size)
+{
+    return payload_size == PAYLOAD_INT ? KEY_KIND_UINT32 : KEY_KIND_UINT64;
+}
+
+static uint64_t* random_keys(size_t count, size_t payload_size)
+{
+    uint64_t* keys = (uint64_t*)malloc(count * sizeof(uint64_t));
+    for (size_t i = 0; i < count; ++i)
+        keys[i] = payload_size == PAYLOAD_INT ? (uint32_t)next_random() : next_random();
+    return keys;
+}
+
+static void bench_array_list_push_back(size_t size, size_t payload, bench_result* result)
+{
+    array_list_t list = create_array_list(0, payload);
+    void* element = alloca(payload);
+    make_payload(element, payload, 1);
+
+    double start = now_ns();
+    for (size_t i = 0; i < size; ++i)
+        push_back_array_list(&list, element);
+    result->ns += now_ns() - start;
+    result->ops += size;
+
+    destroy_array_list(&list);
+}
+
+static void bench_array_list_push_front(size_t size, size_t payload, bench_result* result)
+{
+    array_list_t list = create_array_list(0, payload);
+    void* element = alloca(payload);
+    make_payload(element, payload, 1);
+
+    double start = now_ns();
+    for (size_t i = 0; i < size; ++i)
+        push_front_array_list(&list, element);
+    result->ns += now_ns() - start;
+    result->ops += size;
+
+    destroy_array_list(&list);
+}
+
+static void bench_array_list_get_random(size_t size, size_t payload, bench_result* result)
+{
+    array_list_t list = create_array_list(size, payload);
+    void* element = alloca(payload);
+    for (size_t i = 0; i < size; ++i)
+    {
+        make_payload(element, payload, i);
+        push_back_array_list(&list, element);
+    }
+    uint64_t* indices = random_keys(size, payload);
+
+    uint64_t sum = 0;
+    double start = now_ns();
+    for (size_t i = 0; i < size; ++i)
+        sum += *(const uint32_t*)get_element_array_list(&list, indices[i] % size);
+    result->ns += now_ns() - start;
+    result->ops += size;
+    sink = sum;
+
+    free(indices);
+    destroy_array_list(&list);
+}
+
+static void bench_stack_push_pop(size_t size, size_t payload, bench_result* result)
+{
+    array_stack_t stack = create_astack(0, payload);
+    void* element = alloca(payload);
+    make_payload(element, payload, 1);
+
+    double start = now_ns();
+    for (size_t i = 0; i < size; ++i)
+        push_astack(&stack, element);
+    for (size_t i = 0; i < size; ++i)
+        pop_astack(&stack, element);
+    result->ns += now_ns() - start;
+    result->ops += 2 * size;
+
+    destroy_astack(&stack);
+}
+
+static ordered_set_t create_bench_set(ordered_backend_t backend, size_t payload)
+{
+    ordered_set_t set = backend == ORDERED_BTREE_BACKEND ? create_btree_ordered_set(payload, payload_less(payload))
+                                                          : create_ordered_set(0, payload, payload_less(payload));
+    set_key_kind_ordered_set(&set, payload_kind(payload));
+    return set;
+}
+
+static void insert_random_ordered_set(size_t size, size_t payload, bench_result* result, ordered_backend_t backend)
+{
+    ordered_set_t set = create_bench_set(backend, payload);
+    uint64_t* keys = random_keys(size, payload);
+    void* element = alloca(payload);
+
+    double start = now_ns();
+    for (size_t i = 0; i < size; ++i)
+    {
+        make_payload(element, payload, keys[i]);
+        insert_element_ordered_set(&set, element);
+    }
+    result->ns += now_ns() - start;
+    result->ops += size;
+
+    free(keys);
+    destroy_ordered_set(&set);
+}
+
+static void find_random_ordered_set(size_t size, size_t payload, bench_result* result, ordered_backend_t backend)
+{
+    ordered_set_t set = create_bench_set(backend, payload);
+    uint64_t* keys = random_keys(size, payload);
+    void* element = alloca(payload);
+
+    /* Inserting in ascending order appends, so the array backend is filled in linear time */
+    for (size_t i = 0; i < size; ++i)
+    {
+        make_payload(element, payload, 2 * i);
+        insert_element_ordered_set(&set, element);
+    }
+
+    size_t found = 0;
+    double start = now_ns();
+    for (size_t i = 0; i < size; ++i)
+    {
+        make_payload(element, payload, keys[i] % (2 * size));
+        found += find_ordered_set(&set, element) != NULL;
+    }
+    result->ns += now_ns() - start;
+    result->ops += size;
+    sink = found;
+
+    free(keys);
+    destroy_ordered_set(&set);
+}
+
+static void bench_ordered_set_insert_array(size_t size, size_t payload, bench_result* result)
+{
+    insert_random_ordered_set(size, payload, result, ORDERED_ARRAY_BACKEND);
+}
+
+static void bench_ordered_set_insert_btree(size_t size, size_t payload, bench_result* result)
+{
+    insert_random_ordered_set(size, payload, result, ORDERED_BTREE_BACKEND);
+}
+
+static void bench_ordered_set_find_array(size_t size, size_t payload, bench_result* result)
+{
+    find_random_ordered_set(size, payload, result, ORDERED_ARRAY_BACKEND);
+}
+
+static void bench_ordered_set_find_btree(size_t size, size_t payload, bench_result* result)
+{
+    find_random_ordered_set(size, payload, result, ORDERED_BTREE_BACKEND);
+}
+
+/* The maps have 64 bit keys and the payload as value */
+static ordered_map_t create_bench_map(ordered_backend_t backend, size_t payload)
+{
+    ordered_map_t map = backend == ORDERED_BTREE_BACKEND ? create_btree_ordered_map(sizeof(uint64_t), payload, less_uint64)
+                                                          : create_ordered_map(sizeof(uint64_t), payload, 0, less_uint64);
+    set_key_kind_ordered_map(&map, KEY_KIND_UINT64);
+    return map;
+}
+
+static void insert_random_ordered_map(size_t size, size_t payload, bench_result* result, ordered_backend_t backend)
+{
+    ordered_map_t map = create_bench_map(backend, payload);
+    uint64_t* keys = random_keys(size, PAYLOAD_WIDE);
+    void* value = alloca(payload);
+    make_payload(value, payload, 1);
+
+    double start = now_ns();
+    for (size_t i = 0; i < size; ++i)
+        insert_pair_ordered_map(&map, &keys[i], value);
+    result->ns += now_ns() - start;
+    result->ops += size;
+
+    free(keys);
+    destroy_ordered_map(&map);
+}
+
+static void get_random_ordered_map(size_t size, size_t payload, bench_result* result, ordered_backend_t backend)
+{
+    ordered_map_t map = create_bench_map(backend, payload);
+    uint64_t* keys = random_keys(size, PAYLOAD_WIDE);
+    void* value = alloca(payload);
+    make_payload(value, payload, 1);
+
+    for (uint64_t i = 0; i < size; ++i)
+    {
+        uint64_t key = 2 * i;
+        insert_pair_ordered_map(&map, &key, value);
+    }
+
+    size_t found = 0;
+    double start = now_ns();
+    for (size_t i = 0; i < size; ++i)
+    {
+        uint64_t key = keys[i] % (2 * size);
+        found += get_ordered_map(&map, &key) != NULL;
+    }
+    result->ns += now_ns() - start;
+    result->ops += size;
+    sink = found;
+
+    free(keys);
+    destroy_ordered_map(&map);
+}
+
+static void bench_ordered_map_insert_array(size_t size, size_t payload, bench_result* result)
+{
+    insert_random_ordered_map(size, payload, result, ORDERED_ARRAY_BACKEND);
+}
+
+static void bench_ordered_map_insert_btree(size_t size, size_t payload, bench_result* result)
+{
+    insert_random_ordered_map(size, payload, result, ORDERED_BTREE_BACKEND);
+}
+
+static void bench_ordered_map_get_array(size_t size, size_t payload, bench_result* result)
+{
+    get_random_ordered_map(size, payload, result, ORDERED_ARRAY_BACKEND);
+}
+
+static void bench_ordered_map_get_btree(size_t size, size_t payload, bench_result* result)
+{
+    get_random_ordered_map(size, payload, result, ORDERED_BTREE_BACKEND);
+}
+
+static void push_pop_heap(size_t size, size_t payload, bench_result* result, size_t arity)
+{
+    heap queue = create_dary_heap(size + 2, payload, arity, payload_less(payload));
+    uint64_t* keys = random_keys(size, payload);
+    void* element = alloca(payload);
+
+    double start = now_ns();
+    for (size_t i = 0; i < size; ++i)
+    {
+        make_payload(element, payload, keys[i]);
+        push_heap(&queue, element);
+    }
+    for (size_t i = 0; i < size; ++i)
+        pop_root_heap(&queue, element);
+    result->ns += now_ns() - start;
+    result->ops += 2 * size;
+
+    free(keys);
+    destroy_heap(&queue);
+}
+
+static void bench_heap_push_pop(size_t size, size_t payload, bench_result* result)
+{
+    push_pop_heap(size, payload, result, 2);
+}
+
+static void bench_heap_push_pop_4ary(size_t size, size_t payload, bench_result* result)
+{
+    push_pop_heap(size, payload, result, 4);
+}
+
+static void bench_heap_push_pop_8ary(size_t size, size_t payload, bench_result* result)
+{
+    push_pop_heap(size, payload, result, 8);
+}
+
+static void* random_payloads(size_t size, size_t payload)
+{
+    uint64_t* keys = random_keys(size, payload);
+    void* elements = malloc(size * payload);
+    for (size_t i = 0; i < size; ++i)
+        make_payload(elements + i * payload, payload, keys[i]);
+    free(keys);
+    return elements;
+}
+
+static void bench_heap_make(size_t size, size_t payload, bench_result* result)
+{
+    void* elements = random_payloads(size, payload);
+
+    double start = now_ns();
+    heap queue = make_heap_from_array(elements, size, payload, payload_less(payload));
+    result->ns += now_ns() - start;
+    result->ops += size;
+
+    free(elements);
+    destroy_heap(&queue);
+}
+
+static void bench_heap_sort(size_t size, size_t payload, bench_result* result)
+{
+    void* elements = random_payloads(size, payload);
+
+    double start = now_ns();
+    heap_sort_array(elements, size, payload, payload_less(payload));
+    result->ns += now_ns() - start;
+    result->ops += size;
+
+    free(elements);
+}
+
+static void push_pop_linked_list(size_t size, size_t payload, bench_result* result, int pooled)
+{
+    linked_list list = pooled ? create_pooled_linked_list(payload) : create_linked_list(payload);
+    void* element = alloca(payload);
+    make_payload(element, payload, 1);
+
+    double start = now_ns();
+    for (size_t i = 0; i < size; ++i)
+        push_linked_list(&list, element);
+    for (size_t i = 0; i < size; ++i)
+        pop_linked_list(&list, element);
+    result->ns += now_ns() - start;
+    result->ops += 2 * size;
+
+    destroy_linked_list(&list);
+}
+
+static void bench_linked_list_push_pop(size_t size, size_t payload, bench_result* result)
+{
+    push_pop_linked_list(size, payload, result, 0);
+}
+
+static void bench_linked_list_push_pop_pooled(size_t size, size_t payload, bench_result* result)
+{
+    push_pop_linked_list(size, payload, result, 1);
+}
+
+static void bench_linked_list_traverse(size_t size, size_t payload, bench_result* result)
+{
+    linked_list list = create_linked_list(payload);
+    void* element = alloca(payload);
+    for (size_t i = 0; i < size; ++i)
+    {
+        make_payload(element, payload, i);
+        push_linked_list(&list, element);
+    }
+
+    uint64_t sum = 0;
+    double start = now_ns();
+    for (linked_list_node node = list.head_; node != NULL; node = get_llist_node_next(node))
+        sum += *(const uint32_t*)get_llist_node_data(node);
+    result->ns += now_ns() - start;
+    result->ops += size;
+    sink = sum;
+
+    destroy_linked_list(&list);
+}
+
+/* The matrix cases use square matrices with size elements, their operations are multiply adds or elements */
+static size_t matrix_side(size_t size)
+{
+    return (size_t)sqrt((double)size);
+}
+
+static void fill_bench_matrix(matrix_t* matrix)
+{
+    size_t count = matrix->rows_ * matrix->columns_;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (matrix->element_size_ == sizeof(float))
+            ((float*)matrix->data_)[i] = (float)(next_random() % 16);
+        else
+            memset(matrix->data_ + i * matrix->element_size_, (int)(i & 0xFF), matrix->element_size_);
+    }
+}
+
+static void bench_matrix_gemm_float(size_t size, size_t payload, bench_result* result)
+{
+    (void)payload;
+    size_t side = matrix_side(size);
+    matrix_t a = create_matrix(sizeof(float), side, side, NULL);
+    matrix_t b = create_matrix(sizeof(float), side, side, NULL);
+    matrix_t c = create_matrix(sizeof(float), side, side, NULL);
+    fill_bench_matrix(&a);
+    fill_bench_matrix(&b);
+
+    double start = now_ns();
+    gemm_float_matrix(&a, &b, &c, 1.0f, 0.0f);
+    result->ns += now_ns() - start;
+    result->ops += side * side * side;
+
+    destroy_matrix(&a);
+    destroy_matrix(&b);
+    destroy_matrix(&c);
+}
+
+static void bench_matrix_gemm_int32(size_t size, size_t payload, bench_result* result)
+{
+    (void)payload;
+    size_t side = matrix_side(size);
+    matrix_t a = create_matrix(sizeof(int32_t), side, side, NULL);
+    matrix_t b = create_matrix(sizeof(int32_t), side, side, NULL);
+    matrix_t c = create_matrix(sizeof(int32_t), side, side, NULL);
+    fill_bench_matrix(&a);
+    fill_bench_matrix(&b);
+
+    double start = now_ns();
+    gemm_int32_matrix(&a, &b, &c, 1, 0);
+    result->ns += now_ns() - start;
+    result->ops += side * side * side;
+
+    destroy_matrix(&a);
+    destroy_matrix(&b);
+    destroy_matrix(&c);
+}
+
+static void bench_matrix_gemv_float(size_t size, size_t payload, bench_result* result)
+{
+    (void)payload;
+    size_t side = matrix_side(size);
+    matrix_t a = create_matrix(sizeof(float), side, side, NULL);
+    vector_t x = create_vector(side, sizeof(float), NULL);
+    vector_t y = create_vector(side, sizeof(float), NULL);
+    fill_bench_matrix(&a);
+    memset(x.data_, 0, side * sizeof(float));
+
+    double start = now_ns();
+    gemv_float_matrix(&a, &x, &y, 1.0f, 0.0f);
+    result->ns += now_ns() - start;
+    result->ops += side * side;
+
+    destroy_matrix(&a);
+    destroy_vector(&x);
+    destroy_vector(&y);
+}
+
+static void bench_matrix_transpose(size_t size, size_t payload, bench_result* result)
+{
+    size_t side = matrix_side(size);
+    matrix_t source = create_matrix(payload, side, side, NULL);
+    matrix_t destination = create_matrix(payload, side, side, NULL);
+    fill_bench_matrix(&source);
+
+    double start = now_ns();
+    transpose_matrix(&source, &destination);
+    result->ns += now_ns() - start;
+    result->ops += side * side;
+
+    destroy_matrix(&source);
+    destroy_matrix(&destination);
+}
+
+/* The graph cases use size nodes with the payload as node data and 8 random edges per node with int weights */
+#define BENCH_GRAPH_DEGREE 8
+
+static adjacency_graph_t create_bench_graph(size_t size, size_t payload)
+{
+    adjacency_graph_t graph = create_adj_graph(size, payload, sizeof(int));
+    void* node = alloca(payload);
+    for (size_t i = 0; i < size; ++i)
+    {
+        make_payload(node, payload, i);
+        add_node_adj_graph(&graph, node);
+    }
+    for (size_t i = 0; i < size; ++i)
+    {
+        for (size_t j = 0; j < BENCH_GRAPH_DEGREE; ++j)
+        {
+            int weight = 1 + (int)(next_random() % 100);
+            add_edge_adj_graph(&graph, (uint32_t)i, (uint32_t)(next_random() % size), &weight);
+        }
+    }
+    return graph;
+}
+
+static int never_predicate(const void* node_data)
+{
+    (void)node_data;
+    return 0;
+}
+
+static double int_weight(const void* edge)
+{
+    return *(const int*)edge;
+}
+
+static void bench_graph_bfs_adj(size_t size, size_t payload, bench_result* result)
+{
+    adjacency_graph_t graph = create_bench_graph(size, payload);
+
+    double start = now_ns();
+    sink = breadthsearch_for_adj_graph(&graph, 0, never_predicate);
+    result->ns += now_ns() - start;
+    result->ops += size;
+
+    destroy_adj_graph(&graph);
+}
+
+static void bench_graph_bfs_csr(size_t size, size_t payload, bench_result* result)
+{
+    adjacency_graph_t graph = create_bench_graph(size, payload);
+    csr_graph_t frozen = freeze_adj_graph(&graph);
+
+    double start = now_ns();
+    sink = breadthsearch_for_csr_graph(&frozen, 0, never_predicate);
+    result->ns += now_ns() - start;
+    result->ops += size;
+
+    destroy_csr_graph(&frozen);
+    destroy_adj_graph(&graph);
+}
+
+static void bench_graph_parallel_bfs_csr(size_t size, size_t payload, bench_result* result)
+{
+    adjacency_graph_t graph = create_bench_graph(size, payload);
+    csr_graph_t frozen = freeze_adj_graph(&graph);
+    csr_graph_t reverse = transpose_csr_graph(&frozen);
+    array_list_t depths;
+
+    double start = now_ns();
+    parallel_bfs_csr_graph(&frozen, &reverse, 0, 0, &depths, NULL);
+    result->ns += now_ns() - start;
+    result->ops += size;
+
+    destroy_array_list(&depths);
+    destroy_csr_graph(&frozen);
+    destroy_csr_graph(&reverse);
+    destroy_adj_graph(&graph);
+}
+
+static void bench_graph_dijkstra_csr(size_t size, size_t payload, bench_result* result)
+{
+    adjacency_graph_t graph = create_bench_graph(size, payload);
+    csr_graph_t frozen = freeze_adj_graph(&graph);
+    array_list_t distances;
+
+    double start = now_ns();
+    dijkstra_csr_graph(&frozen, 0, int_weight, &distances, NULL);
+    result->ns += now_ns() - start;
+    result->ops += size;
+
+    destroy_array_list(&distances);
+    destroy_csr_graph(&frozen);
+    destroy_adj_graph(&graph);
+}
+
+/* Point-to-point queries between random pairs of nodes, one op per query */
+#define BENCH_GRAPH_QUERIES 16
+
+static void point_to_point_bfs_csr(size_t size, size_t payload, bench_result* result, int bidirectional)
+{
+    adjacency_graph_t graph = create_bench_graph(size, payload);
+    csr_graph_t frozen = freeze_adj_graph(&graph);
+    csr_graph_t reverse = transpose_csr_graph(&frozen);
+
+    for (size_t i = 0; i < BENCH_GRAPH_QUERIES; ++i)
+    {
+        uint32_t source = (uint32_t)(next_random() % size);
+        uint32_t destination = (uint32_t)(next_random() % size);
+
+        double start = now_ns();
+        array_list_t path = bidirectional ? shortest_unweight_bidirectional_csr_graph(&frozen, &reverse, source, destination, NULL)
+            : shortest_unweight_csr_graph(&frozen, source, destination);
+        result->ns += now_ns() - start;
+        result->ops += 1;
+        sink += path.size_;
+        destroy_array_list(&path);
+    }
+
+    destroy_csr_graph(&reverse);
+    destroy_csr_graph(&frozen);
+    destroy_adj_graph(&graph);
+}
+
+static void bench_graph_p2p_bfs_csr(size_t size, size_t payload, bench_result* result)
+{
+    point_to_point_bfs_csr(size, payload, result, 0);
+}
+
+static void bench_graph_p2p_bfs_csr_bidirectional(size_t size, size_t payload, bench_result* result)
+{
+    point_to_point_bfs_csr(size, payload, result, 1);
+}
+
+static void delete_nodes_adj_graph(size_t size, size_t payload, bench_result* result, int indexed)
+{
+    adjacency_graph_t graph = create_bench_graph(size, payload);
+    size_t deleted = size < 1000 ? size : 1000;
+    if (indexed)
+        set_in_edge_index_adj_graph(&graph, 1);
+
+    double start = now_ns();
+    for (size_t i = 0; i < deleted; ++i)
+        delete_node_adj_agraph(&graph, (uint32_t)(i * (size / deleted)));
+    result->ns += now_ns() - start;
+    result->ops += deleted;
+
+    destroy_adj_graph(&graph);
+}
+
+static void bench_graph_delete_nodes(size_t size, size_t payload, bench_result* result)
+{
+    delete_nodes_adj_graph(size, payload, result, 0);
+}
+
+static void bench_graph_delete_nodes_indexed(size_t size, size_t payload, bench_result* result)
+{
+    delete_nodes_adj_graph(size, payload, result, 1);
+}
+
+static void bench_graph_build_adj(size_t size, size_t payload, bench_result* result)
+{
+    double start = now_ns();
+    adjacency_graph_t graph = create_bench_graph(size, payload);
+    result->ns += now_ns() - start;
+    result->ops += size;
+
+    destroy_adj_graph(&graph);
+}
+
+/* Most nodes of a sparse graph have a few out-edges, here 0 to 3, which fit in the node record */
+static void bench_graph_build_sparse_adj(size_t size, size_t payload, bench_result* result)
+{
+    void* node = alloca(payload);
+
+    double start = now_ns();
+    adjacency_graph_t graph = create_adj_graph(size, payload, sizeof(int));
+    for (size_t i = 0; i < size; ++i)
+    {
+        make_payload(node, payload, i);
+        add_node_adj_graph(&graph, node);
+    }
+    for (size_t i = 0; i < size; ++i)
+    {
+        for (size_t j = 0; j < i % 4; ++j)
+        {
+            int weight = 1 + (int)(next_random() % 100);
+            add_edge_adj_graph(&graph, (uint32_t)i, (uint32_t)(next_random() % size), &weight);
+        }
+    }
+    result->ns += now_ns() - start;
+    result->ops += size;
+
+    destroy_adj_graph(&graph);
+}
+
+static void bench_graph_load_adj(size_t size, size_t payload, bench_result* result)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/bench_graph_%d.bin", (int)getpid());
+    adjacency_graph_t graph = create_bench_graph(size, payload);
+    save_adj_graph(&graph, path, GRAPH_FILE_VARINT_DESTINATIONS);
+    destroy_adj_graph(&graph);
+
+    double start = now_ns();
+    graph = load_adj_graph(path);
+    result->ns += now_ns() - start;
+    result->ops += size;
+
+    destroy_adj_graph(&graph);
+    unlink(path);
+}
+
+static const bench_case cases[] =
+{
+    { "array_list/push_back", bench_array_list_push_back, 10000000, 10000000 },
+    { "array_list/push_front", bench_array_list_push_front, 100000, 10000 },
+    { "array_list/get_random", bench_array_list_get_random, 10000000, 10000000 },
+    { "stack/push_pop", bench_stack_push_pop, 10000000, 10000000 },
+    { "ordered_set/insert_random/array", bench_ordered_set_insert_array, 100000, 10000 },
+    { "ordered_set/insert_random/btree", bench_ordered_set_insert_btree, 10000000, 10000000 },
+    { "ordered_set/find_random/array", bench_ordered_set_find_array, 10000000, 10000000 },
+    { "ordered_set/find_random/btree", bench_ordered_set_find_btree, 10000000, 10000000 },
+    { "ordered_map/insert_random/array", bench_ordered_map_insert_array, 100000, 10000 },
+    { "ordered_map/insert_random/btree", bench_ordered_map_insert_btree, 10000000, 10000000 },
+    { "ordered_map/get_random/array", bench_ordered_map_get_array, 10000000, 10000000 },
+    { "ordered_map/get_random/btree", bench_ordered_map_get_btree, 10000000, 10000000 },
+    { "heap/push_pop", bench_heap_push_pop, 10000000, 10000000 },
+    { "heap/push_pop/4ary", bench_heap_push_pop_4ary, 10000000, 10000000 },
+    { "heap/push_pop/8ary", bench_heap_push_pop_8ary, 10000000, 10000000 },
+    { "heap/make_from_array", bench_heap_make, 10000000, 10000000 },
+    { "heap/sort", bench_heap_sort, 10000000, 10000000 },
+    { "linked_list/push_pop", bench_linked_list_push_pop, 10000000, 10000000 },
+    { "linked_list/push_pop_pooled", bench_linked_list_push_pop_pooled, 10000000, 10000000 },
+    { "linked_list/traverse", bench_linked_list_traverse, 10000000, 10000000 },
+    { "matrix/gemm_float", bench_matrix_gemm_float, 10000000, 0 },
+    { "matrix/gemm_int32", bench_matrix_gemm_int32, 10000000, 0 },
+    { "matrix/gemv_float", bench_matrix_gemv_float, 10000000, 0 },
+    { "matrix/transpose", bench_matrix_transpose, 10000000, 10000000 },
+    { "graph/bfs_adj", bench_graph_bfs_adj, 1000000, 1000000 },
+    { "graph/bfs_csr", bench_graph_bfs_csr, 1000000, 1000000 },
+    { "graph/parallel_bfs_csr", bench_graph_parallel_bfs_csr, 1000000, 1000000 },
+    { "graph/dijkstra_csr", bench_graph_dijkstra_csr, 1000000, 1000000 },
+    { "graph/p2p_bfs_csr", bench_graph_p2p_bfs_csr, 1000000, 1000000 },
+    { "graph/p2p_bfs_csr/bidirectional", bench_graph_p2p_bfs_csr_bidirectional, 1000000, 1000000 },
+    { "graph/build_adj", bench_graph_build_adj, 1000000, 1000000 },
+    { "graph/build_adj/sparse", bench_graph_build_sparse_adj, 1000000, 1000000 },
+    { "graph/load_adj", bench_graph_load_adj, 1000000, 1000000 },
+    { "graph/delete_nodes", bench_graph_delete_nodes, 1000000, 1000000 },
+    { "graph/delete_nodes/indexed", bench_graph_delete_nodes_indexed, 1000000, 1000000 },
+};
+
+/* Runs the case in a child process, so a crash does not stop the suite and the peak RSS is its own */
+static int run_case(const bench_case* bench, size_t size, size_t payload, double min_time_ns, bench_report* report)
+{
+    int channel[2];
+    if (pipe(channel) != 0)
+        return 0;
+
+    pid_t child = fork();
+    if (child < 0)
+    {
+        close(channel[0]);
+        close(channel[1]);
+        return 0;
+    }
+
+    if (child == 0)
+    {
+        bench_result result = { 0, 0.0 };
+        close(channel[0]);
+        do
+            bench->func(size, payload, &result);
+        while (result.ns < min_time_ns);
+
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        bench_report out = { result.ops, result.ns, usage.ru_maxrss };
+        ssize_t written = write(channel[1], &out, sizeof(out));
+        _exit(written == (ssize_t)sizeof(out) ? 0 : 1);
+    }
+
+    close(channel[1]);
+    ssize_t received = read(channel[0], report, sizeof(*report));
+    close(channel[0]);
+
+    int status;
+    waitpid(child, &status, 0);
+    return received == (ssize_t)sizeof(*report) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static void print_usage(const char* program)
+{
+    fprintf(stderr, "usage: %s [--min-size N] [--max-size N] [--min-time MS] [--filter TEXT]\n", program);
+}
+
+int main(int argc, char** argv)
+{
+    size_t min_size = 100;
+    size_t max_size = 10000000;
+    double min_time_ns = 100e6;
+    const char* filter = NULL;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (i + 1 < argc && strcmp(argv[i], "--min-size") == 0)
+            min_size = strtoull(argv[++i], NULL, 10);
+        else if (i + 1 < argc && strcmp(argv[i], "--max-size") == 0)
+            max_size = strtoull(argv[++i], NULL, 10);
+        else if (i + 1 < argc && strcmp(argv[i], "--min-time") == 0)
+            min_time_ns = strtod(argv[++i], NULL) * 1e6;
+        else if (i + 1 < argc && strcmp(argv[i], "--filter") == 0)
+            filter = argv[++i];
+        else
+        {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    const size_t payloads[] = { PAYLOAD_INT, PAYLOAD_WIDE };
+    int first = 1;
+
+    printf("{\n  \"benchmarks\": [");
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); ++c)
+    {
+        const bench_case* bench = &cases[c];
+        if (filter != NULL && strstr(bench->name, filter) == NULL)
+            continue;
+
+        for (size_t p = 0; p < 2; ++p)
+        {
+            size_t limit = payloads[p] == PAYLOAD_INT ? bench->max_int : bench->max_wide;
+            for (size_t size = 100; size <= limit && size <= max_size; size *= 10)
+            {
+                if (size < min_size)
+                    continue;
+
+                bench_report report;
+                if (!run_case(bench, size, payloads[p], min_time_ns, &report))
+                {
+                    fprintf(stderr, "%s (payload %zu, size %zu) failed\n", bench->name, payloads[p], size);
+                    continue;
+                }
+
+                double ns_per_op = report.ops ? report.ns / report.ops : 0.0;
+                printf("%s\n    {\"name\": \"%s\", \"payload_bytes\": %zu, \"size\": %zu, \"ops\": %zu, "
+                       "\"ns_per_op\": %.3f, \"ops_per_sec\": %.1f, \"peak_rss_kb\": %ld}",
+                       first ? "" : ",", bench->name, payloads[p], size, report.ops,
+                       ns_per_op, ns_per_op > 0.0 ? 1e9 / ns_per_op : 0.0, report.peak_rss_kb);
+                fflush(stdout);
+                first = 0;
+            }
+        }
+    }
+    printf("\n  ]\n}\n");
+
+    return 0;
+}
@@ -19,6 +19,19 @@ binary_tree create_binary_tree(size_t initial_capacity, size_t element_size)
     return out;
 }
 
+binary_tree create_dense_binary_tree(size_t initial_capacity, size_t element_size)
+{
+    binary_tree out;
+
+    out.capacity_ = initial_capacity != 0 ? initial_capacity : BASE_CAPACITY_BINARY_TREE;
+    out.size_ = 0;
+    out.element_size_ = element_size;
+    out.data_ = malloc(out.capacity_ * out.element_size_);
+    out.meta_data_ = NULL;
+
+    return out;
+}
+
 binary_tree copy_binary_tree(const binary_tree* tree)
 {
     binary_tree out;
@@ -30,8 +43,12 @@ binary_tree copy_binary_tree(const binary_tree* tree)
     out.data_ = malloc(tree->capacity_ * tree->element_size_);
     memcpy(out.data_, tree->data_, tree->size_ * tree->element_size_);
 
-    out.meta_data_ = (long*)malloc((tree->capacity_ / (sizeof(long) * 8) + 1) * sizeof(long));
-    memcpy(out.meta_data_, tree->meta_data_, (tree->capacity_ / (sizeof(long) * 8) + 1) * sizeof(long));
+    out.meta_data_ = NULL;
+    if (tree->meta_data_ != NULL)
+    {
+        out.meta_data_ = (long*)malloc((tree->capacity_ / (sizeof(long) * 8) + 1) * sizeof(long));
+        memcpy(out.meta_data_, tree->meta_data_, (tree->capacity_ / (sizeof(long) * 8) + 1) * sizeof(long));
+    }
 
     return out;
 }
@@ -51,17 +68,28 @@ void destroy_binary_tree(binary_tree* tree)
 
 void reuse_binary_tree(binary_tree* tree, size_t element_size)
 {
+    size_t meta_words = tree->capacity_ / (sizeof(long) * 8) + 1;
+
     tree->size_ = 0;
     tree->capacity_ = (tree->element_size_ * tree->capacity_) / element_size;
     tree->element_size_ = element_size;
 
-    memset(tree->meta_data_, 0, (tree->capacity_ / (sizeof(long) * 8) + 1) * sizeof(long));
+    if (tree->meta_data_ != NULL)
+    {
+        size_t new_meta_words = tree->capacity_ / (sizeof(long) * 8) + 1;
+        if (new_meta_words > meta_words)
+            tree->meta_data_ = (long*)realloc(tree->meta_data_, new_meta_words * sizeof(long));
+        memset(tree->meta_data_, 0, new_meta_words * sizeof(long));
+    }
 }
 
 void resize_binary_tree(binary_tree* tree, size_t new_size)
 {
     if (new_size > tree->capacity_)
-        reserve_binary_tree(tree, next_capacity_binary_tree(tree->capacity_));
+    {
+        size_t capacity = next_capacity_binary_tree(tree->capacity_);
+        reserve_binary_tree(tree, capacity > new_size ? capacity : new_size);
+    }
     tree->size_ = new_size;
 }
 
@@ -72,13 +100,14 @@ void reserve_binary_tree(binary_tree* tree, size_t reserve_capacity)
         void* new_data = realloc(tree->data_, reserve_capacity * tree->element_size_);
         tree->data_ = new_data;
 
-        if (((tree->capacity_ / (sizeof(long) * 8) + 1) * sizeof(long) * 8) < reserve_capacity)
+        size_t meta_words = tree->capacity_ / (sizeof(long) * 8) + 1;
+        size_t new_meta_words = reserve_capacity / (sizeof(long) * 8) + 1;
+        if (tree->meta_data_ != NULL && meta_words < new_meta_words)
         {
-            long* new_meta_data = (long*)realloc(tree->meta_data_, (reserve_capacity / (sizeof(long) * 8) + 1) * sizeof(long));
+            long* new_meta_data = (long*)realloc(tree->meta_data_, new_meta_words * sizeof(long));
             tree->meta_data_ = new_meta_data;
             
-            memset(tree->meta_data_ + (tree->capacity_ / (sizeof(long) * 8)) , 0, 
-                ((reserve_capacity - tree->capacity_) / (sizeof(long) * 8)) * sizeof(long));
+            memset(tree->meta_data_ + meta_words, 0, (new_meta_words - meta_words) * sizeof(long));
         }
         tree->capacity_ = reserve_capacity;
     }
@@ -91,17 +120,23 @@ size_t next_capacity_binary_tree(size_t current_capacity)
 
 int node_is_free(const binary_tree* tree, int node)
 {
-    return !(tree->meta_data_[node / (sizeof(long) * 8)] & (1L << (node % (sizeof(long) * 8))));
+    if (tree->meta_data_ == NULL)
+        return node >= tree->size_;
+    return !(tree->meta_data_[node / (sizeof(long) * 8)] & (long)(1UL << (node % (sizeof(long) * 8))));
 }
 
 void node_occupate(binary_tree* tree, int node)
 {
-    tree->meta_data_[node / (sizeof(long) * 8)] |= (1L << (node % (sizeof(long) * 8)));
+    if (tree->meta_data_ == NULL)
+        return;
+    tree->meta_data_[node / (sizeof(long) * 8)] |= (long)(1UL << (node % (sizeof(long) * 8)));
 }
 
 void node_free(binary_tree* tree, int node)
 {
-    tree->meta_data_[node / (sizeof(long) * 8)] &= ~(1L << (node % (sizeof(long) * 8)));
+    if (tree->meta_data_ == NULL)
+        return;
+    tree->meta_data_[node / (sizeof(long) * 8)] &= ~(long)(1UL << (node % (sizeof(long) * 8)));
 }
 
 void push_binary_tree(binary_tree* tree, int node, const void* data)
@@ -3,6 +3,11 @@
 
 #include <stdlib.h>
 
+/*
+ * Nodes are stored in breadth first order in data_. meta_data_ is a bitmap of the occupied nodes of a sparse tree.
+ * A dense tree (create_dense_binary_tree) always occupies the nodes [0, size_), so it has no bitmap (meta_data_ is NULL),
+ * node_occupate and node_free do nothing and growing it is a single realloc of data_.
+ */
 typedef struct data_binary_tree_st
 {
     void* data_;
@@ -13,6 +18,7 @@ typedef struct data_binary_tree_st
 } binary_tree;
 
 binary_tree create_binary_tree(size_t initial_capacity, size_t element_size);
+binary_tree create_dense_binary_tree(size_t initial_capacity, size_t element_size);
 binary_tree copy_binary_tree(const binary_tree* tree);
 void destroy_binary_tree(binary_tree* tree);
 void reuse_binary_tree(binary_tree* tree, size_t element_size);
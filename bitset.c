@@ -0,0 +1,100 @@
+#include "bitset.h"
+
+#include <string.h>
+
+bitset_t create_bitset(size_t bits)
+{
+    bitset_t out;
+
+    out.bits_ = bits;
+    out.capacity_ = words_for_bitset(bits);
+    out.data_ = (uint64_t*)calloc(out.capacity_ ? out.capacity_ : 1, sizeof(uint64_t));
+
+    return out;
+}
+
+void destroy_bitset(bitset_t* set)
+{
+    set->bits_ = 0;
+    set->capacity_ = 0;
+    free(set->data_);
+    set->data_ = NULL;
+}
+
+void reuse_bitset(bitset_t* set, size_t bits)
+{
+    size_t words = words_for_bitset(bits);
+    if (words > set->capacity_)
+    {
+        free(set->data_);
+        set->data_ = (uint64_t*)calloc(words, sizeof(uint64_t));
+        set->capacity_ = words;
+    }
+    else
+        memset(set->data_, 0, words * sizeof(uint64_t));
+    set->bits_ = bits;
+}
+
+void resize_bitset(bitset_t* set, size_t bits)
+{
+    size_t old_words = words_for_bitset(set->bits_);
+    size_t words = words_for_bitset(bits);
+
+    if (words > set->capacity_)
+    {
+        set->data_ = (uint64_t*)realloc(set->data_, words * sizeof(uint64_t));
+        set->capacity_ = words;
+    }
+
+    if (bits > set->bits_)
+    {
+        /* Clear the unused tail of the last old word and every new word */
+        if (set->bits_ & 63)
+            set->data_[old_words - 1] &= ((uint64_t)1 << (set->bits_ & 63)) - 1;
+        memset(set->data_ + old_words, 0, (words - old_words) * sizeof(uint64_t));
+    }
+    set->bits_ = bits;
+}
+
+size_t words_for_bitset(size_t bits)
+{
+    return (bits + 63) >> 6;
+}
+
+void reset_bitset(bitset_t* set)
+{
+    memset(set->data_, 0, words_for_bitset(set->bits_) * sizeof(uint64_t));
+}
+
+size_t popcount_bitset(const bitset_t* set)
+{
+    size_t words = set->bits_ >> 6;
+    size_t count = 0;
+
+    for (size_t i = 0; i < words; ++i)
+        count += __builtin_popcountll(set->data_[i]);
+    if (set->bits_ & 63)
+        count += __builtin_popcountll(set->data_[words] & (((uint64_t)1 << (set->bits_ & 63)) - 1));
+
+    return count;
+}
+
+size_t next_set_bit_bitset(const bitset_t* set, size_t from)
+{
+    if (from >= set->bits_)
+        return SIZE_MAX;
+
+    size_t words = words_for_bitset(set->bits_);
+    size_t index = from >> 6;
+    uint64_t word = set->data_[index] & (~(uint64_t)0 << (from & 63));
+
+    while (word == 0)
+    {
+        if (++index == words)
+            return SIZE_MAX;
+        word = set->data_[index];
+    }
+
+    size_t bit = (index << 6) + __builtin_ctzll(word);
+    return bit < set->bits_ ? bit : SIZE_MAX;
+}
@@ -0,0 +1,177 @@
+#ifndef DATA_BITSET_H
+#define DATA_BITSET_H
+
+/**
+ * @file bitset.h
+ * @author Edwin Solis (esolis6@gatech.edu)
+ * @brief A dense, resizable set of bits
+ * @version 0.1
+ * @date 2021-10-22
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+
+/**
+ * @brief Struct representing a bitset
+ *        Bit i is stored in the word i / 64 at the position i % 64.
+ * 
+ * @var bits_ stores the number of bits addressable in the set
+ * @var capacity_ stores the number of 64 bit words allocated in the buffer
+ * @var data_ stores the pointer to the buffer of words
+ */
+typedef struct data_bitset_st
+{
+    size_t bits_;
+    size_t capacity_;
+    uint64_t* data_;
+} bitset_t;
+
+/**
+ * @brief Create a bitset object with the given number of bits, all of them cleared
+ * 
+ * @param bits the number of bits in the set
+ * @return bitset_t
+ */
+bitset_t create_bitset(size_t bits);
+
+/**
+ * @brief Destroys the given instance of the bitset and releases its resources
+ * 
+ * @param set the bitset to be destroyed
+ */
+void destroy_bitset(bitset_t* set);
+
+/**
+ * @brief Reuses a previously created bitset with the given number of bits, all of them cleared.
+ *        The buffer is only reallocated when it is too small for the new number of bits.
+ * 
+ * @param set bitset to be reused
+ * @param bits the new number of bits in the set
+ */
+void reuse_bitset(bitset_t* set, size_t bits);
+
+/**
+ * @brief Resizes the bitset to the given number of bits while keeping the values of the old bits.
+ *        The new bits are cleared.
+ * 
+ * @param set bitset to be resized
+ * @param bits the new number of bits in the set
+ */
+void resize_bitset(bitset_t* set, size_t bits);
+
+/**
+ * @brief Returns the number of words needed to store the given number of bits
+ * 
+ * @param bits number of bits
+ * @return size_t number of 64 bit words
+ */
+size_t words_for_bitset(size_t bits);
+
+/**
+ * @brief Clears all the bits in the set
+ * 
+ * @param set bitset to be cleared
+ */
+void reset_bitset(bitset_t* set);
+
+/**
+ * @brief Returns the number of bits set in the bitset
+ * 
+ * @param set bitset to be counted
+ * @return size_t number of set bits
+ */
+size_t popcount_bitset(const bitset_t* set);
+
+/**
+ * @brief Returns the position of the first set bit at or after the given position.
+ *        The search skips cleared words at a time.
+ *        If there are no more set bits, the function returns SIZE_MAX
+ * 
+ * @param set bitset to be searched
+ * @param from position where the search starts
+ * @return size_t position of the next set bit
+ */
+size_t next_set_bit_bitset(const bitset_t* set, size_t from);
+
+/**
+ * @brief Sets the bit at the given position
+ * 
+ * @param set bitset to be written
+ * @param bit position of the bit
+ */
+static inline void set_bit_bitset(bitset_t* set, size_t bit)
+{
+    set->data_[bit >> 6] |= (uint64_t)1 << (bit & 63);
+}
+
+/**
+ * @brief Clears the bit at the given position
+ * 
+ * @param set bitset to be written
+ * @param bit position of the bit
+ */
+static inline void clear_bit_bitset(bitset_t* set, size_t bit)
+{
+    set->data_[bit >> 6] &= ~((uint64_t)1 << (bit & 63));
+}
+
+/**
+ * @brief Returns if the bit at the given position is set
+ * 
+ * @param set bitset to be read
+ * @param bit position of the bit
+ * @return 1 if set, 0 if cleared
+ */
+static inline int test_bit_bitset(const bitset_t* set, size_t bit)
+{
+    return (set->data_[bit >> 6] >> (bit & 63)) & 1;
+}
+
+/**
+ * @brief Sets the bit at the given position and returns its previous value
+ * 
+ * @param set bitset to be written
+ * @param bit position of the bit
+ * @return 1 if the bit was already set, 0 if it was cleared
+ */
+static inline int test_and_set_bit_bitset(bitset_t* set, size_t bit)
+{
+    uint64_t mask = (uint64_t)1 << (bit & 63);
+    uint64_t word = set->data_[bit >> 6];
+    set->data_[bit >> 6] = word | mask;
+    return (word & mask) != 0;
+}
+
+/**
+ * @brief Atomically sets the bit at the given position, safe to call from several threads at once
+ * 
+ * @param set bitset to be written
+ * @param bit position of the bit
+ */
+static inline void atomic_set_bit_bitset(bitset_t* set, size_t bit)
+{
+    __atomic_fetch_or(&set->data_[bit >> 6], (uint64_t)1 << (bit & 63), __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Atomically sets the bit at the given position and returns its previous value.
+ *        Only one of several threads setting the same bit at once sees it cleared.
+ * 
+ * @param set bitset to be written
+ * @param bit position of the bit
+ * @return 1 if the bit was already set, 0 if it was cleared
+ */
+static inline int atomic_test_and_set_bit_bitset(bitset_t* set, size_t bit)
+{
+    uint64_t mask = (uint64_t)1 << (bit & 63);
+    /* Plain read first so already visited bits do not take the cache line exclusively */
+    if (__atomic_load_n(&set->data_[bit >> 6], __ATOMIC_RELAXED) & mask)
+        return 1;
+    return (__atomic_fetch_or(&set->data_[bit >> 6], mask, __ATOMIC_RELAXED) & mask) != 0;
+}
+
+#endif /* DATA_BITSET_H */
@@ -0,0 +1,560 @@
+#include "btree.h"
+
+#include <string.h>
+#include <stdint.h>
+#include <alloca.h>
+
+static const size_t MIN_BRANCHING = 4;
+static const size_t CACHE_LINE_BYTES = 64;
+
+/*
+ * Node header, followed by the payload:
+ * leaf: records[leaf_capacity_]
+ * internal: children[fanout_], counts[fanout_], keys[fanout_ - 1]
+ */
+typedef struct btree_node_st
+{
+    size_t leaf_;
+    size_t count_;
+    struct btree_node_st* prev_;
+    struct btree_node_st* next_;
+} btree_node;
+
+static inline void* payload_btree(const btree_node* node)
+{
+    return (void*)node + sizeof(btree_node);
+}
+
+static inline void* record_btree(const btree_t* tree, const btree_node* node, size_t index)
+{
+    return payload_btree(node) + index * tree->record_size_;
+}
+
+static inline btree_node** children_btree(const btree_node* node)
+{
+    return (btree_node**)payload_btree(node);
+}
+
+static inline size_t* counts_btree(const btree_t* tree, const btree_node* node)
+{
+    return (size_t*)(payload_btree(node) + tree->fanout_ * sizeof(btree_node*));
+}
+
+static inline void* key_btree(const btree_t* tree, const btree_node* node, size_t index)
+{
+    return payload_btree(node) + tree->fanout_ * (sizeof(btree_node*) + sizeof(size_t)) + index * tree->key_size_;
+}
+
+static btree_node* create_node_btree(const btree_t* tree, int leaf)
+{
+    btree_node* node = (btree_node*)aligned_alloc(CACHE_LINE_BYTES, tree->node_bytes_);
+    node->leaf_ = leaf;
+    node->count_ = 0;
+    node->prev_ = NULL;
+    node->next_ = NULL;
+    return node;
+}
+
+static void destroy_node_btree(btree_node* node)
+{
+    if (!node->leaf_)
+    {
+        for (size_t i = 0; i < node->count_; ++i)
+            destroy_node_btree(children_btree(node)[i]);
+    }
+    free(node);
+}
+
+static size_t total_btree(const btree_t* tree, const btree_node* node)
+{
+    if (node->leaf_)
+        return node->count_;
+
+    size_t total = 0;
+    const size_t* counts = counts_btree(tree, node);
+    for (size_t i = 0; i < node->count_; ++i)
+        total += counts[i];
+    return total;
+}
+
+/* First record index in the leaf that is not less than the key */
+static size_t leaf_lower_bound_btree(const btree_t* tree, const btree_node* node, const void* key)
+{
+    return lower_bound_kind(key, payload_btree(node), node->count_, tree->record_size_, tree->key_kind_, tree->order_func_);
+}
+
+/* Child index of the internal node whose subtree may contain the key */
+static size_t child_index_btree(const btree_t* tree, const btree_node* node, const void* key)
+{
+    return upper_bound_kind(key, key_btree(tree, node, 0), node->count_ - 1, tree->key_size_, tree->key_kind_, tree->order_func_);
+}
+
+static inline int equal_keys_btree(const btree_t* tree, const void* left, const void* right)
+{
+    return equal_kind(left, right, tree->key_kind_, tree->order_func_);
+}
+
+static void insert_child_btree(const btree_t* tree, btree_node* node, size_t position, const void* key, btree_node* child, size_t child_count)
+{
+    btree_node** children = children_btree(node);
+    size_t* counts = counts_btree(tree, node);
+
+    memmove(children + position + 1, children + position, (node->count_ - position) * sizeof(btree_node*));
+    memmove(counts + position + 1, counts + position, (node->count_ - position) * sizeof(size_t));
+    memmove(key_btree(tree, node, position), key_btree(tree, node, position - 1), (node->count_ - position) * tree->key_size_);
+
+    children[position] = child;
+    counts[position] = child_count;
+    memcpy(key_btree(tree, node, position - 1), key, tree->key_size_);
+    ++node->count_;
+}
+
+/*
+ * Returns 0 if the key already exists, 1 if inserted, 2 if inserted and the node was split.
+ * On a split, split_key and split_node receive the separator and the new right node.
+ */
+static int insert_node_btree(btree_t* tree, btree_node* node, const void* record, void* split_key, btree_node** split_node)
+{
+    if (node->leaf_)
+    {
+        size_t position = leaf_lower_bound_btree(tree, node, record);
+        if (position < node->count_ && equal_keys_btree(tree, record_btree(tree, node, position), record))
+            return 0;
+
+        btree_node* target = node;
+        int result = 1;
+        if (node->count_ == tree->leaf_capacity_)
+        {
+            btree_node* right = create_node_btree(tree, 1);
+            size_t middle = node->count_ / 2;
+
+            right->count_ = node->count_ - middle;
+            memcpy(record_btree(tree, right, 0), record_btree(tree, node, middle), right->count_ * tree->record_size_);
+            node->count_ = middle;
+
+            right->next_ = node->next_;
+            right->prev_ = node;
+            if (node->next_ != NULL)
+                node->next_->prev_ = right;
+            node->next_ = right;
+
+            if (position > middle)
+            {
+                target = right;
+                position -= middle;
+            }
+            *split_node = right;
+            result = 2;
+        }
+
+        memmove(record_btree(tree, target, position + 1), record_btree(tree, target, position), (target->count_ - position) * tree->record_size_);
+        memcpy(record_btree(tree, target, position), record, tree->record_size_);
+        ++target->count_;
+
+        if (result == 2)
+            memcpy(split_key, record_btree(tree, *split_node, 0), tree->key_size_);
+        return result;
+    }
+
+    size_t index = child_index_btree(tree, node, record);
+    btree_node* child_split = NULL;
+    void* child_key = alloca(tree->key_size_);
+    int result = insert_node_btree(tree, children_btree(node)[index], record, child_key, &child_split);
+
+    if (result == 0)
+        return 0;
+    if (result == 1)
+    {
+        ++counts_btree(tree, node)[index];
+        return 1;
+    }
+
+    btree_node* left_child = children_btree(node)[index];
+    counts_btree(tree, node)[index] = total_btree(tree, left_child);
+    size_t right_total = total_btree(tree, child_split);
+    size_t position = index + 1;
+
+    if (node->count_ < tree->fanout_)
+    {
+        insert_child_btree(tree, node, position, child_key, child_split, right_total);
+        return 1;
+    }
+
+    btree_node* right = create_node_btree(tree, 0);
+    size_t middle = node->count_ / 2;
+
+    right->count_ = node->count_ - middle;
+    memcpy(children_btree(right), children_btree(node) + middle, right->count_ * sizeof(btree_node*));
+    memcpy(counts_btree(tree, right), counts_btree(tree, node) + middle, right->count_ * sizeof(size_t));
+    memcpy(key_btree(tree, right, 0), key_btree(tree, node, middle), (right->count_ - 1) * tree->key_size_);
+    memcpy(split_key, key_btree(tree, node, middle - 1), tree->key_size_);
+    node->count_ = middle;
+
+    if (position <= middle)
+        insert_child_btree(tree, node, position, child_key, child_split, right_total);
+    else
+        insert_child_btree(tree, right, position - middle, child_key, child_split, right_total);
+
+    *split_node = right;
+    return 2;
+}
+
+static size_t min_count_btree(const btree_t* tree, const btree_node* node)
+{
+    return node->leaf_ ? tree->leaf_capacity_ / 2 : tree->fanout_ / 2;
+}
+
+static void remove_child_btree(const btree_t* tree, btree_node* node, size_t position)
+{
+    btree_node** children = children_btree(node);
+    size_t* counts = counts_btree(tree, node);
+
+    memmove(children + position, children + position + 1, (node->count_ - position - 1) * sizeof(btree_node*));
+    memmove(counts + position, counts + position + 1, (node->count_ - position - 1) * sizeof(size_t));
+    memmove(key_btree(tree, node, position - 1), key_btree(tree, node, position), (node->count_ - position - 1) * tree->key_size_);
+    --node->count_;
+}
+
+/* Merges the child at index + 1 into the child at index and removes it from the parent */
+static void merge_children_btree(btree_t* tree, btree_node* parent, size_t index)
+{
+    btree_node* left = children_btree(parent)[index];
+    btree_node* right = children_btree(parent)[index + 1];
+
+    if (left->leaf_)
+    {
+        memcpy(record_btree(tree, left, left->count_), record_btree(tree, right, 0), right->count_ * tree->record_size_);
+        left->next_ = right->next_;
+        if (right->next_ != NULL)
+            right->next_->prev_ = left;
+    }
+    else
+    {
+        memcpy(key_btree(tree, left, left->count_ - 1), key_btree(tree, parent, index), tree->key_size_);
+        memcpy(key_btree(tree, left, left->count_), key_btree(tree, right, 0), (right->count_ - 1) * tree->key_size_);
+        memcpy(children_btree(left) + left->count_, children_btree(right), right->count_ * sizeof(btree_node*));
+        memcpy(counts_btree(tree, left) + left->count_, counts_btree(tree, right), right->count_ * sizeof(size_t));
+    }
+    left->count_ += right->count_;
+
+    counts_btree(tree, parent)[index] += counts_btree(tree, parent)[index + 1];
+    remove_child_btree(tree, parent, index + 1);
+    free(right);
+}
+
+static void borrow_left_btree(btree_t* tree, btree_node* parent, size_t index)
+{
+    btree_node* left = children_btree(parent)[index - 1];
+    btree_node* child = children_btree(parent)[index];
+    size_t moved;
+
+    if (child->leaf_)
+    {
+        memmove(record_btree(tree, child, 1), record_btree(tree, child, 0), child->count_ * tree->record_size_);
+        memcpy(record_btree(tree, child, 0), record_btree(tree, left, left->count_ - 1), tree->record_size_);
+        memcpy(key_btree(tree, parent, index - 1), record_btree(tree, child, 0), tree->key_size_);
+        moved = 1;
+    }
+    else
+    {
+        moved = counts_btree(tree, left)[left->count_ - 1];
+        memmove(children_btree(child) + 1, children_btree(child), child->count_ * sizeof(btree_node*));
+        memmove(counts_btree(tree, child) + 1, counts_btree(tree, child), child->count_ * sizeof(size_t));
+        memmove(key_btree(tree, child, 1), key_btree(tree, child, 0), (child->count_ - 1) * tree->key_size_);
+        children_btree(child)[0] = children_btree(left)[left->count_ - 1];
+        counts_btree(tree, child)[0] = moved;
+        memcpy(key_btree(tree, child, 0), key_btree(tree, parent, index - 1), tree->key_size_);
+        memcpy(key_btree(tree, parent, index - 1), key_btree(tree, left, left->count_ - 2), tree->key_size_);
+    }
+    --left->count_;
+    ++child->count_;
+    counts_btree(tree, parent)[index - 1] -= moved;
+    counts_btree(tree, parent)[index] += moved;
+}
+
+static void borrow_right_btree(btree_t* tree, btree_node* parent, size_t index)
+{
+    btree_node* child = children_btree(parent)[index];
+    btree_node* right = children_btree(parent)[index + 1];
+    size_t moved;
+
+    if (child->leaf_)
+    {
+        memcpy(record_btree(tree, child, child->count_), record_btree(tree, right, 0), tree->record_size_);
+        memmove(record_btree(tree, right, 0), record_btree(tree, right, 1), (right->count_ - 1) * tree->record_size_);
+        memcpy(key_btree(tree, parent, index), record_btree(tree, right, 0), tree->key_size_);
+        moved = 1;
+    }
+    else
+    {
+        moved = counts_btree(tree, right)[0];
+        children_btree(child)[child->count_] = children_btree(right)[0];
+        counts_btree(tree, child)[child->count_] = moved;
+        memcpy(key_btree(tree, child, child->count_ - 1), key_btree(tree, parent, index), tree->key_size_);
+        memcpy(key_btree(tree, parent, index), key_btree(tree, right, 0), tree->key_size_);
+        memmove(children_btree(right), children_btree(right) + 1, (right->count_ - 1) * sizeof(btree_node*));
+        memmove(counts_btree(tree, right), counts_btree(tree, right) + 1, (right->count_ - 1) * sizeof(size_t));
+        memmove(key_btree(tree, right, 0), key_btree(tree, right, 1), (right->count_ - 2) * tree->key_size_);
+    }
+    --right->count_;
+    ++child->count_;
+    counts_btree(tree, parent)[index + 1] -= moved;
+    counts_btree(tree, parent)[index] += moved;
+}
+
+static void rebalance_child_btree(btree_t* tree, btree_node* parent, size_t index)
+{
+    btree_node* child = children_btree(parent)[index];
+    if (child->count_ >= min_count_btree(tree, child))
+        return;
+
+    if (index > 0 && children_btree(parent)[index - 1]->count_ > min_count_btree(tree, child))
+        borrow_left_btree(tree, parent, index);
+    else if (index + 1 < parent->count_ && children_btree(parent)[index + 1]->count_ > min_count_btree(tree, child))
+        borrow_right_btree(tree, parent, index);
+    else if (index > 0)
+        merge_children_btree(tree, parent, index - 1);
+    else if (index + 1 < parent->count_)
+        merge_children_btree(tree, parent, index);
+}
+
+static int remove_node_btree(btree_t* tree, btree_node* node, const void* key, void* record)
+{
+    if (node->leaf_)
+    {
+        size_t position = leaf_lower_bound_btree(tree, node, key);
+        if (position == node->count_ || !equal_keys_btree(tree, record_btree(tree, node, position), key))
+            return 0;
+
+        if (record != NULL)
+            memcpy(record, record_btree(tree, node, position), tree->record_size_);
+        memmove(record_btree(tree, node, position), record_btree(tree, node, position + 1), (node->count_ - position - 1) * tree->record_size_);
+        --node->count_;
+        return 1;
+    }
+
+    size_t index = child_index_btree(tree, node, key);
+    if (!remove_node_btree(tree, children_btree(node)[index], key, record))
+        return 0;
+
+    --counts_btree(tree, node)[index];
+    rebalance_child_btree(tree, node, index);
+    return 1;
+}
+
+btree_t create_btree(size_t record_size, size_t key_size, LESS_THAN_FUNC order_function)
+{
+    btree_t out;
+    size_t payload = BTREE_NODE_BYTES - sizeof(btree_node);
+    size_t child_size = sizeof(btree_node*) + sizeof(size_t);
+
+    out.root_ = NULL;
+    out.first_ = NULL;
+    out.size_ = 0;
+    out.record_size_ = record_size;
+    out.key_size_ = key_size;
+    out.leaf_capacity_ = payload / record_size;
+    out.fanout_ = (payload + key_size) / (child_size + key_size);
+    out.order_func_ = order_function;
+    out.key_kind_ = KEY_KIND_CUSTOM;
+
+    /* Records or keys too large for the default node size grow the nodes to keep a minimal branching factor */
+    if (out.leaf_capacity_ < MIN_BRANCHING)
+        out.leaf_capacity_ = MIN_BRANCHING;
+    if (out.fanout_ < MIN_BRANCHING)
+        out.fanout_ = MIN_BRANCHING;
+
+    size_t leaf_bytes = out.leaf_capacity_ * record_size;
+    size_t internal_bytes = out.fanout_ * child_size + (out.fanout_ - 1) * key_size;
+    size_t node_bytes = sizeof(btree_node) + (leaf_bytes > internal_bytes ? leaf_bytes : internal_bytes);
+    out.node_bytes_ = (node_bytes + CACHE_LINE_BYTES - 1) / CACHE_LINE_BYTES * CACHE_LINE_BYTES;
+
+    return out;
+}
+
+void destroy_btree(btree_t* tree)
+{
+    clear_btree(tree);
+    tree->record_size_ = 0;
+    tree->key_size_ = 0;
+    tree->leaf_capacity_ = 0;
+    tree->fanout_ = 0;
+    tree->node_bytes_ = 0;
+    tree->order_func_ = NULL;
+}
+
+void clear_btree(btree_t* tree)
+{
+    if (tree->root_ != NULL)
+        destroy_node_btree(tree->root_);
+    tree->root_ = NULL;
+    tree->first_ = NULL;
+    tree->size_ = 0;
+}
+
+int insert_btree(btree_t* tree, const void* record)
+{
+    if (tree->root_ == NULL)
+    {
+        btree_node* leaf = create_node_btree(tree, 1);
+        memcpy(record_btree(tree, leaf, 0), record, tree->record_size_);
+        leaf->count_ = 1;
+        tree->root_ = leaf;
+        tree->first_ = leaf;
+        tree->size_ = 1;
+        return 1;
+    }
+
+    btree_node* split_node = NULL;
+    void* split_key = alloca(tree->key_size_);
+    int result = insert_node_btree(tree, tree->root_, record, split_key, &split_node);
+    if (result == 0)
+        return 0;
+
+    if (result == 2)
+    {
+        btree_node* old_root = tree->root_;
+        btree_node* root = create_node_btree(tree, 0);
+        children_btree(root)[0] = old_root;
+        children_btree(root)[1] = split_node;
+        counts_btree(tree, root)[0] = total_btree(tree, old_root);
+        counts_btree(tree, root)[1] = total_btree(tree, split_node);
+        memcpy(key_btree(tree, root, 0), split_key, tree->key_size_);
+        root->count_ = 2;
+        tree->root_ = root;
+    }
+
+    ++tree->size_;
+    return 1;
+}
+
+int remove_btree(btree_t* tree, const void* key, void* record)
+{
+    if (tree->root_ == NULL || !remove_node_btree(tree, tree->root_, key, record))
+        return 0;
+
+    --tree->size_;
+    btree_node* root = tree->root_;
+    if (!root->leaf_ && root->count_ == 1)
+    {
+        tree->root_ = children_btree(root)[0];
+        free(root);
+    }
+    else if (root->leaf_ && root->count_ == 0)
+    {
+        free(root);
+        tree->root_ = NULL;
+        tree->first_ = NULL;
+    }
+    return 1;
+}
+
+void* find_btree(const btree_t* tree, const void* key)
+{
+    btree_cursor_t cursor = lower_bound_btree(tree, key);
+    void* record = get_btree_cursor(tree, &cursor);
+    if (record != NULL && equal_keys_btree(tree, record, key))
+        return record;
+    return NULL;
+}
+
+void* at_index_btree(const btree_t* tree, size_t index)
+{
+    btree_cursor_t cursor = cursor_at_btree(tree, index);
+    return get_btree_cursor(tree, &cursor);
+}
+
+size_t index_of_btree(const btree_t* tree, const void* key)
+{
+    const btree_node* node = tree->root_;
+    size_t index = 0;
+    if (node == NULL)
+        return SIZE_MAX;
+
+    while (!node->leaf_)
+    {
+        size_t child = child_index_btree(tree, node, key);
+        const size_t* counts = counts_btree(tree, node);
+        for (size_t i = 0; i < child; ++i)
+            index += counts[i];
+        node = children_btree(node)[child];
+    }
+
+    size_t position = leaf_lower_bound_btree(tree, node, key);
+    if (position < node->count_ && equal_keys_btree(tree, record_btree(tree, node, position), key))
+        return index + position;
+    return SIZE_MAX;
+}
+
+btree_cursor_t begin_btree(const btree_t* tree)
+{
+    btree_cursor_t out = { tree->first_, 0 };
+    return out;
+}
+
+btree_cursor_t lower_bound_btree(const btree_t* tree, const void* key)
+{
+    btree_cursor_t out = { NULL, 0 };
+    const btree_node* node = tree->root_;
+    if (node == NULL)
+        return out;
+
+    while (!node->leaf_)
+        node = children_btree(node)[child_index_btree(tree, node, key)];
+
+    out.leaf_ = (void*)node;
+    out.slot_ = leaf_lower_bound_btree(tree, node, key);
+    if (out.slot_ == node->count_)
+    {
+        out.leaf_ = node->next_;
+        out.slot_ = 0;
+    }
+    return out;
+}
+
+btree_cursor_t cursor_at_btree(const btree_t* tree, size_t index)
+{
+    btree_cursor_t out = { NULL, 0 };
+    const btree_node* node = tree->root_;
+    if (node == NULL || index >= tree->size_)
+        return out;
+
+    while (!node->leaf_)
+    {
+        const size_t* counts = counts_btree(tree, node);
+        size_t child = 0;
+        while (index >= counts[child])
+            index -= counts[child++];
+        node = children_btree(node)[child];
+    }
+
+    out.leaf_ = (void*)node;
+    out.slot_ = index;
+    return out;
+}
+
+void next_btree_cursor(btree_cursor_t* cursor)
+{
+    const btree_node* leaf = cursor->leaf_;
+    if (leaf == NULL)
+        return;
+
+    if (++cursor->slot_ == leaf->count_)
+    {
+        cursor->leaf_ = leaf->next_;
+        cursor->slot_ = 0;
+    }
+}
+
+void* get_btree_cursor(const btree_t* tree, const btree_cursor_t* cursor)
+{
+    if (cursor->leaf_ == NULL)
+        return NULL;
+    return record_btree(tree, cursor->leaf_, cursor->slot_);
+}
+
+size_t run_btree_cursor(const btree_cursor_t* cursor)
+{
+    const btree_node* leaf = cursor->leaf_;
+    return leaf != NULL ? leaf->count_ - cursor->slot_ : 0;
+}
@@ -0,0 +1,216 @@
+#ifndef DATA_BTREE_H
+#define DATA_BTREE_H
+
+/**
+ * @file btree.h
+ * @author Edwin Solis (edwinsolisf12@gmail.com)
+ * @brief A type adjustable implementation of an order statistic B+tree
+ * @version 0.1
+ * @date 2021-11-02
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include "algorithm.h"
+
+#include <stdlib.h>
+
+/**
+ * @details Implementation
+ * 
+ * The tree stores fixed size records ordered by the key found at the start of each record, so it can be used
+ * both as a set (the record is the key) and as a map (the record is the key followed by the value).
+ * The order function is called with pointers to records or keys and must only read the key bytes.
+ * 
+ * All the records live in the leaves, which are linked in order so range scans walk the leaves sequentially.
+ * Internal nodes store the separator keys (only key_size bytes), the children and the number of records in
+ * each child subtree, which gives O(log N) access by index and index lookup by key.
+ * 
+ * Every node has the same size, a multiple of the cache line size (BTREE_NODE_BYTES), and is allocated aligned
+ * to a cache line. The number of records per leaf and children per internal node are derived from it.
+ * Records or keys too large to fit at least 4 per node make the nodes of that tree larger.
+ * 
+ */
+
+/**
+ * @brief Default size in bytes of the nodes of the tree
+ */
+#define BTREE_NODE_BYTES 512
+
+/**
+ * @brief Storage used by the ordered containers (ordered_set_t and ordered_map_t)
+ * 
+ * ORDERED_ARRAY_BACKEND stores the elements in a sorted contiguous array
+ * ORDERED_BTREE_BACKEND stores the elements in the leaves of a B+tree
+ */
+typedef enum data_ordered_backend_en
+{
+    ORDERED_ARRAY_BACKEND,
+    ORDERED_BTREE_BACKEND
+} ordered_backend_t;
+
+/**
+ * @brief Struct representing a B+tree
+ * 
+ * @var root_ stores the pointer to the root node (NULL if the tree is empty)
+ * @var first_ stores the pointer to the leftmost leaf
+ * @var size_ stores the number of records in the tree
+ * @var record_size_ stores the size in bytes of each record
+ * @var key_size_ stores the size in bytes of the key at the start of each record
+ * @var leaf_capacity_ stores the maximum number of records in a leaf
+ * @var fanout_ stores the maximum number of children of an internal node
+ * @var node_bytes_ stores the size in bytes of every node
+ * @var order_func_ stores a pointer to the comparison function for the keys
+ * @var key_kind_ stores the built-in kind of the keys, used to search the nodes without calling order_func_
+ */
+typedef struct data_btree_st
+{
+    void* root_;
+    void* first_;
+    size_t size_;
+    size_t record_size_;
+    size_t key_size_;
+    size_t leaf_capacity_;
+    size_t fanout_;
+    size_t node_bytes_;
+    LESS_THAN_FUNC order_func_;
+    key_kind_t key_kind_;
+} btree_t;
+
+/**
+ * @brief Struct representing a position in the tree, used to walk the records in order
+ * 
+ * @var leaf_ stores the pointer to the leaf of the position (NULL past the end)
+ * @var slot_ stores the index of the record inside the leaf
+ */
+typedef struct data_btree_cursor_st
+{
+    void* leaf_;
+    size_t slot_;
+} btree_cursor_t;
+
+/**
+ * @brief Create an empty B+tree with the given parameters
+ * 
+ * @param record_size size in bytes of the records to be stored
+ * @param key_size size in bytes of the key at the start of each record
+ * @param order_function function pointer to the comparison function for the keys
+ * @return btree_t
+ */
+btree_t create_btree(size_t record_size, size_t key_size, LESS_THAN_FUNC order_function);
+
+/**
+ * @brief Destroys the given instance of the tree and releases all its nodes
+ * 
+ * @param tree tree to be destroyed
+ */
+void destroy_btree(btree_t* tree);
+
+/**
+ * @brief Removes all the records of the tree
+ * 
+ * @param tree tree to be cleared
+ */
+void clear_btree(btree_t* tree);
+
+/**
+ * @brief Inserts the given record in the tree.
+ *        If a record with the same key is already in the tree, the tree is not modified.
+ * 
+ * @param tree tree to be inserted to
+ * @param record pointer to the record
+ * @return 1 if inserted, 0 if the key was already in the tree
+ */
+int insert_btree(btree_t* tree, const void* record);
+
+/**
+ * @brief Removes the record with the given key from the tree
+ * 
+ * @param tree tree to be removed from
+ * @param key pointer to the key of the record
+ * @param record pointer where the removed record is copied to (can be NULL)
+ * @return 1 if removed, 0 if the key was not in the tree
+ */
+int remove_btree(btree_t* tree, const void* key, void* record);
+
+/**
+ * @brief Gets the address of the record with the given key.
+ *        If the key is not in the tree, the function returns NULL
+ * 
+ * @param tree tree to be searched
+ * @param key pointer to the key
+ * @return void* pointer to the record
+ */
+void* find_btree(const btree_t* tree, const void* key);
+
+/**
+ * @brief Gets the address of the record at the given position in key order
+ * 
+ * @param tree tree to be searched
+ * @param index index of the record
+ * @return void* pointer to the record, NULL if the index is out of range
+ */
+void* at_index_btree(const btree_t* tree, size_t index);
+
+/**
+ * @brief Returns the position in key order of the record with the given key.
+ *        If the key is not in the tree it returns SIZE_MAX
+ * 
+ * @param tree tree to be searched
+ * @param key pointer to the key
+ * @return size_t index of the record
+ */
+size_t index_of_btree(const btree_t* tree, const void* key);
+
+/**
+ * @brief Returns a cursor to the first record of the tree
+ * 
+ * @param tree tree to be iterated
+ * @return btree_cursor_t
+ */
+btree_cursor_t begin_btree(const btree_t* tree);
+
+/**
+ * @brief Returns a cursor to the first record with a key greater or equal to the given key
+ * 
+ * @param tree tree to be iterated
+ * @param key pointer to the key
+ * @return btree_cursor_t
+ */
+btree_cursor_t lower_bound_btree(const btree_t* tree, const void* key);
+
+/**
+ * @brief Returns a cursor to the record at the given position in key order
+ * 
+ * @param tree tree to be iterated
+ * @param index index of the record
+ * @return btree_cursor_t
+ */
+btree_cursor_t cursor_at_btree(const btree_t* tree, size_t index);
+
+/**
+ * @brief Advances the cursor to the next record in key order, moving to the next leaf when needed
+ * 
+ * @param cursor cursor to be advanced
+ */
+void next_btree_cursor(btree_cursor_t* cursor);
+
+/**
+ * @brief Gets the address of the record at the position of the cursor
+ * 
+ * @param tree tree being iterated
+ * @param cursor cursor of the position
+ * @return void* pointer to the record, NULL past the end
+ */
+void* get_btree_cursor(const btree_t* tree, const btree_cursor_t* cursor);
+
+/**
+ * @brief Returns the number of records stored contiguously from the position of the cursor to the end of its leaf
+ * 
+ * @param cursor cursor of the position
+ * @return size_t number of records
+ */
+size_t run_btree_cursor(const btree_cursor_t* cursor);
+
+#endif /* DATA_BTREE_H */
@@ -0,0 +1,176 @@
+#include "csr_graph.h"
+
+#include <string.h>
+
+csr_graph_t freeze_adj_graph(const adjacency_graph_t* graph)
+{
+    csr_graph_t out;
+
+    out.nodes_ = graph->nodes_;
+    out.node_element_size_ = graph->node_element_size_;
+    out.edge_element_size_ = graph->edge_element_size_;
+    out.mapping_ = NULL;
+    out.valid_ = create_bitset(graph->nodes_);
+    out.offsets_ = (size_t*)malloc((graph->nodes_ + 1) * sizeof(size_t));
+    out.node_data_ = malloc(graph->nodes_ * graph->node_element_size_);
+
+    size_t edges = 0;
+    for (size_t i = 0; i < graph->nodes_; ++i)
+    {
+        out.offsets_[i] = edges;
+        if (is_valid_node_adj(graph, i))
+        {
+            set_bit_bitset(&out.valid_, i);
+            edges += get_edgelist_adj_graph(graph, i)->size_;
+            memcpy(out.node_data_ + i * graph->node_element_size_, get_node_adj_graph(graph, i), graph->node_element_size_);
+        }
+    }
+    out.offsets_[graph->nodes_] = edges;
+    out.edges_ = edges;
+    out.destinations_ = (uint32_t*)malloc(edges * sizeof(uint32_t));
+    out.edge_data_ = malloc(edges * graph->edge_element_size_);
+
+    for (size_t i = 0; i < graph->nodes_; ++i)
+    {
+        if (!test_bit_bitset(&out.valid_, i))
+            continue;
+
+        const ordered_map_t* edge_list = get_edgelist_adj_graph(graph, i);
+        size_t offset = out.offsets_[i];
+        span_t destinations;
+        for (size_t j = 0; j < edge_list->size_; j += destinations.count_)
+        {
+            destinations = keys_span_ordered_map(edge_list, j);
+            span_t edges = values_span_ordered_map(edge_list, j);
+            for (size_t k = 0; k < destinations.count_; ++k)
+            {
+                out.destinations_[offset + j + k] = *(const uint32_t*)at_span(&destinations, k);
+                memcpy(out.edge_data_ + (offset + j + k) * graph->edge_element_size_, at_span(&edges, k), graph->edge_element_size_);
+            }
+        }
+    }
+
+    return out;
+}
+
+csr_graph_t transpose_csr_graph(const csr_graph_t* graph)
+{
+    csr_graph_t out;
+
+    out.nodes_ = graph->nodes_;
+    out.edges_ = graph->edges_;
+    out.node_element_size_ = graph->node_element_size_;
+    out.edge_element_size_ = graph->edge_element_size_;
+    out.mapping_ = NULL;
+    out.valid_ = create_bitset(graph->nodes_);
+    memcpy(out.valid_.data_, graph->valid_.data_, words_for_bitset(graph->nodes_) * sizeof(uint64_t));
+    out.offsets_ = (size_t*)calloc(graph->nodes_ + 1, sizeof(size_t));
+    out.destinations_ = (uint32_t*)malloc(graph->edges_ * sizeof(uint32_t));
+    out.edge_data_ = malloc(graph->edges_ * graph->edge_element_size_);
+    out.node_data_ = malloc(graph->nodes_ * graph->node_element_size_);
+    memcpy(out.node_data_, graph->node_data_, graph->nodes_ * graph->node_element_size_);
+
+    /* Counting sort of the edges by destination, the sources are visited in order so every range stays sorted */
+    for (size_t edge = 0; edge < graph->edges_; ++edge)
+        ++out.offsets_[graph->destinations_[edge] + 1];
+    for (size_t i = 0; i < graph->nodes_; ++i)
+        out.offsets_[i + 1] += out.offsets_[i];
+
+    size_t* next = (size_t*)malloc((graph->nodes_ + 1) * sizeof(size_t));
+    memcpy(next, out.offsets_, (graph->nodes_ + 1) * sizeof(size_t));
+    for (size_t i = 0; i < graph->nodes_; ++i)
+    {
+        for (size_t edge = graph->offsets_[i]; edge < graph->offsets_[i + 1]; ++edge)
+        {
+            size_t position = next[graph->destinations_[edge]]++;
+            out.destinations_[position] = (uint32_t)i;
+            memcpy(out.edge_data_ + position * graph->edge_element_size_, edge_at_csr_graph(graph, edge), graph->edge_element_size_);
+        }
+    }
+    free(next);
+
+    return out;
+}
+
+void destroy_csr_graph(csr_graph_t* graph)
+{
+    if (graph->mapping_ != NULL)
+    {
+        /* Only the destinations decoded from a varint block live outside of the mapping */
+        const void* begin = graph->mapping_->base_;
+        if ((const void*)graph->destinations_ < begin || (const void*)graph->destinations_ >= begin + graph->mapping_->length_)
+            free(graph->destinations_);
+        close_mapped_file(graph->mapping_);
+        graph->mapping_ = NULL;
+        graph->valid_.data_ = NULL;
+        graph->valid_.bits_ = 0;
+        graph->valid_.capacity_ = 0;
+    }
+    else
+    {
+        free(graph->offsets_);
+        free(graph->destinations_);
+        free(graph->edge_data_);
+        free(graph->node_data_);
+        destroy_bitset(&graph->valid_);
+    }
+    graph->offsets_ = NULL;
+    graph->destinations_ = NULL;
+    graph->edge_data_ = NULL;
+    graph->node_data_ = NULL;
+    graph->nodes_ = 0;
+    graph->edges_ = 0;
+    graph->node_element_size_ = 0;
+    graph->edge_element_size_ = 0;
+}
+
+void* get_node_csr_graph(const csr_graph_t* graph, uint32_t id)
+{
+    return graph->node_data_ + (size_t)id * graph->node_element_size_;
+}
+
+size_t degree_csr_graph(const csr_graph_t* graph, uint32_t id)
+{
+    return graph->offsets_[id + 1] - graph->offsets_[id];
+}
+
+const uint32_t* neighbors_csr_graph(const csr_graph_t* graph, uint32_t id)
+{
+    return graph->destinations_ + graph->offsets_[id];
+}
+
+void* edge_at_csr_graph(const csr_graph_t* graph, size_t edge)
+{
+    return graph->edge_data_ + edge * graph->edge_element_size_;
+}
+
+void* get_edge_csr_graph(const csr_graph_t* graph, uint32_t source, uint32_t destination)
+{
+    size_t left = graph->offsets_[source];
+    size_t right = graph->offsets_[source + 1];
+
+    while (left < right)
+    {
+        size_t middle = left + (right - left) / 2;
+        if (graph->destinations_[middle] < destination)
+            left = middle + 1;
+        else
+            right = middle;
+    }
+
+    if (left < graph->offsets_[source + 1] && graph->destinations_[left] == destination)
+        return edge_at_csr_graph(graph, left);
+    return NULL;
+}
+
+int is_connected_to_csr(const csr_graph_t* graph, uint32_t source, uint32_t destination)
+{
+    if (is_valid_node_csr(graph, source) && is_valid_node_csr(graph, destination))
+        return get_edge_csr_graph(graph, source, destination) != NULL;
+    return 0;
+}
+
+int is_valid_node_csr(const csr_graph_t* graph, uint32_t id)
+{
+    return id < graph->nodes_ && test_bit_bitset(&graph->valid_, id);
+}
@@ -0,0 +1,159 @@
+#ifndef DATA_CSR_GRAPH_H
+#define DATA_CSR_GRAPH_H
+
+/**
+ * @file csr_graph.h
+ * @author Edwin Solis (esolis6@gatech.edu)
+ * @brief An immutable compressed sparse row (CSR) snapshot of an adjacency graph
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include "adjacency_graph.h"
+#include "bitset.h"
+#include "mapped_file.h"
+
+#include <stdint.h>
+
+/**
+ * @details Implementation
+ * 
+ * A frozen graph stores all the edges of the graph in three contiguous arrays:
+ * offsets_[id] .. offsets_[id + 1] is the range of the edges with the node id as source,
+ * destinations_[i] is the destination node id of the edge i (sorted inside the range of each node),
+ * edge_data_ + i * edge_element_size_ is the data of the edge i.
+ * 
+ * The node data is copied into one contiguous array in id order. The node ids are the same ones of the
+ * adjacency graph it was frozen from, deleted nodes keep their id but have no edges and are not valid.
+ * 
+ * Scanning the neighbors of a node is a sequential read of the destinations array, so a traversal does not
+ * need to jump to a separate allocation for every node.
+ * 
+ */
+
+/**
+ * @brief Struct representing a compressed sparse row graph
+ * 
+ * @var offsets_ array of nodes_ + 1 edge offsets, the edges of node i are in [offsets_[i], offsets_[i + 1])
+ * @var destinations_ array of the destination node id of every edge
+ * @var edge_data_ array of the data of every edge, parallel to destinations_
+ * @var node_data_ array of the data of every node
+ * @var valid_ bitset with the valid nodes of the graph
+ * @var nodes_ number of node ids in the graph
+ * @var edges_ number of edges in the graph
+ * @var node_element_size_ size in bytes of the node's type
+ * @var edge_element_size_ size in bytes of the edge's type
+ * @var mapping_ stores the graph file the arrays point into (see graph_file.h), NULL if they are in the heap
+ */
+typedef struct csr_graph_st
+{
+    size_t* offsets_;
+    uint32_t* destinations_;
+    void* edge_data_;
+    void* node_data_;
+    bitset_t valid_;
+    size_t nodes_;
+    size_t edges_;
+    size_t node_element_size_;
+    size_t edge_element_size_;
+    mapped_file_t* mapping_;
+} csr_graph_t;
+
+/**
+ * @brief Creates an immutable CSR snapshot of the given adjacency graph.
+ *        The snapshot does not reference the adjacency graph, so it can be modified or destroyed afterwards.
+ * 
+ * @param graph graph to be frozen
+ * @return csr_graph_t
+ */
+csr_graph_t freeze_adj_graph(const adjacency_graph_t* graph);
+
+/**
+ * @brief Creates the transpose of the given CSR graph, with every edge reversed and its data copied.
+ *        The edges with a node as destination in the original graph are the ones with the node as source
+ *        in the transpose, sorted by the id of the original source node.
+ * 
+ * @param graph graph to be transposed
+ * @return csr_graph_t
+ */
+csr_graph_t transpose_csr_graph(const csr_graph_t* graph);
+
+/**
+ * @brief Destroys the given instance of the CSR graph and releases its resources.
+ *        A graph mapped from a file unmaps the file.
+ * 
+ * @param graph graph to be destroyed
+ */
+void destroy_csr_graph(csr_graph_t* graph);
+
+/**
+ * @brief Get the address of the node data in the CSR graph
+ * 
+ * @param graph graph where the node will be retrieved
+ * @param id the id of the node
+ * @return void* pointer to the data
+ */
+void* get_node_csr_graph(const csr_graph_t* graph, uint32_t id);
+
+/**
+ * @brief Returns the number of edges with the given node as source
+ * 
+ * @param graph graph where the node belongs
+ * @param id id of the node
+ * @return size_t out degree of the node
+ */
+size_t degree_csr_graph(const csr_graph_t* graph, uint32_t id);
+
+/**
+ * @brief Returns the sorted array of destination ids of the edges with the given node as source.
+ *        The array has degree_csr_graph(graph, id) elements.
+ * 
+ * @param graph graph where the node belongs
+ * @param id id of the source node
+ * @return const uint32_t* pointer to the first destination
+ */
+const uint32_t* neighbors_csr_graph(const csr_graph_t* graph, uint32_t id);
+
+/**
+ * @brief Gets the address of the data of the edge with the given index in the destinations array
+ * 
+ * @param graph graph from which the edge will be retrieved
+ * @param edge index of the edge
+ * @return void* pointer to the edge data
+ */
+void* edge_at_csr_graph(const csr_graph_t* graph, size_t edge);
+
+/**
+ * @brief Gets the address of the edge data of the given connection.
+ *        If there is no such edge, the function returns NULL
+ * 
+ * @param graph graph from which the edge will be retrieved
+ * @param source source node of the directed edge
+ * @param destination destination node of the directed edge
+ * @return void* pointer to the edge data
+ */
+void* get_edge_csr_graph(const csr_graph_t* graph, uint32_t source, uint32_t destination);
+
+/**
+ * @brief Returns if there is an edge between the two nodes.
+ * 
+ * @param graph graph where the nodes belong
+ * @param source id of the source node of the directed edge
+ * @param destination id of the destination of the directed edge
+ * @return 1 if there is an edge, 0 if there is no edge
+ */
+int is_connected_to_csr(const csr_graph_t* graph, uint32_t source, uint32_t destination);
+
+/**
+ * @brief Returns if the given node id belongs to a valid node in the graph
+ * 
+ * @param graph graph where the node is verified in
+ * @param id id of the node
+ * @return 1 if valid, 0 if invalid
+ */
+int is_valid_node_csr(const csr_graph_t* graph, uint32_t id);
+
+#endif /* DATA_CSR_GRAPH_H */
@@ -0,0 +1,411 @@
+#include "dlinked_list.h"
+
+#include <string.h>
+
+static const size_t NODE_HEADER = 2 * sizeof(void*);
+
+static inline void set_dllist_node_prev(dlinked_list_node node, const dlinked_list_node prev)
+{
+    ((void**)node)[0] = prev;
+}
+
+static inline void set_dllist_node_next(dlinked_list_node node, const dlinked_list_node next)
+{
+    ((void**)node)[1] = next;
+}
+
+static dlinked_list_node new_node_dllist(dlinked_list* list, const void* data)
+{
+    dlinked_list_node node = list->pool_ != NULL ? alloc_node_pool(list->pool_) : malloc(NODE_HEADER + list->element_size_);
+    memcpy(get_dllist_node_data(node), data, list->element_size_);
+    return node;
+}
+
+static void delete_node_dllist(dlinked_list* list, dlinked_list_node node)
+{
+    if (list->pool_ != NULL)
+        free_node_pool(list->pool_, node);
+    else
+        free(node);
+}
+
+/* Links the node before the position (NULL links it at the end) */
+static void link_before_dllist(dlinked_list* list, dlinked_list_node position, dlinked_list_node node)
+{
+    dlinked_list_node prev = position != NULL ? get_dllist_node_prev(position) : list->tail_;
+
+    set_dllist_node_prev(node, prev);
+    set_dllist_node_next(node, position);
+
+    if (prev != NULL)
+        set_dllist_node_next(prev, node);
+    else
+        list->head_ = node;
+
+    if (position != NULL)
+        set_dllist_node_prev(position, node);
+    else
+        list->tail_ = node;
+
+    ++list->size_;
+}
+
+static void unlink_dllist(dlinked_list* list, dlinked_list_node node)
+{
+    dlinked_list_node prev = get_dllist_node_prev(node);
+    dlinked_list_node next = get_dllist_node_next(node);
+
+    if (prev != NULL)
+        set_dllist_node_next(prev, next);
+    else
+        list->head_ = next;
+
+    if (next != NULL)
+        set_dllist_node_prev(next, prev);
+    else
+        list->tail_ = prev;
+
+    --list->size_;
+}
+
+/*
+ * Makes the nodes of the other list owned by the allocator of the list, so they can be relinked into it.
+ * Lists that allocate the same way only need to merge their pools, otherwise the elements are copied.
+ */
+static void adopt_nodes_dllist(dlinked_list* list, dlinked_list* other)
+{
+    if ((list->pool_ == NULL) == (other->pool_ == NULL))
+    {
+        if (list->pool_ != NULL)
+            merge_node_pool(list->pool_, other->pool_);
+        return;
+    }
+
+    dlinked_list copy = *list;
+    copy.size_ = 0;
+    copy.head_ = NULL;
+    copy.tail_ = NULL;
+
+    for (dlinked_list_node node = other->head_; node != NULL; node = get_dllist_node_next(node))
+        link_before_dllist(&copy, NULL, new_node_dllist(&copy, get_dllist_node_data(node)));
+
+    clear_dlinked_list(other);
+    other->head_ = copy.head_;
+    other->tail_ = copy.tail_;
+    other->size_ = copy.size_;
+}
+
+static void release_nodes_dllist(dlinked_list* list)
+{
+    list->head_ = NULL;
+    list->tail_ = NULL;
+    list->size_ = 0;
+}
+
+dlinked_list create_dlinked_list(size_t element_size)
+{
+    dlinked_list out;
+
+    out.element_size_ = element_size;
+    out.size_ = 0;
+    out.head_ = NULL;
+    out.tail_ = NULL;
+    out.pool_ = NULL;
+
+    return out;
+}
+
+dlinked_list create_pooled_dlinked_list(size_t element_size)
+{
+    dlinked_list out = create_dlinked_list(element_size);
+
+    out.pool_ = (node_pool_t*)malloc(sizeof(node_pool_t));
+    *out.pool_ = create_node_pool(NODE_HEADER + element_size, 0);
+
+    return out;
+}
+
+void destroy_dlinked_list(dlinked_list* list)
+{
+    clear_dlinked_list(list);
+    if (list->pool_ != NULL)
+    {
+        destroy_node_pool(list->pool_);
+        free(list->pool_);
+        list->pool_ = NULL;
+    }
+    list->element_size_ = 0;
+}
+
+void clear_dlinked_list(dlinked_list* list)
+{
+    if (list->pool_ != NULL)
+    {
+        /* Every node lives in the slabs of the pool, release them at once */
+        clear_node_pool(list->pool_);
+    }
+    else
+    {
+        dlinked_list_node current = list->head_;
+        while (current != NULL)
+        {
+            dlinked_list_node next = get_dllist_node_next(current);
+            free(current);
+            current = next;
+        }
+    }
+    release_nodes_dllist(list);
+}
+
+dlinked_list copy_dlinked_list(const dlinked_list* list)
+{
+    dlinked_list out = list->pool_ != NULL ? create_pooled_dlinked_list(list->element_size_) : create_dlinked_list(list->element_size_);
+
+    for (dlinked_list_node node = list->head_; node != NULL; node = get_dllist_node_next(node))
+        push_back_dlinked_list(&out, get_dllist_node_data(node));
+
+    return out;
+}
+
+void* get_dllist_node_data(const dlinked_list_node node)
+{
+    return node + NODE_HEADER;
+}
+
+dlinked_list_node get_dllist_node_next(const dlinked_list_node node)
+{
+    return ((void* const*)node)[1];
+}
+
+dlinked_list_node get_dllist_node_prev(const dlinked_list_node node)
+{
+    return ((void* const*)node)[0];
+}
+
+dlinked_list_node get_dlinked_list_node(const dlinked_list* list, size_t index)
+{
+    if (index >= list->size_)
+        return NULL;
+
+    dlinked_list_node current;
+    if (index < list->size_ / 2)
+    {
+        current = list->head_;
+        for (size_t i = 0; i < index; ++i)
+            current = get_dllist_node_next(current);
+    }
+    else
+    {
+        current = list->tail_;
+        for (size_t i = list->size_ - 1; i > index; --i)
+            current = get_dllist_node_prev(current);
+    }
+    return current;
+}
+
+void* get_element_dlinked_list(const dlinked_list* list, size_t index)
+{
+    dlinked_list_node node = get_dlinked_list_node(list, index);
+    return node != NULL ? get_dllist_node_data(node) : NULL;
+}
+
+void set_element_dlinked_list(dlinked_list* list, size_t index, const void* data)
+{
+    dlinked_list_node node = get_dlinked_list_node(list, index);
+    if (node != NULL)
+        memcpy(get_dllist_node_data(node), data, list->element_size_);
+}
+
+void* front_dlinked_list(const dlinked_list* list)
+{
+    return list->head_ != NULL ? get_dllist_node_data(list->head_) : NULL;
+}
+
+void* back_dlinked_list(const dlinked_list* list)
+{
+    return list->tail_ != NULL ? get_dllist_node_data(list->tail_) : NULL;
+}
+
+void push_front_dlinked_list(dlinked_list* list, const void* data)
+{
+    link_before_dllist(list, list->head_, new_node_dllist(list, data));
+}
+
+void push_back_dlinked_list(dlinked_list* list, const void* data)
+{
+    link_before_dllist(list, NULL, new_node_dllist(list, data));
+}
+
+void pop_front_dlinked_list(dlinked_list* list, void* data)
+{
+    remove_dlinked_list(list, 0, data);
+}
+
+void pop_back_dlinked_list(dlinked_list* list, void* data)
+{
+    if (list->size_ != 0)
+        remove_dlinked_list(list, list->size_ - 1, data);
+}
+
+void insert_dlinked_list(dlinked_list* list, size_t index, const void* data)
+{
+    if (index > list->size_)
+        return;
+    link_before_dllist(list, get_dlinked_list_node(list, index), new_node_dllist(list, data));
+}
+
+void remove_dlinked_list(dlinked_list* list, size_t index, void* data)
+{
+    dlinked_list_node node = get_dlinked_list_node(list, index);
+    if (node == NULL)
+        return;
+
+    if (data != NULL)
+        memcpy(data, get_dllist_node_data(node), list->element_size_);
+    unlink_dllist(list, node);
+    delete_node_dllist(list, node);
+}
+
+void splice_dlinked_list(dllist_cursor* position, dlinked_list* other)
+{
+    dlinked_list* list = position->list_;
+    if (other->size_ == 0 || other == list)
+        return;
+
+    adopt_nodes_dllist(list, other);
+
+    dlinked_list_node prev = position->node_ != NULL ? get_dllist_node_prev(position->node_) : list->tail_;
+
+    set_dllist_node_prev(other->head_, prev);
+    if (prev != NULL)
+        set_dllist_node_next(prev, other->head_);
+    else
+        list->head_ = other->head_;
+
+    set_dllist_node_next(other->tail_, position->node_);
+    if (position->node_ != NULL)
+        set_dllist_node_prev(position->node_, other->tail_);
+    else
+        list->tail_ = other->tail_;
+
+    list->size_ += other->size_;
+    position->index_ += other->size_;
+    release_nodes_dllist(other);
+}
+
+void merge_dlinked_list(dlinked_list* list, dlinked_list* other, LESS_THAN_FUNC order_func)
+{
+    if (other->size_ == 0 || other == list)
+        return;
+
+    adopt_nodes_dllist(list, other);
+
+    dlinked_list_node current = list->head_;
+    dlinked_list_node incoming = other->head_;
+    size_t remaining = other->size_;
+
+    while (incoming != NULL && current != NULL)
+    {
+        if (order_func(get_dllist_node_data(incoming), get_dllist_node_data(current)))
+        {
+            dlinked_list_node next = get_dllist_node_next(incoming);
+            link_before_dllist(list, current, incoming);
+            incoming = next;
+            --remaining;
+        }
+        else
+        {
+            current = get_dllist_node_next(current);
+        }
+    }
+
+    if (incoming != NULL)
+    {
+        /* The rest of the other list goes after every element of the list */
+        set_dllist_node_prev(incoming, list->tail_);
+        if (list->tail_ != NULL)
+            set_dllist_node_next(list->tail_, incoming);
+        else
+            list->head_ = incoming;
+        list->tail_ = other->tail_;
+        list->size_ += remaining;
+    }
+
+    release_nodes_dllist(other);
+}
+
+dllist_cursor first_dllist_cursor(dlinked_list* list)
+{
+    dllist_cursor out = { list, list->head_, 0 };
+    return out;
+}
+
+dllist_cursor last_dllist_cursor(dlinked_list* list)
+{
+    dllist_cursor out = { list, list->tail_, list->size_ != 0 ? list->size_ - 1 : 0 };
+    return out;
+}
+
+dllist_cursor cursor_at_dlinked_list(dlinked_list* list, size_t index)
+{
+    dllist_cursor out = { list, get_dlinked_list_node(list, index), index < list->size_ ? index : list->size_ };
+    return out;
+}
+
+void next_dllist_cursor(dllist_cursor* cursor)
+{
+    if (cursor->node_ == NULL)
+        return;
+
+    cursor->node_ = get_dllist_node_next(cursor->node_);
+    ++cursor->index_;
+}
+
+void prev_dllist_cursor(dllist_cursor* cursor)
+{
+    if (cursor->node_ == NULL)
+    {
+        cursor->node_ = cursor->list_->tail_;
+        cursor->index_ = cursor->list_->size_ != 0 ? cursor->list_->size_ - 1 : 0;
+    }
+    else if (cursor->node_ == cursor->list_->head_)
+    {
+        cursor->node_ = NULL;
+        cursor->index_ = cursor->list_->size_;
+    }
+    else
+    {
+        cursor->node_ = get_dllist_node_prev(cursor->node_);
+        --cursor->index_;
+    }
+}
+
+int is_end_dllist_cursor(const dllist_cursor* cursor)
+{
+    return cursor->node_ == NULL;
+}
+
+void* get_dllist_cursor(const dllist_cursor* cursor)
+{
+    return cursor->node_ != NULL ? get_dllist_node_data(cursor->node_) : NULL;
+}
+
+void insert_dllist_cursor(dllist_cursor* cursor, const void* data)
+{
+    link_before_dllist(cursor->list_, cursor->node_, new_node_dllist(cursor->list_, data));
+    ++cursor->index_;
+}
+
+void remove_dllist_cursor(dllist_cursor* cursor, void* data)
+{
+    if (cursor->node_ == NULL)
+        return;
+
+    dlinked_list_node node = cursor->node_;
+    cursor->node_ = get_dllist_node_next(node);
+
+    if (data != NULL)
+        memcpy(data, get_dllist_node_data(node), cursor->list_->element_size_);
+    unlink_dllist(cursor->list_, node);
+    delete_node_dllist(cursor->list_, node);
+}
@@ -0,0 +1,301 @@
+#ifndef DATA_DLINKED_LIST_H
+#define DATA_DLINKED_LIST_H
+
+/**
+ * @file dlinked_list.h
+ * @author Edwin Solis (edwinsolisf12@gmail.com)
+ * @brief A type adjustable implementation of a doubly linked list
+ * @version 0.1
+ * @date 2021-11-06
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include "algorithm.h"
+#include "node_pool.h"
+
+#include <stdlib.h>
+
+/**
+ * @details Implementation
+ * 
+ * Every node stores the pointer to the previous node, the pointer to the next node and the data.
+ * The list keeps both ends, so pushing and popping at either end is O(1), and an index based access walks from
+ * the closest end. Sequential access should use a cursor, which keeps its position between steps.
+ * 
+ * Like the linked_list, the nodes can be malloc'ed one by one or drawn from a node pool owned by the list.
+ * Splicing and merging relink the nodes of the other list without copying them when both lists allocate the
+ * same way (the pool of the other list is absorbed). Otherwise the elements are copied into new nodes.
+ * 
+ */
+
+typedef void* dlinked_list_node;
+/*
+struct dlinked_list_node
+{
+    void* prev_;
+    void* next_;
+    char data_[element_size_];
+}
+*/
+
+/**
+ * @brief Struct representing a doubly linked list
+ * 
+ * @var element_size_ stores the size in bytes of the datatype being stored
+ * @var size_ stores the number of elements in the list
+ * @var head_ stores the first node (NULL if empty)
+ * @var tail_ stores the last node (NULL if empty)
+ * @var pool_ stores the pool of the nodes (NULL if every node is malloc'ed on its own)
+ */
+typedef struct data_dlinked_list_st
+{
+    size_t element_size_;
+    size_t size_;
+    dlinked_list_node head_;
+    dlinked_list_node tail_;
+    node_pool_t* pool_;
+} dlinked_list;
+
+/**
+ * @brief Struct representing a position in a doubly linked list
+ * 
+ * @var list_ stores the list being iterated
+ * @var node_ stores the node of the position (NULL past the end)
+ * @var index_ stores the index of the position (size_ past the end)
+ */
+typedef struct data_dllist_cursor_st
+{
+    dlinked_list* list_;
+    dlinked_list_node node_;
+    size_t index_;
+} dllist_cursor;
+
+/**
+ * @brief Create an empty doubly linked list
+ * 
+ * @param element_size size in bytes of the data to be stored
+ * @return dlinked_list 
+ */
+dlinked_list create_dlinked_list(size_t element_size);
+
+/**
+ * @brief Create an empty doubly linked list which nodes are drawn from its own node pool
+ * 
+ * @param element_size size in bytes of the data to be stored
+ * @return dlinked_list 
+ */
+dlinked_list create_pooled_dlinked_list(size_t element_size);
+
+/**
+ * @brief Destroys the given instance of the list and releases all its nodes
+ * 
+ * @param list list to be destroyed
+ */
+void destroy_dlinked_list(dlinked_list* list);
+
+/**
+ * @brief Removes all the elements of the list
+ * 
+ * @param list list to be cleared
+ */
+void clear_dlinked_list(dlinked_list* list);
+
+/**
+ * @brief Creates a copy of the list with the same kind of allocation
+ * 
+ * @param list list to be copied
+ * @return dlinked_list 
+ */
+dlinked_list copy_dlinked_list(const dlinked_list* list);
+
+void* get_dllist_node_data(const dlinked_list_node node);
+dlinked_list_node get_dllist_node_next(const dlinked_list_node node);
+dlinked_list_node get_dllist_node_prev(const dlinked_list_node node);
+
+/**
+ * @brief Returns the node at the given index, walking from the closest end
+ * 
+ * @param list list to be searched
+ * @param index index of the node
+ * @return dlinked_list_node the node, NULL if the index is out of range
+ */
+dlinked_list_node get_dlinked_list_node(const dlinked_list* list, size_t index);
+
+/**
+ * @brief Gets the address of the element at the given index
+ * 
+ * @param list list to be searched
+ * @param index index of the element
+ * @return void* pointer to the data, NULL if the index is out of range
+ */
+void* get_element_dlinked_list(const dlinked_list* list, size_t index);
+
+/**
+ * @brief Sets the element at the given index
+ * 
+ * @param list list to be modified
+ * @param index index of the element
+ * @param data data to be copied
+ */
+void set_element_dlinked_list(dlinked_list* list, size_t index, const void* data);
+
+/**
+ * @brief Gets the address of the first element of the list
+ * 
+ * @param list list to be accessed
+ * @return void* pointer to the data, NULL if the list is empty
+ */
+void* front_dlinked_list(const dlinked_list* list);
+
+/**
+ * @brief Gets the address of the last element of the list
+ * 
+ * @param list list to be accessed
+ * @return void* pointer to the data, NULL if the list is empty
+ */
+void* back_dlinked_list(const dlinked_list* list);
+
+/**
+ * @brief Adds a copy of the data at the start of the list
+ * 
+ * @param list list to be added to
+ * @param data data to be copied
+ */
+void push_front_dlinked_list(dlinked_list* list, const void* data);
+
+/**
+ * @brief Adds a copy of the data at the end of the list
+ * 
+ * @param list list to be added to
+ * @param data data to be copied
+ */
+void push_back_dlinked_list(dlinked_list* list, const void* data);
+
+/**
+ * @brief Removes the first element of the list
+ * 
+ * @param list list to be removed from
+ * @param data pointer where the removed element is copied to (can be NULL)
+ */
+void pop_front_dlinked_list(dlinked_list* list, void* data);
+
+/**
+ * @brief Removes the last element of the list
+ * 
+ * @param list list to be removed from
+ * @param data pointer where the removed element is copied to (can be NULL)
+ */
+void pop_back_dlinked_list(dlinked_list* list, void* data);
+
+/**
+ * @brief Inserts a copy of the data at the given index
+ * 
+ * @param list list to be inserted to
+ * @param index index of the new element (size_ appends it)
+ * @param data data to be copied
+ */
+void insert_dlinked_list(dlinked_list* list, size_t index, const void* data);
+
+/**
+ * @brief Removes the element at the given index
+ * 
+ * @param list list to be removed from
+ * @param index index of the element
+ * @param data pointer where the removed element is copied to (can be NULL)
+ */
+void remove_dlinked_list(dlinked_list* list, size_t index, void* data);
+
+/**
+ * @brief Moves all the elements of the other list before the given position of the list.
+ *        The other list is left empty.
+ * 
+ * @param position position of the list where the elements are inserted (past the end appends them)
+ * @param other list which elements are moved
+ */
+void splice_dlinked_list(dllist_cursor* position, dlinked_list* other);
+
+/**
+ * @brief Merges the elements of the other sorted list into the sorted list, keeping it sorted.
+ *        Equivalent elements of the list stay before the ones of the other list. The other list is left empty.
+ * 
+ * @param list sorted list to be merged into
+ * @param other sorted list which elements are moved
+ * @param order_func pointer to the comparison function
+ */
+void merge_dlinked_list(dlinked_list* list, dlinked_list* other, LESS_THAN_FUNC order_func);
+
+/**
+ * @brief Returns a cursor to the first element of the list
+ * 
+ * @param list list to be iterated
+ * @return dllist_cursor
+ */
+dllist_cursor first_dllist_cursor(dlinked_list* list);
+
+/**
+ * @brief Returns a cursor to the last element of the list
+ * 
+ * @param list list to be iterated
+ * @return dllist_cursor
+ */
+dllist_cursor last_dllist_cursor(dlinked_list* list);
+
+/**
+ * @brief Returns a cursor to the element at the given index, walking from the closest end
+ * 
+ * @param list list to be iterated
+ * @param index index of the element (size_ returns the past the end position)
+ * @return dllist_cursor
+ */
+dllist_cursor cursor_at_dlinked_list(dlinked_list* list, size_t index);
+
+/**
+ * @brief Moves the cursor to the next element. Past the end it stays there
+ * 
+ * @param cursor cursor to be moved
+ */
+void next_dllist_cursor(dllist_cursor* cursor);
+
+/**
+ * @brief Moves the cursor to the previous element. Past the end it moves to the last element,
+ *        and from the first element it moves past the end (like a ring with a past the end sentinel)
+ * 
+ * @param cursor cursor to be moved
+ */
+void prev_dllist_cursor(dllist_cursor* cursor);
+
+/**
+ * @brief Returns 1 if the cursor is past the end of the list, else 0
+ * 
+ * @param cursor cursor to be checked
+ * @return int 
+ */
+int is_end_dllist_cursor(const dllist_cursor* cursor);
+
+/**
+ * @brief Gets the address of the element at the position of the cursor
+ * 
+ * @param cursor cursor of the position
+ * @return void* pointer to the data, NULL past the end
+ */
+void* get_dllist_cursor(const dllist_cursor* cursor);
+
+/**
+ * @brief Inserts a copy of the data before the position of the cursor. The cursor keeps pointing to the same element
+ * 
+ * @param cursor cursor of the position
+ * @param data data to be copied
+ */
+void insert_dllist_cursor(dllist_cursor* cursor, const void* data);
+
+/**
+ * @brief Removes the element at the position of the cursor and moves the cursor to the next element
+ * 
+ * @param cursor cursor of the position
+ * @param data pointer where the removed element is copied to (can be NULL)
+ */
+void remove_dllist_cursor(dllist_cursor* cursor, void* data);
+
+#endif /* DATA_DLINKED_LIST_H */
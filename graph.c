@@ -2,6 +2,42 @@
 
 #include <string.h>
 
+static const size_t BASE_CAPACITY = 8;
+
+static inline size_t words_agraph(size_t nodes)
+{
+    return (nodes + 63) >> 6;
+}
+
+/* Number of data slots of the layout for the given capacity */
+static inline size_t slots_agraph(size_t capacity, int directed)
+{
+    return directed ? capacity * capacity : capacity * (capacity + 1) / 2;
+}
+
+static inline size_t slot_agraph(const array_graph_t* graph, size_t source, size_t destination)
+{
+    if (graph->directed_)
+        return source * graph->capacity_ + destination;
+    if (source < destination)
+    {
+        size_t temp = source;
+        source = destination;
+        destination = temp;
+    }
+    return source * (source + 1) / 2 + destination;
+}
+
+static inline uint64_t* mutable_row_agraph(array_graph_t* graph, size_t id)
+{
+    return graph->edges_ + id * graph->row_words_;
+}
+
+static inline int test_edge_agraph(const array_graph_t* graph, size_t source, size_t destination)
+{
+    return (row_agraph(graph, source)[destination >> 6] >> (destination & 63)) & 1;
+}
+
 array_graph_t create_agraph(size_t total_nodes, size_t element_size, int directed_graph)
 {
     array_graph_t out;
@@ -9,11 +45,10 @@ array_graph_t create_agraph(size_t total_nodes, size_t element_size, int directe
     out.total_nodes_ = total_nodes;
     out.total_edges_ = 0;
     out.element_size_ = element_size;
-    if (directed_graph)
-        out.capacity_ = total_nodes * total_nodes;
-    else
-        out.capacity_ = total_nodes * total_nodes / 2;
-    out.data_ = malloc(element_size * out.capacity_);
+    out.capacity_ = total_nodes;
+    out.row_words_ = words_agraph(total_nodes);
+    out.edges_ = (uint64_t*)calloc(total_nodes * out.row_words_ + 1, sizeof(uint64_t));
+    out.data_ = element_size ? malloc(element_size * slots_agraph(total_nodes, directed_graph)) : NULL;
     out.directed_ = directed_graph;
 
     return out;
@@ -25,51 +60,197 @@ void destroy_agraph(array_graph_t* graph)
     graph->total_edges_ = 0;
     graph->element_size_ = 0;
     graph->capacity_ = 0;
+    graph->row_words_ = 0;
     graph->directed_ = 0;
+    free(graph->edges_);
     free(graph->data_);
+    graph->edges_ = NULL;
     graph->data_ = NULL;
 }
 
 void reuse_agraph(array_graph_t* graph, size_t total_nodes, size_t element_size, int directed_graph)
 {
-    int new_capacity = directed_graph ? (total_nodes * total_nodes) : (total_nodes * total_nodes / 2);
-    if (new_capacity * element_size > graph->capacity_ * graph_->element_size_)
-        resize_agraph(graph, total_nodes)
+    size_t capacity = total_nodes > graph->capacity_ ? total_nodes : graph->capacity_;
+    size_t data_bytes = element_size * slots_agraph(capacity, directed_graph);
+
+    if (element_size == 0)
+    {
+        free(graph->data_);
+        graph->data_ = NULL;
+    }
+    else if (graph->data_ == NULL || data_bytes > graph->element_size_ * slots_agraph(graph->capacity_, graph->directed_))
+        graph->data_ = realloc(graph->data_, data_bytes);
+
+    if (capacity > graph->capacity_)
+    {
+        free(graph->edges_);
+        graph->row_words_ = words_agraph(capacity);
+        graph->edges_ = (uint64_t*)calloc(capacity * graph->row_words_ + 1, sizeof(uint64_t));
+    }
+    else
+        memset(graph->edges_, 0, graph->capacity_ * graph->row_words_ * sizeof(uint64_t));
+
+    graph->total_nodes_ = total_nodes;
+    graph->total_edges_ = 0;
+    graph->element_size_ = element_size;
+    graph->capacity_ = capacity;
+    graph->directed_ = directed_graph;
 }
 
 void reserve_agraph(array_graph_t* graph, size_t capacity)
 {
+    if (capacity <= graph->capacity_)
+        return;
+
+    size_t row_words = words_agraph(capacity);
+    if (row_words != graph->row_words_)
+    {
+        uint64_t* edges = (uint64_t*)calloc(capacity * row_words + 1, sizeof(uint64_t));
+        for (size_t i = 0; i < graph->total_nodes_; ++i)
+            memcpy(edges + i * row_words, row_agraph(graph, i), graph->row_words_ * sizeof(uint64_t));
+        free(graph->edges_);
+        graph->edges_ = edges;
+        graph->row_words_ = row_words;
+    }
+    else
+    {
+        graph->edges_ = (uint64_t*)realloc(graph->edges_, (capacity * row_words + 1) * sizeof(uint64_t));
+        memset(graph->edges_ + graph->capacity_ * row_words, 0, (capacity - graph->capacity_) * row_words * sizeof(uint64_t));
+    }
 
+    if (graph->data_ != NULL)
+    {
+        graph->data_ = realloc(graph->data_, graph->element_size_ * slots_agraph(capacity, graph->directed_));
+
+        /* The rows of a directed graph move to the new stride, from the last one so none is overwritten before it moves */
+        if (graph->directed_)
+        {
+            for (size_t i = graph->total_nodes_; i-- > 1;)
+            {
+                memmove(graph->data_ + i * capacity * graph->element_size_,
+                    graph->data_ + i * graph->capacity_ * graph->element_size_, graph->total_nodes_ * graph->element_size_);
+            }
+        }
+    }
+
+    graph->capacity_ = capacity;
 }
 
 void resize_agraph(array_graph_t* graph, size_t total_nodes)
 {
+    if (total_nodes > graph->capacity_)
+    {
+        size_t next = next_capacity_agraph(graph->capacity_);
+        reserve_agraph(graph, next > total_nodes ? next : total_nodes);
+    }
+
+    if (total_nodes < graph->total_nodes_)
+    {
+        /* Clear the columns and rows of the removed nodes, then count the remaining edges */
+        size_t first_word = total_nodes >> 6;
+        uint64_t keep = (total_nodes & 63) ? ~(~(uint64_t)0 << (total_nodes & 63)) : 0;
+        for (size_t i = 0; i < total_nodes; ++i)
+        {
+            uint64_t* row = mutable_row_agraph(graph, i);
+            if (first_word < graph->row_words_)
+            {
+                row[first_word] &= keep;
+                memset(row + first_word + 1, 0, (graph->row_words_ - first_word - 1) * sizeof(uint64_t));
+            }
+        }
+        memset(mutable_row_agraph(graph, total_nodes), 0, (graph->total_nodes_ - total_nodes) * graph->row_words_ * sizeof(uint64_t));
 
+        size_t bits = 0;
+        size_t loops = 0;
+        for (size_t i = 0; i < total_nodes; ++i)
+        {
+            bits += degree_agraph(graph, i);
+            loops += test_edge_agraph(graph, i, i);
+        }
+        graph->total_edges_ = graph->directed_ ? bits : (bits + loops) / 2;
+    }
+
+    graph->total_nodes_ = total_nodes;
 }
 
 size_t next_capacity_agraph(size_t current_capacity)
 {
+    return current_capacity ? current_capacity * 2 : BASE_CAPACITY;
+}
 
+uint32_t add_node_agraph(array_graph_t* graph)
+{
+    resize_agraph(graph, graph->total_nodes_ + 1);
+    return graph->total_nodes_ - 1;
 }
 
-void set_edge_agraph(array_graph_t* graph, int source_node, int destination_node, const void* value)
+void set_edge_agraph(array_graph_t* graph, uint32_t source_node, uint32_t destination_node, const void* value)
 {
-    if (source_node < graph_->total_nodes_ && destination_node < graph->total_nodes_)
+    if (source_node >= graph->total_nodes_ || destination_node >= graph->total_nodes_)
+        return;
+
+    if (!test_edge_agraph(graph, source_node, destination_node))
     {
-        memcpy(get_edge_agraph(graph, source_node, destination_node), value, graph->element_size_);
+        mutable_row_agraph(graph, source_node)[destination_node >> 6] |= (uint64_t)1 << (destination_node & 63);
+        if (!graph->directed_)
+            mutable_row_agraph(graph, destination_node)[source_node >> 6] |= (uint64_t)1 << (source_node & 63);
+        ++graph->total_edges_;
     }
+
+    if (graph->data_ != NULL)
+        memcpy(graph->data_ + slot_agraph(graph, source_node, destination_node) * graph->element_size_, value, graph->element_size_);
 }
 
-void* get_edge_agraph(array_graph_t* graph, int source_node, int destination_node)
+void* get_edge_agraph(const array_graph_t* graph, uint32_t source_node, uint32_t destination_node)
 {
-    if (source_node >= graph_->total_nodes_ || destination_node >= graph->total_nodes_)
+    if (graph->data_ == NULL || !is_connected_to_agraph(graph, source_node, destination_node))
         return NULL;
-    if (graph_->directed_)
-    {
-        return graph->data_ + (source_node * graph_->total_nodes + destination_node) * graph->element_size_;
-    }
-    else
+    return graph->data_ + slot_agraph(graph, source_node, destination_node) * graph->element_size_;
+}
+
+void remove_edge_agraph(array_graph_t* graph, uint32_t source_node, uint32_t destination_node)
+{
+    if (!is_connected_to_agraph(graph, source_node, destination_node))
+        return;
+
+    mutable_row_agraph(graph, source_node)[destination_node >> 6] &= ~((uint64_t)1 << (destination_node & 63));
+    if (!graph->directed_)
+        mutable_row_agraph(graph, destination_node)[source_node >> 6] &= ~((uint64_t)1 << (source_node & 63));
+    --graph->total_edges_;
+}
+
+int is_connected_to_agraph(const array_graph_t* graph, uint32_t source_node, uint32_t destination_node)
+{
+    if (source_node >= graph->total_nodes_ || destination_node >= graph->total_nodes_)
+        return 0;
+    return test_edge_agraph(graph, source_node, destination_node);
+}
+
+size_t degree_agraph(const array_graph_t* graph, uint32_t id)
+{
+    const uint64_t* row = row_agraph(graph, id);
+    size_t count = 0;
+    for (size_t i = 0; i < graph->row_words_; ++i)
+        count += __builtin_popcountll(row[i]);
+    return count;
+}
+
+uint32_t next_neighbor_agraph(const array_graph_t* graph, uint32_t id, uint32_t from)
+{
+    if (from >= graph->total_nodes_)
+        return UINT32_MAX;
+
+    const uint64_t* row = row_agraph(graph, id);
+    size_t words = words_agraph(graph->total_nodes_);
+    size_t index = from >> 6;
+    uint64_t word = row[index] & (~(uint64_t)0 << (from & 63));
+
+    while (word == 0)
     {
-        return
+        if (++index == words)
+            return UINT32_MAX;
+        word = row[index];
     }
+
+    return (uint32_t)((index << 6) + __builtin_ctzll(word));
 }
@@ -1,27 +1,193 @@
 #ifndef DATA_GRAPH_H
 #define DATA_GRAPH_H
 
-#include <stdio.h>
+/**
+ * @file graph.h
+ * @author Edwin Solis (esolis6@gatech.edu)
+ * @brief Implementation of a dense graph stored as an adjacency matrix
+ * @version 0.1
+ * @date 2021-11-14
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
 
+#include <stdlib.h>
+#include <stdint.h>
+
+/**
+ * @details Implementation
+ * 
+ * The edges are stored as a matrix of bits, one row of row_words_ 64 bit words per node, where the bit d of the
+ * row s is set if there is an edge from s to d. Undirected graphs set both bits of an edge, so the row of a node
+ * always holds all of its neighbors and can be scanned (or combined with other rows) a word at a time.
+ * 
+ * The edge data, if any, is stored in a separate array of slots:
+ * directed graphs use a capacity_ x capacity_ matrix, the edge (s, d) is in the slot s * capacity_ + d;
+ * undirected graphs only store the lower triangle, the edge {s, d} with s >= d is in the slot s * (s + 1) / 2 + d,
+ * which halves the memory and does not move when the capacity grows.
+ * 
+ * Graphs created with an element size of 0 only store the bits (data_ is NULL), one bit per possible edge.
+ * 
+ * The graph is meant for dense graphs of up to a few tens of thousands of nodes, the memory grows with the square
+ * of the capacity.
+ */
+
+/**
+ * @brief Struct representing a dense graph
+ * 
+ * @var total_nodes_ stores the number of nodes in the graph, the ids are [0, total_nodes_)
+ * @var total_edges_ stores the number of edges in the graph (an undirected edge counts once)
+ * @var element_size_ stores the size in bytes of the edge's type, 0 if the edges have no data
+ * @var capacity_ stores the number of nodes that the storage can hold
+ * @var row_words_ stores the number of 64 bit words of every row of the bit matrix
+ * @var edges_ stores the bit matrix of the edges, capacity_ rows of row_words_ words
+ * @var data_ stores the slots of the edge data, NULL if element_size_ is 0
+ * @var directed_ stores 1 if the graph is directed, else 0
+ */
 typedef struct data_array_graph_st
 {
     size_t total_nodes_;
     size_t total_edges_;
     size_t element_size_;
     size_t capacity_;
+    size_t row_words_;
+    uint64_t* edges_;
     void* data_;
     int directed_;
 } array_graph_t;
 
+/**
+ * @brief Create a dense graph object with the given parameters, without edges
+ * 
+ * @param total_nodes number of nodes of the graph
+ * @param element_size size in bytes of the edge's type, 0 to only store the edges as bits
+ * @param directed_graph 1 if the graph is directed, 0 if it is undirected
+ * @return array_graph_t
+ */
 array_graph_t create_agraph(size_t total_nodes, size_t element_size, int directed_graph);
+
+/**
+ * @brief Destroys the given instance of the graph and releases its resources.
+ * 
+ * @param graph graph to be destroyed
+ */
 void destroy_agraph(array_graph_t* graph);
 
+/**
+ * @brief Removes every edge and changes the parameters of the graph, keeping the storage when it is large enough.
+ * 
+ * @param graph graph to be reused
+ * @param total_nodes new number of nodes of the graph
+ * @param element_size new size in bytes of the edge's type, 0 to only store the edges as bits
+ * @param directed_graph 1 if the graph is directed, 0 if it is undirected
+ */
 void reuse_agraph(array_graph_t* graph, size_t total_nodes, size_t element_size, int directed_graph);
+
+/**
+ * @brief Changes the number of nodes of the graph. New nodes have no edges, and the edges of the
+ *        removed nodes (the ids at or past the new count) are removed.
+ * 
+ * @param graph graph to be resized
+ * @param total_nodes new number of nodes
+ */
 void resize_agraph(array_graph_t* graph, size_t total_nodes);
+
+/**
+ * @brief Reserves storage for the given number of nodes, moving the existing edges to the new layout
+ * 
+ * @param graph graph to be reserved
+ * @param capacity number of nodes the storage should hold
+ */
 void reserve_agraph(array_graph_t* graph, size_t capacity);
+
+/**
+ * @brief Returns the next capacity (in nodes) of the graph when it grows
+ * 
+ * @param current_capacity current capacity of the graph
+ * @return size_t next capacity
+ */
 size_t next_capacity_agraph(size_t current_capacity);
 
-void set_edge_agraph(array_graph_t* graph, int source_node, int destination_node, const void* value);
-void* get_edge_agraph(array_graph_t* graph, int source_node, int destination_node);
+/**
+ * @brief Adds a node without edges to the graph
+ * 
+ * @param graph graph to be modified
+ * @return uint32_t id of the new node
+ */
+uint32_t add_node_agraph(array_graph_t* graph);
+
+/**
+ * @brief Adds the edge from the source to the destination node, or updates its data if it already exists.
+ *        Does nothing if one of the nodes is not in the graph.
+ * 
+ * @param graph graph to be modified
+ * @param source_node id of the source node
+ * @param destination_node id of the destination node
+ * @param value pointer to the data of the edge (ignored if the edges have no data)
+ */
+void set_edge_agraph(array_graph_t* graph, uint32_t source_node, uint32_t destination_node, const void* value);
+
+/**
+ * @brief Gets the address of the data of the edge from the source to the destination node
+ * 
+ * @param graph graph to be accessed
+ * @param source_node id of the source node
+ * @param destination_node id of the destination node
+ * @return void* pointer to the data of the edge, NULL if there is no such edge or the edges have no data
+ */
+void* get_edge_agraph(const array_graph_t* graph, uint32_t source_node, uint32_t destination_node);
+
+/**
+ * @brief Removes the edge from the source to the destination node, if it exists
+ * 
+ * @param graph graph to be modified
+ * @param source_node id of the source node
+ * @param destination_node id of the destination node
+ */
+void remove_edge_agraph(array_graph_t* graph, uint32_t source_node, uint32_t destination_node);
+
+/**
+ * @brief Returns if there is an edge from the source to the destination node
+ * 
+ * @param graph graph to be accessed
+ * @param source_node id of the source node
+ * @param destination_node id of the destination node
+ * @return int 1 if they are connected, else 0
+ */
+int is_connected_to_agraph(const array_graph_t* graph, uint32_t source_node, uint32_t destination_node);
+
+/**
+ * @brief Gets the row of the bit matrix of the given node: the bit d of the row_words_ words is set
+ *        if there is an edge from the node to d. Bits past total_nodes_ are always cleared.
+ * 
+ * @param graph graph to be accessed
+ * @param id id of the node
+ * @return const uint64_t* pointer to the first word of the row
+ */
+static inline const uint64_t* row_agraph(const array_graph_t* graph, uint32_t id)
+{
+    return graph->edges_ + (size_t)id * graph->row_words_;
+}
+
+/**
+ * @brief Returns the number of edges leaving the given node (the number of neighbors in an undirected graph)
+ * 
+ * @param graph graph to be accessed
+ * @param id id of the node
+ * @return size_t degree of the node
+ */
+size_t degree_agraph(const array_graph_t* graph, uint32_t id);
+
+/**
+ * @brief Returns the first neighbor of the node with an id at or after the given one, skipping
+ *        a word of the row at a time. Iterate with next_neighbor_agraph(graph, id, neighbor + 1).
+ * 
+ * @param graph graph to be accessed
+ * @param id id of the node
+ * @param from id where the search starts
+ * @return uint32_t id of the neighbor, UINT32_MAX if there are no more neighbors
+ */
+uint32_t next_neighbor_agraph(const array_graph_t* graph, uint32_t id, uint32_t from);
 
 #endif /* DATA_GRAPH_H */
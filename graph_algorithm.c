@@ -1,12 +1,59 @@
 #include "graph_algorithm.h"
 
+#include "array_deque.h"
+#include "bitset.h"
+#include "heap.h"
 #include "stack.h"
-#include "ordered_set.h"
 #include "ordered_map.h"
 
 #include <stdio.h>
+#include <string.h>
 #include <float.h>
 
+/* Initial capacity of the queues of the point-to-point searches, which usually visit a small part of the graph */
+static const size_t BASE_SEARCH_QUEUE = 64;
+
+/*
+ * Returns the run of neighbors of the node that starts at the given index, empty past the last one.
+ * When edges is not NULL it is set to the run of the data of the same edges.
+ * The searches shared by the adjacency and CSR graphs go through it.
+ */
+typedef span_t (*NEIGHBOR_RUN_FUNC)(const void* graph, uint32_t id, size_t index, span_t* edges);
+
+static span_t out_neighbors_adj_graph(const void* graph, uint32_t id, size_t index, span_t* edges)
+{
+    const ordered_map_t* edge_list = get_edgelist_adj_graph((const adjacency_graph_t*)graph, id);
+    if (index >= edge_list->size_)
+        return create_span(NULL, 0, 0);
+    if (edges != NULL)
+        *edges = values_span_ordered_map(edge_list, index);
+    return keys_span_ordered_map(edge_list, index);
+}
+
+static span_t neighbors_run_csr_graph(const void* graph, uint32_t id, size_t index, span_t* edges)
+{
+    const csr_graph_t* csr = (const csr_graph_t*)graph;
+    size_t degree = degree_csr_graph(csr, id);
+    if (index >= degree)
+        return create_span(NULL, 0, 0);
+    if (edges != NULL)
+        *edges = create_span(edge_at_csr_graph(csr, csr->offsets_[id] + index), csr->edge_element_size_, degree - index);
+    return create_span((void*)(neighbors_csr_graph(csr, id) + index), sizeof(uint32_t), degree - index);
+}
+
+/* Returns the data of the node, the heuristic of A* is computed from it */
+typedef const void* (*NODE_DATA_FUNC)(const void* graph, uint32_t id);
+
+static const void* node_data_adj_graph(const void* graph, uint32_t id)
+{
+    return get_node_adj_graph((const adjacency_graph_t*)graph, id);
+}
+
+static const void* node_data_csr_graph(const void* graph, uint32_t id)
+{
+    return get_node_csr_graph((const csr_graph_t*)graph, id);
+}
+
 matrix_t to_matrix_from_adj_graph(const adjacency_graph_t* graph, const void* no_connection_val)
 {
     matrix_t out = create_matrix(graph->edge_element_size_, graph->nodes_, graph->nodes_, NULL);
@@ -17,10 +64,14 @@ matrix_t to_matrix_from_adj_graph(const adjacency_graph_t* graph, const void* no
         if (is_valid_node_adj(graph, i))
         {
             ordered_map_t* map = get_edgelist_adj_graph(graph, i);
-            for (size_t j = 0; j < map->size_; ++j)
+            span_t row = row_span_matrix(&out, i);
+            span_t destinations;
+            for (size_t j = 0; j < map->size_; j += destinations.count_)
             {
-                uint32_t dest = *(uint32_t*)get_key_ordered_map(map, j);
-                set_element_matrix(&out, i, dest, get_edge_adj_graph(graph, i, dest));
+                destinations = keys_span_ordered_map(map, j);
+                span_t edges = values_span_ordered_map(map, j);
+                for (size_t k = 0; k < destinations.count_; ++k)
+                    memcpy(at_span(&row, *(const uint32_t*)at_span(&destinations, k)), at_span(&edges, k), out.element_size_);
             }
         }
     }
@@ -28,189 +79,624 @@ matrix_t to_matrix_from_adj_graph(const adjacency_graph_t* graph, const void* no
     return out;
 }
 
-array_list_t shortest_unweight_adj_graph(const adjacency_graph_t* graph, uint32_t source, uint32_t destination)
+static array_list_t shortest_unweight(const void* graph, size_t nodes, NEIGHBOR_RUN_FUNC neighbors, uint32_t source, uint32_t destination)
 {
-    array_list_t queue = create_array_list(graph->nodes_, sizeof(uint32_t));
-    ordered_set_t visited = create_ordered_set(graph->nodes_, sizeof(uint32_t), index_compare_func);
-    array_list_t previous = create_array_list(graph->nodes_, sizeof(uint32_t));
+    array_deque_t queue = create_array_deque(nodes, sizeof(uint32_t));
+    bitset_t visited = create_bitset(nodes);
+    array_list_t previous = create_array_list(nodes, sizeof(uint32_t));
 
-    resize_array_list(&previous, graph->nodes_);
+    resize_array_list(&previous, nodes);
     fill_array_list(&previous, &INVALID_ADJGRAPH_NODE);
-    push_front_array_list(&queue, &source);
-    insert_element_ordered_set(&visited, &source);
+    push_back_array_deque(&queue, &source);
+    set_bit_bitset(&visited, source);
     while (queue.size_ != 0)
     {
         uint32_t current_node;
-        pop_back_array_list(&queue, &current_node);
+        pop_front_array_deque(&queue, &current_node);
 
         if (current_node == destination)
             break;
 
-        ordered_map_t* edge_list = get_edgelist_adj_graph(graph, current_node);
-        for (size_t i = 0; i < edge_list->size_; ++i)
+        span_t run;
+        for (size_t i = 0; (run = neighbors(graph, current_node, i, NULL)).count_ != 0; i += run.count_)
         {
-            uint32_t adjacent_node = *(uint32_t*)get_key_ordered_map(edge_list, i);
-
-            if (!contains_ordered_set(&visited, &adjacent_node))
+            for (size_t j = 0; j < run.count_; ++j)
             {
-                push_front_array_list(&queue, &adjacent_node);
-                set_element_array_list(&previous, adjacent_node, &current_node);
-                insert_element_ordered_set(&visited, &adjacent_node);
+                uint32_t adjacent_node = *(const uint32_t*)at_span(&run, j);
+
+                if (!test_bit_bitset(&visited, adjacent_node))
+                {
+                    push_back_array_deque(&queue, &adjacent_node);
+                    set_element_array_list(&previous, adjacent_node, &current_node);
+                    set_bit_bitset(&visited, adjacent_node);
+                }
             }
         }
     }
 
-    if (*(uint32_t*)get_element_array_list(&previous, destination) != INVALID_ADJGRAPH_NODE)
+    array_list_t path = path_from_previous_adj_graph(&previous, source, destination);
+
+    destroy_array_deque(&queue);
+    destroy_bitset(&visited);
+    destroy_array_list(&previous);
+
+    return path;
+}
+
+array_list_t shortest_unweight_adj_graph(const adjacency_graph_t* graph, uint32_t source, uint32_t destination)
+{
+    return shortest_unweight(graph, graph->nodes_, out_neighbors_adj_graph, source, destination);
+}
+
+static int distance_compare_func(const void* left, const void* right)
+{
+    return *(const double*)left < *(const double*)right;
+}
+
+static void dijkstra_until(const void* graph, size_t nodes, NEIGHBOR_RUN_FUNC neighbors, uint32_t source, uint32_t destination,
+    EDGE_TO_WEIGHT_FUNC weight_func, array_list_t* distances, array_list_t* previous)
+{
+    indexed_heap queue = create_indexed_heap(nodes, sizeof(double), 4, distance_compare_func);
+    bitset_t settled = create_bitset(nodes);
+
+    const double inf = DBL_MAX;
+    const double zero = 0.0;
+    reserve_array_list(distances, nodes);
+    resize_array_list(distances, nodes);
+    fill_array_list(distances, &inf);
+    set_element_array_list(distances, source, &zero);
+    if (previous != NULL)
     {
-        reuse_array_list(&queue, graph->nodes_, sizeof(uint32_t));
-        uint32_t current = destination;
-        while (current != source)
-        {
-            push_front_array_list(&queue, &current);
-            current = *(uint32_t*)get_element_array_list(&previous, current);
-        }
-        push_front_array_list(&queue, &source);
+        reserve_array_list(previous, nodes);
+        resize_array_list(previous, nodes);
+        fill_array_list(previous, &INVALID_ADJGRAPH_NODE);
     }
-    else
+
+    push_indexed_heap(&queue, source, &zero);
+    while (queue.size_ != 0)
     {
-        destroy_array_list(&queue);
+        uint32_t current_node;
+        double current_distance;
+        pop_root_indexed_heap(&queue, &current_node, &current_distance);
+        set_bit_bitset(&settled, current_node);
+
+        if (current_node == destination)
+            break;
+
+        span_t run;
+        span_t edges;
+        for (size_t i = 0; (run = neighbors(graph, current_node, i, &edges)).count_ != 0; i += run.count_)
+        {
+            for (size_t j = 0; j < run.count_; ++j)
+            {
+                uint32_t adjacent_node = *(const uint32_t*)at_span(&run, j);
+                if (test_bit_bitset(&settled, adjacent_node))
+                    continue;
+
+                double new_distance = current_distance + weight_func(at_span(&edges, j));
+                if (new_distance < *(double*)get_element_array_list(distances, adjacent_node))
+                {
+                    set_element_array_list(distances, adjacent_node, &new_distance);
+                    if (previous != NULL)
+                        set_element_array_list(previous, adjacent_node, &current_node);
+
+                    if (contains_indexed_heap(&queue, adjacent_node))
+                        decrease_key_indexed_heap(&queue, adjacent_node, &new_distance);
+                    else
+                        push_indexed_heap(&queue, adjacent_node, &new_distance);
+                }
+            }
+        }
     }
 
-    destroy_ordered_set(&visited);
-    destroy_array_list(&previous);
+    destroy_indexed_heap(&queue);
+    destroy_bitset(&settled);
+}
 
-    return queue;
+void dijkstra_adj_graph(const adjacency_graph_t* graph, uint32_t source, EDGE_TO_WEIGHT_FUNC weight_func, array_list_t* distances, array_list_t* previous)
+{
+    *distances = create_array_list(graph->nodes_, sizeof(double));
+    if (previous != NULL)
+        *previous = create_array_list(graph->nodes_, sizeof(uint32_t));
+    dijkstra_until(graph, graph->nodes_, out_neighbors_adj_graph, source, INVALID_ADJGRAPH_NODE, weight_func, distances, previous);
 }
 
 array_list_t shortest_adj_graph(const adjacency_graph_t* graph, uint32_t source, uint32_t destination, EDGE_TO_WEIGHT_FUNC weight_func)
 {
-    ordered_set_t visited = create_ordered_set(graph->nodes_, sizeof(uint32_t), index_compare_func);//create_int_oset(node_count);
-    array_list_t distances = create_array_list(graph->nodes_, sizeof(double));//vector_t distances = create_int_vector(node_count, NULL);
+    array_list_t distances = create_array_list(graph->nodes_, sizeof(double));
+    dijkstra_until(graph, graph->nodes_, out_neighbors_adj_graph, source, destination, weight_func, &distances, NULL);
+    return distances;
+}
 
-    resize_array_list(&distances, graph->nodes_);
+array_list_t path_from_previous_adj_graph(const array_list_t* previous, uint32_t source, uint32_t destination)
+{
+    array_list_t path = create_array_list(0, sizeof(uint32_t));
+    if (source != destination && *(uint32_t*)get_element_array_list(previous, destination) == INVALID_ADJGRAPH_NODE)
+        return path;
 
-    const double inf = DBL_MAX;
-    const double zero = 0.0;
-    fill_array_list(&distances, &inf);
-    set_element_array_list(&distances, source, &zero);
+    size_t length = 1;
+    for (uint32_t current = destination; current != source; current = *(uint32_t*)get_element_array_list(previous, current))
+        ++length;
+
+    reserve_array_list(&path, length);
+    resize_array_list(&path, length);
 
-    uint32_t current_node = source;
-    while (!contains_ordered_set(&visited, &destination))
+    uint32_t current = destination;
+    for (size_t i = length; i > 0; --i)
     {
-        double current_distance = *(double*)get_element_array_list(&distances, current_node);//int current_distance = get_int_vector(&distances, current_node);
-        double smallest_node = current_node;
-        double smallest_dist = inf;
+        set_element_array_list(&path, i - 1, &current);
+        current = *(uint32_t*)get_element_array_list(previous, current);
+    }
 
-        ordered_map_t* edge_list = get_edgelist_adj_graph(graph, current_node);
+    return path;
+}
 
-        for (size_t i = 0; i < edge_list->size_; ++i)
-        {
-            uint32_t adjacent_node = *(uint32_t*)get_key_ordered_map(edge_list, i);
-            //if (i == current_node) continue;
-            if (contains_ordered_set(&visited, &adjacent_node)) continue;
-            double node_weight = weight_func(get_edge_adj_graph(graph, current_node, adjacent_node));//get_int_matrix(matrix, current_node, i);
-            //if (node_weight == 0) continue;
+/* One end of a bidirectional search, previous_ and depths_ are only set for the visited nodes */
+typedef struct bfs_side_st
+{
+    const void* graph;
+    NEIGHBOR_RUN_FUNC neighbors;
+    array_deque_t queue;
+    bitset_t visited;
+    uint32_t* previous;
+    uint32_t* depths;
+} bfs_side;
+
+static bfs_side create_bfs_side(size_t nodes, const void* graph, NEIGHBOR_RUN_FUNC neighbors, uint32_t start)
+{
+    bfs_side out;
+
+    out.graph = graph;
+    out.neighbors = neighbors;
+    out.queue = create_array_deque(BASE_SEARCH_QUEUE, sizeof(uint32_t));
+    out.visited = create_bitset(nodes);
+    out.previous = (uint32_t*)malloc(nodes * sizeof(uint32_t));
+    out.depths = (uint32_t*)malloc(nodes * sizeof(uint32_t));
+    push_back_array_deque(&out.queue, &start);
+    set_bit_bitset(&out.visited, start);
+    out.previous[start] = INVALID_ADJGRAPH_NODE;
+    out.depths[start] = 0;
 
-            double node_distance = *(double*)get_element_array_list(&distances, adjacent_node);//int node_distance = get_int_vector(&distances, i);
+    return out;
+}
 
-            double new_distance = current_distance + node_weight;
-            if (new_distance < node_distance)
-                set_element_array_list(&distances, adjacent_node, &new_distance);//set_int_vector(&distances, i, new_distance);
+static void destroy_bfs_side(bfs_side* side)
+{
+    destroy_array_deque(&side->queue);
+    destroy_bitset(&side->visited);
+    free(side->previous);
+    free(side->depths);
+}
 
-            double dist = *(double*)get_element_array_list(&distances, adjacent_node);
-            if (smallest_dist > dist)//if (smallest_dist > get_int_vector(&distances, i))
+/* Expands every node of the current level of the side, keeping the shortest path through a node visited by the other side */
+static void expand_level_bfs_side(bfs_side* side, const bfs_side* other, size_t* best, uint32_t* meeting, path_search_stats_t* stats)
+{
+    for (size_t level = side->queue.size_; level > 0; --level)
+    {
+        uint32_t current_node;
+        pop_front_array_deque(&side->queue, &current_node);
+        ++stats->settled_nodes_;
+
+        span_t run;
+        for (size_t i = 0; (run = side->neighbors(side->graph, current_node, i, NULL)).count_ != 0; i += run.count_)
+        {
+            stats->scanned_edges_ += run.count_;
+            for (size_t j = 0; j < run.count_; ++j)
             {
-                smallest_dist = dist;//smallest_dist = get_int_vector(&distances, i);
-                smallest_node = adjacent_node;//smallest_node = i;
+                uint32_t adjacent_node = *(const uint32_t*)at_span(&run, j);
+                if (test_bit_bitset(&side->visited, adjacent_node))
+                    continue;
+
+                set_bit_bitset(&side->visited, adjacent_node);
+                side->previous[adjacent_node] = current_node;
+                side->depths[adjacent_node] = side->depths[current_node] + 1;
+                push_back_array_deque(&side->queue, &adjacent_node);
+
+                if (test_bit_bitset(&other->visited, adjacent_node) && side->depths[adjacent_node] + other->depths[adjacent_node] < *best)
+                {
+                    *best = side->depths[adjacent_node] + other->depths[adjacent_node];
+                    *meeting = adjacent_node;
+                }
             }
         }
+    }
+}
+
+/*
+ * The level of the side with the smaller frontier is expanded whole before checking for a meeting, as the first
+ * meeting found is not always on a shortest path but the best one of the level is.
+ * Without a backward side the destination stays the only node visited backward.
+ */
+static array_list_t shortest_unweight_bidirectional(size_t nodes, uint32_t source, uint32_t destination, const void* graph,
+    NEIGHBOR_RUN_FUNC forward, const void* reverse, NEIGHBOR_RUN_FUNC backward, path_search_stats_t* stats)
+{
+    path_search_stats_t counters = { 0, 0, DBL_MAX };
+    array_list_t path = create_array_list(0, sizeof(uint32_t));
+    if (source >= nodes || destination >= nodes)
+    {
+        if (stats != NULL)
+            *stats = counters;
+        return path;
+    }
+
+    bfs_side from_source = create_bfs_side(nodes, graph, forward, source);
+    bfs_side from_destination = create_bfs_side(nodes, reverse, backward, destination);
+    size_t best = source == destination ? 0 : SIZE_MAX;
+    uint32_t meeting = source;
+
+    while (best == SIZE_MAX && from_source.queue.size_ != 0 && (backward == NULL || from_destination.queue.size_ != 0))
+    {
+        if (backward != NULL && from_destination.queue.size_ < from_source.queue.size_)
+            expand_level_bfs_side(&from_destination, &from_source, &best, &meeting, &counters);
+        else
+            expand_level_bfs_side(&from_source, &from_destination, &best, &meeting, &counters);
+    }
+
+    if (best != SIZE_MAX)
+    {
+        counters.distance_ = (double)best;
+        reserve_array_list(&path, best + 1);
+        resize_array_list(&path, best + 1);
+
+        uint32_t* ids = (uint32_t*)path.data_;
+        size_t position = from_source.depths[meeting];
+        for (uint32_t current = meeting; current != INVALID_ADJGRAPH_NODE; current = from_source.previous[current])
+            ids[position--] = current;
+        position = from_source.depths[meeting];
+        for (uint32_t current = from_destination.previous[meeting]; current != INVALID_ADJGRAPH_NODE; current = from_destination.previous[current])
+            ids[++position] = current;
+    }
 
-        if (smallest_dist == inf)
+    destroy_bfs_side(&from_source);
+    destroy_bfs_side(&from_destination);
+    if (stats != NULL)
+        *stats = counters;
+
+    return path;
+}
+
+/* The index of incoming edges has no edge data, edges must be NULL */
+static span_t in_neighbors_adj_graph(const void* graph, uint32_t id, size_t index, span_t* edges)
+{
+    (void)edges;
+    const ordered_set_t* sources = get_in_edges_adj_graph((const adjacency_graph_t*)graph, id);
+    return index < sources->size_ ? span_ordered_set(sources, index) : create_span(NULL, 0, 0);
+}
+
+array_list_t shortest_unweight_bidirectional_adj_graph(const adjacency_graph_t* graph, uint32_t source, uint32_t destination,
+    path_search_stats_t* stats)
+{
+    return shortest_unweight_bidirectional(graph->nodes_, source, destination, graph, out_neighbors_adj_graph,
+        graph, graph->in_edges_ != NULL ? in_neighbors_adj_graph : NULL, stats);
+}
+
+static array_list_t astar(const void* graph, size_t nodes, NEIGHBOR_RUN_FUNC neighbors, NODE_DATA_FUNC node_data, uint32_t source,
+    uint32_t destination, EDGE_TO_WEIGHT_FUNC weight_func, NODE_HEURISTIC_FUNC heuristic, path_search_stats_t* stats)
+{
+    path_search_stats_t counters = { 0, 0, DBL_MAX };
+    array_list_t path = create_array_list(0, sizeof(uint32_t));
+    if (source >= nodes || destination >= nodes)
+    {
+        if (stats != NULL)
+            *stats = counters;
+        return path;
+    }
+
+    /* The distances and estimates are only set for the nodes pushed to the queue, the estimates are computed once */
+    indexed_heap queue = create_indexed_heap(nodes, sizeof(double), 4, distance_compare_func);
+    bitset_t settled = create_bitset(nodes);
+    double* distances = (double*)malloc(nodes * sizeof(double));
+    double* estimates = (double*)malloc(nodes * sizeof(double));
+    array_list_t previous = create_array_list(nodes, sizeof(uint32_t));
+    resize_array_list(&previous, nodes);
+    uint32_t* previous_ids = (uint32_t*)previous.data_;
+    const void* target = node_data(graph, destination);
+
+    distances[source] = 0.0;
+    estimates[source] = heuristic(node_data(graph, source), target);
+    push_indexed_heap(&queue, source, &estimates[source]);
+    while (queue.size_ != 0)
+    {
+        uint32_t current_node;
+        double current_key;
+        pop_root_indexed_heap(&queue, &current_node, &current_key);
+        set_bit_bitset(&settled, current_node);
+        ++counters.settled_nodes_;
+
+        if (current_node == destination)
+        {
+            counters.distance_ = distances[destination];
             break;
-        insert_element_ordered_set(&visited, &current_node);
-        current_node = smallest_node;
+        }
+
+        span_t run;
+        span_t edges;
+        for (size_t i = 0; (run = neighbors(graph, current_node, i, &edges)).count_ != 0; i += run.count_)
+        {
+            counters.scanned_edges_ += run.count_;
+            for (size_t j = 0; j < run.count_; ++j)
+            {
+                uint32_t adjacent_node = *(const uint32_t*)at_span(&run, j);
+                if (test_bit_bitset(&settled, adjacent_node))
+                    continue;
+
+                double new_distance = distances[current_node] + weight_func(at_span(&edges, j));
+                int queued = contains_indexed_heap(&queue, adjacent_node);
+                if (queued && new_distance >= distances[adjacent_node])
+                    continue;
+
+                if (!queued)
+                    estimates[adjacent_node] = heuristic(node_data(graph, adjacent_node), target);
+                distances[adjacent_node] = new_distance;
+                previous_ids[adjacent_node] = current_node;
+
+                double key = new_distance + estimates[adjacent_node];
+                if (queued)
+                    decrease_key_indexed_heap(&queue, adjacent_node, &key);
+                else
+                    push_indexed_heap(&queue, adjacent_node, &key);
+            }
+        }
     }
 
-    destroy_ordered_set(&visited);
+    if (counters.distance_ != DBL_MAX)
+    {
+        destroy_array_list(&path);
+        path = path_from_previous_adj_graph(&previous, source, destination);
+    }
 
-    return distances;
+    destroy_indexed_heap(&queue);
+    destroy_bitset(&settled);
+    free(distances);
+    free(estimates);
+    destroy_array_list(&previous);
+    if (stats != NULL)
+        *stats = counters;
+
+    return path;
 }
 
-uint32_t breadthsearch_for_adj_graph(const adjacency_graph_t* graph, uint32_t source, SEARCH_PREDICATE_FUNC predicate)
+array_list_t astar_adj_graph(const adjacency_graph_t* graph, uint32_t source, uint32_t destination, EDGE_TO_WEIGHT_FUNC weight_func,
+    NODE_HEURISTIC_FUNC heuristic, path_search_stats_t* stats)
+{
+    return astar(graph, graph->nodes_, out_neighbors_adj_graph, node_data_adj_graph, source, destination, weight_func, heuristic, stats);
+}
+
+static uint32_t breadthsearch_for(const void* graph, size_t nodes, NEIGHBOR_RUN_FUNC neighbors, NODE_DATA_FUNC node_data, uint32_t source,
+    SEARCH_PREDICATE_FUNC predicate)
 {
-    array_list_t queue = create_array_list(graph->nodes_, sizeof(uint32_t));
-    ordered_set_t visited = create_ordered_set(graph->nodes_, sizeof(uint32_t), index_compare_func);
+    array_deque_t queue = create_array_deque(nodes, sizeof(uint32_t));
+    bitset_t visited = create_bitset(nodes);
     uint32_t out = INVALID_ADJGRAPH_NODE;
 
-    push_front_array_list(&queue, &source);
-    insert_element_ordered_set(&visited, &source);
+    push_back_array_deque(&queue, &source);
+    set_bit_bitset(&visited, source);
 
     while (queue.size_ != 0)
     {
         uint32_t current_node;
-        pop_back_array_list(&queue, &current_node);
+        pop_front_array_deque(&queue, &current_node);
 
-        if (predicate(get_node_adj_graph(graph, current_node)))
+        if (predicate(node_data(graph, current_node)))
         {
             out = current_node;
             break;
         }
 
-        ordered_map_t* edge_list = get_edgelist_adj_graph(graph, current_node);
-        for (size_t i = 0; i < edge_list->size_; ++i)
+        span_t run;
+        for (size_t i = 0; (run = neighbors(graph, current_node, i, NULL)).count_ != 0; i += run.count_)
         {
-            uint32_t adjacent_node = *(uint32_t*)get_key_ordered_map(edge_list, i);
-
-            if (!contains_ordered_set(&visited, &adjacent_node))
+            for (size_t j = 0; j < run.count_; ++j)
             {
-                push_front_array_list(&queue, &adjacent_node);
-                insert_element_ordered_set(&visited, &adjacent_node);
+                uint32_t adjacent_node = *(const uint32_t*)at_span(&run, j);
+
+                if (!test_bit_bitset(&visited, adjacent_node))
+                {
+                    push_back_array_deque(&queue, &adjacent_node);
+                    set_bit_bitset(&visited, adjacent_node);
+                }
             }
         }
     }
 
-    destroy_array_list(&queue);
-    destroy_ordered_set(&visited);
+    destroy_array_deque(&queue);
+    destroy_bitset(&visited);
 
     return out;
 }
 
-uint32_t depthsearch_for_adj_graph(const adjacency_graph_t* graph, uint32_t source, SEARCH_PREDICATE_FUNC predicate)
+static uint32_t depthsearch_for(const void* graph, size_t nodes, NEIGHBOR_RUN_FUNC neighbors, NODE_DATA_FUNC node_data, uint32_t source,
+    SEARCH_PREDICATE_FUNC predicate)
 {
-    array_stack_t stack = create_astack(graph->nodes_, sizeof(uint32_t));
-    ordered_set_t visited = create_ordered_set(graph->nodes_, sizeof(uint32_t), index_compare_func);
+    array_stack_t stack = create_astack(nodes, sizeof(uint32_t));
+    bitset_t visited = create_bitset(nodes);
     uint32_t out = INVALID_ADJGRAPH_NODE;
 
     push_astack(&stack, &source);
-    insert_element_ordered_set(&visited, &source);
+    set_bit_bitset(&visited, source);
 
     while (stack.size_ != 0)
     {
         uint32_t current_node;
         pop_astack(&stack, &current_node);
 
-        if (predicate(get_node_adj_graph(graph, current_node)))
+        if (predicate(node_data(graph, current_node)))
         {
             out = current_node;
             break;
         }
 
-        ordered_map_t* edge_list = get_edgelist_adj_graph(graph, current_node);
-
-        for (size_t i = edge_list->size_; i > 0; --i)
+        size_t first = stack.size_;
+        span_t run;
+        for (size_t i = 0; (run = neighbors(graph, current_node, i, NULL)).count_ != 0; i += run.count_)
         {
-            uint32_t adjacent_node = *(uint32_t*)get_key_ordered_map(edge_list, i - 1);
-
-            if (!contains_ordered_set(&visited, &adjacent_node))
+            for (size_t j = 0; j < run.count_; ++j)
             {
-                push_astack(&stack, &adjacent_node);
-                insert_element_ordered_set(&visited, &adjacent_node);
+                uint32_t adjacent_node = *(const uint32_t*)at_span(&run, j);
+
+                if (!test_bit_bitset(&visited, adjacent_node))
+                {
+                    push_astack(&stack, &adjacent_node);
+                    set_bit_bitset(&visited, adjacent_node);
+                }
             }
         }
+
+        /* The neighbors are pushed in order, reversing them makes the first neighbor the next one popped */
+        uint32_t* pushed = (uint32_t*)stack.data_;
+        for (size_t left = first, right = stack.size_; left + 1 < right; ++left, --right)
+        {
+            uint32_t temp = pushed[left];
+            pushed[left] = pushed[right - 1];
+            pushed[right - 1] = temp;
+        }
     }
 
     destroy_astack(&stack);
-    destroy_ordered_set(&visited);
+    destroy_bitset(&visited);
 
     return out;
-}
\ No newline at end of file
+}
+
+uint32_t breadthsearch_for_adj_graph(const adjacency_graph_t* graph, uint32_t source, SEARCH_PREDICATE_FUNC predicate)
+{
+    return breadthsearch_for(graph, graph->nodes_, out_neighbors_adj_graph, node_data_adj_graph, source, predicate);
+}
+
+uint32_t depthsearch_for_adj_graph(const adjacency_graph_t* graph, uint32_t source, SEARCH_PREDICATE_FUNC predicate)
+{
+    return depthsearch_for(graph, graph->nodes_, out_neighbors_adj_graph, node_data_adj_graph, source, predicate);
+}
+
+array_list_t shortest_unweight_csr_graph(const csr_graph_t* graph, uint32_t source, uint32_t destination)
+{
+    return shortest_unweight(graph, graph->nodes_, neighbors_run_csr_graph, source, destination);
+}
+
+void dijkstra_csr_graph(const csr_graph_t* graph, uint32_t source, EDGE_TO_WEIGHT_FUNC weight_func, array_list_t* distances, array_list_t* previous)
+{
+    *distances = create_array_list(graph->nodes_, sizeof(double));
+    if (previous != NULL)
+        *previous = create_array_list(graph->nodes_, sizeof(uint32_t));
+    dijkstra_until(graph, graph->nodes_, neighbors_run_csr_graph, source, INVALID_ADJGRAPH_NODE, weight_func, distances, previous);
+}
+
+array_list_t shortest_csr_graph(const csr_graph_t* graph, uint32_t source, uint32_t destination, EDGE_TO_WEIGHT_FUNC weight_func)
+{
+    array_list_t distances = create_array_list(graph->nodes_, sizeof(double));
+    dijkstra_until(graph, graph->nodes_, neighbors_run_csr_graph, source, destination, weight_func, &distances, NULL);
+    return distances;
+}
+
+array_list_t shortest_unweight_bidirectional_csr_graph(const csr_graph_t* graph, const csr_graph_t* reverse, uint32_t source,
+    uint32_t destination, path_search_stats_t* stats)
+{
+    return shortest_unweight_bidirectional(graph->nodes_, source, destination, graph, neighbors_run_csr_graph,
+        reverse, reverse != NULL ? neighbors_run_csr_graph : NULL, stats);
+}
+
+array_list_t astar_csr_graph(const csr_graph_t* graph, uint32_t source, uint32_t destination, EDGE_TO_WEIGHT_FUNC weight_func,
+    NODE_HEURISTIC_FUNC heuristic, path_search_stats_t* stats)
+{
+    return astar(graph, graph->nodes_, neighbors_run_csr_graph, node_data_csr_graph, source, destination, weight_func, heuristic, stats);
+}
+
+uint32_t breadthsearch_for_csr_graph(const csr_graph_t* graph, uint32_t source, SEARCH_PREDICATE_FUNC predicate)
+{
+    return breadthsearch_for(graph, graph->nodes_, neighbors_run_csr_graph, node_data_csr_graph, source, predicate);
+}
+
+uint32_t depthsearch_for_csr_graph(const csr_graph_t* graph, uint32_t source, SEARCH_PREDICATE_FUNC predicate)
+{
+    return depthsearch_for(graph, graph->nodes_, neighbors_run_csr_graph, node_data_csr_graph, source, predicate);
+}
+
+void bfs_depths_agraph(const array_graph_t* graph, uint32_t source, array_list_t* depths)
+{
+    const uint32_t unreached = UINT32_MAX;
+    size_t words = (graph->total_nodes_ + 63) >> 6;
+    uint64_t* frontier = (uint64_t*)calloc(words + 1, sizeof(uint64_t));
+    uint64_t* next = (uint64_t*)calloc(words + 1, sizeof(uint64_t));
+    uint64_t* visited = (uint64_t*)calloc(words + 1, sizeof(uint64_t));
+
+    *depths = create_array_list(graph->total_nodes_, sizeof(uint32_t));
+    resize_array_list(depths, graph->total_nodes_);
+    fill_array_list(depths, &unreached);
+
+    if (source < graph->total_nodes_)
+    {
+        uint32_t* out = (uint32_t*)depths->data_;
+        frontier[source >> 6] = (uint64_t)1 << (source & 63);
+        visited[source >> 6] = frontier[source >> 6];
+        out[source] = 0;
+
+        for (uint32_t depth = 1;; ++depth)
+        {
+            memset(next, 0, words * sizeof(uint64_t));
+            for (size_t i = 0; i < words; ++i)
+            {
+                for (uint64_t word = frontier[i]; word != 0; word &= word - 1)
+                {
+                    const uint64_t* row = row_agraph(graph, (uint32_t)((i << 6) + __builtin_ctzll(word)));
+                    for (size_t j = 0; j < words; ++j)
+                        next[j] |= row[j];
+                }
+            }
+
+            int found = 0;
+            for (size_t i = 0; i < words; ++i)
+            {
+                next[i] &= ~visited[i];
+                visited[i] |= next[i];
+                for (uint64_t word = next[i]; word != 0; word &= word - 1)
+                    out[(i << 6) + __builtin_ctzll(word)] = depth;
+                found |= next[i] != 0;
+            }
+            if (!found)
+                break;
+
+            uint64_t* temp = frontier;
+            frontier = next;
+            next = temp;
+        }
+    }
+
+    free(frontier);
+    free(next);
+    free(visited);
+}
+
+static inline int test_row_bit_agraph(const uint64_t* row, uint32_t bit)
+{
+    return (row[bit >> 6] >> (bit & 63)) & 1;
+}
+
+uint64_t count_triangles_agraph(const array_graph_t* graph)
+{
+    uint64_t count = 0;
+
+    for (uint32_t a = 0; a < graph->total_nodes_; ++a)
+    {
+        const uint64_t* row_a = row_agraph(graph, a);
+        /* An undirected triangle a < b < c is only counted from its smallest node and edge */
+        uint32_t first = graph->directed_ ? 0 : a + 1;
+        for (uint32_t b = next_neighbor_agraph(graph, a, first); b != UINT32_MAX; b = next_neighbor_agraph(graph, a, b + 1))
+        {
+            if (b == a)
+                continue;
+
+            const uint64_t* row_b = row_agraph(graph, b);
+            size_t start = graph->directed_ ? 0 : (b + 1) >> 6;
+            uint64_t mask = graph->directed_ ? ~(uint64_t)0 : ~(uint64_t)0 << ((b + 1) & 63);
+            for (size_t i = start; i < graph->row_words_; ++i, mask = ~(uint64_t)0)
+                count += __builtin_popcountll(row_a[i] & row_b[i] & mask);
+
+            /* a and b are not a third node, but self loops put them in both rows */
+            if (graph->directed_)
+                count -= (test_row_bit_agraph(row_a, a) && test_row_bit_agraph(row_b, a))
+                    + (test_row_bit_agraph(row_a, b) && test_row_bit_agraph(row_b, b));
+        }
+    }
+
+    return count;
+}
@@ -13,6 +13,8 @@
  */
 
 #include "adjacency_graph.h"
+#include "csr_graph.h"
+#include "graph.h"
 #include "array_list.h"
 #include "matrix.h"
 
@@ -23,6 +25,30 @@
  */
 typedef double (*EDGE_TO_WEIGHT_FUNC)(const void* edge);
 
+/**
+ * @brief Function signature of the heuristic of an A* search
+ *        Takes in the data of a node and the data of the destination node
+ *        Returns a lower bound of the weight of the shortest path between them. The heuristic must be consistent:
+ *        for every edge (u, v), heuristic(u) <= weight(u, v) + heuristic(v), as a straight line distance is.
+ */
+typedef double (*NODE_HEURISTIC_FUNC)(const void* node, const void* destination);
+
+/**
+ * @brief Work done by a point-to-point search, filled by the functions taking a path_search_stats_t pointer
+ * 
+ * @var settled_nodes_ stores the number of nodes taken out of the frontier and expanded (on both sides of a
+ *      bidirectional search)
+ * @var scanned_edges_ stores the number of edges looked at while expanding them
+ * @var distance_ stores the length of the path found (its number of edges, or its weight in an A* search),
+ *      DBL_MAX if the destination was not reached
+ */
+typedef struct data_path_search_stats_st
+{
+    size_t settled_nodes_;
+    size_t scanned_edges_;
+    double distance_;
+} path_search_stats_t;
+
 /**
  * @brief Transform the given adjacency list graph to a adjacency matrix graph using the given edges.
  * 
@@ -53,17 +79,43 @@ uint32_t breadthsearch_for_adj_graph(const adjacency_graph_t* graph, uint32_t so
 uint32_t depthsearch_for_adj_graph(const adjacency_graph_t* graph, uint32_t source, SEARCH_PREDICATE_FUNC predicate);
 
 /**
- * @brief Returns a list with the shortest weighted path between the given source and destination nodes.
- *        The list includes the id of the nodes to be traveled through (including the source and destination).
+ * @brief Returns a list with the shortest weighted distance from the given source node to every node.
+ *        The search stops as soon as the destination node is settled, so only the distances of the nodes settled
+ *        before it are final. Unreached nodes have a distance of DBL_MAX.
  * 
  * @param graph graph to be traversed
  * @param source id of the source node
  * @param destination id of the destination node
  * @param weight_func pointer to the function transforming the edge data to weighted double values
- * @return array_list_t list with the path
+ * @return array_list_t list of doubles with the distances indexed by node id
  */
 array_list_t shortest_adj_graph(const adjacency_graph_t* graph, uint32_t source, uint32_t destination, EDGE_TO_WEIGHT_FUNC weight_func);
 
+/**
+ * @brief Computes the shortest weighted distances from the given source node to all the nodes in the graph (Dijkstra).
+ *        Uses an indexed 4-ary heap with decrease-key, running in O((V + E) log V). Edge weights must not be negative.
+ *        Unreached nodes have a distance of DBL_MAX and a predecessor of INVALID_ADJGRAPH_NODE.
+ * 
+ * @param graph graph to be traversed
+ * @param source id of the source node
+ * @param weight_func pointer to the function transforming the edge data to weighted double values
+ * @param distances pointer where the created list of doubles with the distances indexed by node id is stored
+ * @param previous pointer where the created list of uint32_t with the predecessor of each node is stored (can be NULL)
+ */
+void dijkstra_adj_graph(const adjacency_graph_t* graph, uint32_t source, EDGE_TO_WEIGHT_FUNC weight_func, array_list_t* distances, array_list_t* previous);
+
+/**
+ * @brief Builds the path from the source node to the destination node out of a list of predecessors.
+ *        The list includes the id of the nodes to be traveled through (including the source and destination).
+ *        If the destination was not reached, the returned list is empty.
+ * 
+ * @param previous list of uint32_t with the predecessor of each node
+ * @param source id of the source node
+ * @param destination id of the destination node
+ * @return array_list_t list with the path
+ */
+array_list_t path_from_previous_adj_graph(const array_list_t* previous, uint32_t source, uint32_t destination);
+
 /**
  * @brief Returns a list with the shortest unweighted (connection) path between the given source and destination nodes.
  *        The list includes the id of the nodes to be traveled through (including the source and destination).
@@ -75,4 +127,146 @@ array_list_t shortest_adj_graph(const adjacency_graph_t* graph, uint32_t source,
  */
 array_list_t shortest_unweight_adj_graph(const adjacency_graph_t* graph, uint32_t source, uint32_t destination);
 
+/**
+ * @brief Returns a list with the shortest unweighted path between the given source and destination nodes, searching
+ *        from both ends at once: a whole level of the smaller frontier is expanded at a time, forward through the
+ *        edge lists and backward through the index of incoming edges, until the two searches meet. Each side only
+ *        goes about half the depth of a search from the source alone, which on large graphs settles a small fraction
+ *        of the nodes. Graphs without the index (see set_in_edge_index_adj_graph) are only searched forward.
+ *        The list includes the source and destination, it is empty if the destination can not be reached.
+ * 
+ * @param graph graph to be traversed
+ * @param source id of the source node
+ * @param destination id of the destination node
+ * @param stats pointer where the work done by the search is stored (can be NULL)
+ * @return array_list_t list with the path
+ */
+array_list_t shortest_unweight_bidirectional_adj_graph(const adjacency_graph_t* graph, uint32_t source, uint32_t destination,
+    path_search_stats_t* stats);
+
+/**
+ * @brief Returns a list with the shortest weighted path between the given source and destination nodes (A*).
+ *        Searches as Dijkstra but settles the nodes in order of distance from the source plus the heuristic
+ *        estimate to the destination, so the nodes away from the destination are rarely expanded.
+ *        Edge weights must not be negative and the heuristic must be consistent, a heuristic returning 0 makes it Dijkstra.
+ *        The list includes the source and destination, it is empty if the destination can not be reached.
+ * 
+ * @param graph graph to be traversed
+ * @param source id of the source node
+ * @param destination id of the destination node
+ * @param weight_func pointer to the function transforming the edge data to weighted double values
+ * @param heuristic pointer to the function estimating the distance from a node to the destination
+ * @param stats pointer where the work done by the search is stored (can be NULL)
+ * @return array_list_t list with the path
+ */
+array_list_t astar_adj_graph(const adjacency_graph_t* graph, uint32_t source, uint32_t destination, EDGE_TO_WEIGHT_FUNC weight_func,
+    NODE_HEURISTIC_FUNC heuristic, path_search_stats_t* stats);
+
+/**
+ * @brief Traverses the frozen graph in breath first search fashion until a node that satisfies the predicate is found.
+ *        If no node is found, it returns INVALID_ADJGRAPH_NODE
+ * @param graph graph to be search in
+ * @param source id of the node where the search starts
+ * @param predicate pointer to the function evaluating the search condition
+ * @return uint32_t id of the found node
+ */
+uint32_t breadthsearch_for_csr_graph(const csr_graph_t* graph, uint32_t source, SEARCH_PREDICATE_FUNC predicate);
+
+/**
+ * @brief Traverses the frozen graph in depth first search fashion until a node that satisfies the predicate is found.
+ *        If no node is found, it returns INVALID_ADJGRAPH_NODE
+ * @param graph graph to be search in
+ * @param source id of the node where the search starts
+ * @param predicate pointer to the function evaluating the search condition
+ * @return uint32_t id of the found node
+ */
+uint32_t depthsearch_for_csr_graph(const csr_graph_t* graph, uint32_t source, SEARCH_PREDICATE_FUNC predicate);
+
+/**
+ * @brief Returns a list with the shortest weighted distance from the given source node to every node of the frozen graph.
+ *        Behaves as shortest_adj_graph.
+ * 
+ * @param graph graph to be traversed
+ * @param source id of the source node
+ * @param destination id of the destination node
+ * @param weight_func pointer to the function transforming the edge data to weighted double values
+ * @return array_list_t list of doubles with the distances indexed by node id
+ */
+array_list_t shortest_csr_graph(const csr_graph_t* graph, uint32_t source, uint32_t destination, EDGE_TO_WEIGHT_FUNC weight_func);
+
+/**
+ * @brief Computes the shortest weighted distances from the given source node to all the nodes in the frozen graph (Dijkstra).
+ *        Behaves as dijkstra_adj_graph.
+ * 
+ * @param graph graph to be traversed
+ * @param source id of the source node
+ * @param weight_func pointer to the function transforming the edge data to weighted double values
+ * @param distances pointer where the created list of doubles with the distances indexed by node id is stored
+ * @param previous pointer where the created list of uint32_t with the predecessor of each node is stored (can be NULL)
+ */
+void dijkstra_csr_graph(const csr_graph_t* graph, uint32_t source, EDGE_TO_WEIGHT_FUNC weight_func, array_list_t* distances, array_list_t* previous);
+
+/**
+ * @brief Returns a list with the shortest unweighted (connection) path between the given source and destination nodes of the frozen graph.
+ *        The list includes the id of the nodes to be traveled through (including the source and destination).
+ * 
+ * @param graph graph to be traversed
+ * @param source id of the source node
+ * @param destination id of the destination node
+ * @return array_list_t list with the path
+ */
+array_list_t shortest_unweight_csr_graph(const csr_graph_t* graph, uint32_t source, uint32_t destination);
+
+/**
+ * @brief Returns a list with the shortest unweighted path between the given source and destination nodes of the
+ *        frozen graph, searching from both ends at once (see shortest_unweight_bidirectional_adj_graph).
+ *        The backward search goes through the transpose of the graph (see transpose_csr_graph).
+ * 
+ * @param graph graph to be traversed
+ * @param reverse transpose of the graph, NULL to only search forward
+ * @param source id of the source node
+ * @param destination id of the destination node
+ * @param stats pointer where the work done by the search is stored (can be NULL)
+ * @return array_list_t list with the path
+ */
+array_list_t shortest_unweight_bidirectional_csr_graph(const csr_graph_t* graph, const csr_graph_t* reverse, uint32_t source,
+    uint32_t destination, path_search_stats_t* stats);
+
+/**
+ * @brief Returns a list with the shortest weighted path between the given source and destination nodes
+ *        of the frozen graph (A*, see astar_adj_graph).
+ * 
+ * @param graph graph to be traversed
+ * @param source id of the source node
+ * @param destination id of the destination node
+ * @param weight_func pointer to the function transforming the edge data to weighted double values
+ * @param heuristic pointer to the function estimating the distance from a node to the destination
+ * @param stats pointer where the work done by the search is stored (can be NULL)
+ * @return array_list_t list with the path
+ */
+array_list_t astar_csr_graph(const csr_graph_t* graph, uint32_t source, uint32_t destination, EDGE_TO_WEIGHT_FUNC weight_func,
+    NODE_HEURISTIC_FUNC heuristic, path_search_stats_t* stats);
+
+/**
+ * @brief Computes the breadth first search depth of every node of the dense graph from the given source node.
+ *        Each level is expanded a word at a time: the rows of the frontier nodes are OR-ed together and the
+ *        visited nodes masked out, so a dense level costs one pass over the rows of its nodes.
+ *        Unreached nodes have a depth of UINT32_MAX.
+ * 
+ * @param graph graph to be traversed
+ * @param source id of the source node
+ * @param depths pointer where the created list of uint32_t with the depth of each node is stored
+ */
+void bfs_depths_agraph(const array_graph_t* graph, uint32_t source, array_list_t* depths);
+
+/**
+ * @brief Counts the triangles of the dense graph by intersecting the rows of the two ends of every edge a word at a time.
+ *        In an undirected graph every set of three connected nodes counts once. In a directed graph every three
+ *        distinct nodes a, b, c with the edges a -> b, a -> c and b -> c count once.
+ * 
+ * @param graph graph to be counted
+ * @return uint64_t number of triangles
+ */
+uint64_t count_triangles_agraph(const array_graph_t* graph);
+
 #endif /* DATA_GRAPH_ALGORITHM_H */
\ No newline at end of file
@@ -0,0 +1,459 @@
+#include "graph_file.h"
+
+#include <string.h>
+#include <sys/mman.h>
+
+_Static_assert(sizeof(graph_file_header_t) == 64, "the graph header must fill one block");
+_Static_assert(sizeof(size_t) == sizeof(uint64_t), "the offset block is used in place as the size_t offsets");
+
+/* "DSGRAPH1" */
+static const uint64_t GRAPH_FILE_MAGIC = 0x3148504152475344ULL;
+
+static const size_t GRAPH_FILE_ALIGNMENT = 64;
+
+/* Positions of the blocks from the start of the bytes after the mapped file header */
+typedef struct data_graph_file_layout_st
+{
+    size_t valid_;
+    size_t nodes_;
+    size_t offsets_;
+    size_t destinations_;
+    size_t edges_;
+    size_t end_;
+} graph_file_layout_t;
+
+static inline size_t align_graph_file(size_t bytes)
+{
+    return (bytes + GRAPH_FILE_ALIGNMENT - 1) & ~(GRAPH_FILE_ALIGNMENT - 1);
+}
+
+static graph_file_layout_t layout_graph_file(const graph_file_header_t* header)
+{
+    graph_file_layout_t out;
+
+    out.valid_ = align_graph_file(sizeof(graph_file_header_t));
+    out.nodes_ = out.valid_ + align_graph_file(words_for_bitset(header->nodes_) * sizeof(uint64_t));
+    out.offsets_ = out.nodes_ + align_graph_file(header->nodes_ * header->node_element_size_);
+    out.destinations_ = out.offsets_ + align_graph_file((header->nodes_ + 1) * sizeof(uint64_t));
+    out.edges_ = out.destinations_ + align_graph_file(header->destination_bytes_);
+    out.end_ = out.edges_ + header->edges_ * header->edge_element_size_;
+
+    return out;
+}
+
+static inline uint64_t zigzag_graph_file(int64_t value)
+{
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static inline int64_t unzigzag_graph_file(uint64_t value)
+{
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+/* Writes the LEB128 encoding of the value to out (when not NULL) and returns its length */
+static inline size_t encode_varint_graph_file(unsigned char* out, uint64_t value)
+{
+    size_t length = 1;
+    for (; value >= 0x80; value >>= 7, ++length)
+    {
+        if (out != NULL)
+            *out++ = (unsigned char)(value | 0x80);
+    }
+    if (out != NULL)
+        *out = (unsigned char)value;
+    return length;
+}
+
+/* Returns the cursor past the varint, NULL if it runs past the end or is longer than 64 bits */
+static inline const unsigned char* decode_varint_graph_file(const unsigned char* cursor, const unsigned char* end, uint64_t* value)
+{
+    uint64_t out = 0;
+    for (int shift = 0; cursor < end && shift < 64; shift += 7)
+    {
+        unsigned char byte = *cursor++;
+        out |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            *value = out;
+            return cursor;
+        }
+    }
+    return NULL;
+}
+
+/* Encodes a run of destinations of the source node, previous is -1 before its first destination */
+static size_t encode_run_graph_file(unsigned char* out, const span_t* run, uint32_t source, int64_t* previous)
+{
+    size_t length = 0;
+    for (size_t i = 0; i < run->count_; ++i)
+    {
+        uint32_t destination = *(const uint32_t*)at_span(run, i);
+        uint64_t value = *previous < 0 ? zigzag_graph_file((int64_t)destination - source) : (uint64_t)(destination - *previous - 1);
+        length += encode_varint_graph_file(out != NULL ? out + length : NULL, value);
+        *previous = destination;
+    }
+    return length;
+}
+
+/* Decodes the next destination of the source node, returns 0 if the block is corrupt or the id is out of range */
+static inline int decode_destination_graph_file(const unsigned char** cursor, const unsigned char* end, uint32_t source, int64_t* previous, uint64_t nodes)
+{
+    uint64_t value;
+    *cursor = decode_varint_graph_file(*cursor, end, &value);
+    if (*cursor == NULL)
+        return 0;
+
+    int64_t destination = *previous < 0 ? (int64_t)source + unzigzag_graph_file(value) : *previous + 1 + (int64_t)value;
+    if (destination < 0 || (uint64_t)destination >= nodes || destination <= *previous)
+        return 0;
+    *previous = destination;
+    return 1;
+}
+
+static inline int is_valid_node_graph_file(const uint64_t* valid, uint64_t id)
+{
+    return (valid[id >> 6] >> (id & 63)) & 1;
+}
+
+static mapped_file_t* create_graph_file(const char* path, const graph_file_header_t* header, graph_file_layout_t* layout)
+{
+    *layout = layout_graph_file(header);
+    mapped_file_t* out = create_mapped_file(path, layout->end_);
+    if (out != NULL)
+        memcpy(data_mapped_file(out), header, sizeof(graph_file_header_t));
+    return out;
+}
+
+static void finish_graph_file(mapped_file_t* file, const graph_file_layout_t* layout)
+{
+    write_header_mapped_file(file, GRAPH_FILE_MAGIC, 1, layout->end_, 0, 1);
+    close_mapped_file(file);
+}
+
+/* Maps the file and checks that its header describes blocks that fit in it */
+static mapped_file_t* open_graph_file(const char* path, graph_file_header_t* header, graph_file_layout_t* layout)
+{
+    mapped_file_t* out = open_mapped_file(path, GRAPH_FILE_MAGIC, 1);
+    if (out == NULL)
+        return NULL;
+
+    size_t bytes = header_mapped_file(out)->count_;
+    if (bytes < sizeof(graph_file_header_t))
+    {
+        close_mapped_file(out);
+        return NULL;
+    }
+    memcpy(header, data_mapped_file(out), sizeof(graph_file_header_t));
+
+    /* Each size is bounded by the file before they are multiplied, so the layout can not overflow */
+    if (header->version_ != GRAPH_FILE_VERSION || header->encoding_ > GRAPH_FILE_RAW_DESTINATIONS
+        || header->nodes_ > bytes || header->nodes_ > UINT32_MAX || header->edges_ > bytes
+        || header->node_element_size_ > bytes || header->edge_element_size_ > bytes || header->destination_bytes_ > bytes
+        || (header->nodes_ && header->node_element_size_ > bytes / header->nodes_)
+        || (header->edges_ && header->edge_element_size_ > bytes / header->edges_)
+        || (header->encoding_ == GRAPH_FILE_RAW_DESTINATIONS && header->destination_bytes_ != header->edges_ * sizeof(uint32_t)))
+    {
+        close_mapped_file(out);
+        return NULL;
+    }
+
+    *layout = layout_graph_file(header);
+    const uint64_t* offsets = data_mapped_file(out) + layout->offsets_;
+    if (layout->end_ > bytes || offsets[0] != 0 || offsets[header->nodes_] != header->edges_)
+    {
+        close_mapped_file(out);
+        return NULL;
+    }
+
+    return out;
+}
+
+int save_adj_graph(const adjacency_graph_t* graph, const char* path, graph_file_encoding_t encoding)
+{
+    graph_file_header_t header = { GRAPH_FILE_VERSION, encoding, graph->nodes_, 0, graph->node_element_size_, graph->edge_element_size_, 0, 0 };
+
+    span_t run;
+    for (size_t i = 0; i < graph->nodes_; ++i)
+    {
+        if (!is_valid_node_adj(graph, i))
+            continue;
+
+        const ordered_map_t* edge_list = get_edgelist_adj_graph(graph, i);
+        header.edges_ += edge_list->size_;
+        if (encoding == GRAPH_FILE_VARINT_DESTINATIONS)
+        {
+            int64_t previous = -1;
+            for (size_t j = 0; j < edge_list->size_; j += run.count_)
+            {
+                run = keys_span_ordered_map(edge_list, j);
+                header.destination_bytes_ += encode_run_graph_file(NULL, &run, i, &previous);
+            }
+        }
+    }
+    if (encoding == GRAPH_FILE_RAW_DESTINATIONS)
+        header.destination_bytes_ = header.edges_ * sizeof(uint32_t);
+
+    graph_file_layout_t layout;
+    mapped_file_t* file = create_graph_file(path, &header, &layout);
+    if (file == NULL)
+        return 0;
+
+    void* data = data_mapped_file(file);
+    uint64_t* valid = (uint64_t*)(data + layout.valid_);
+    uint64_t* offsets = (uint64_t*)(data + layout.offsets_);
+    unsigned char* destinations = (unsigned char*)(data + layout.destinations_);
+    size_t edge = 0;
+
+    for (size_t i = 0; i < graph->nodes_; ++i)
+    {
+        offsets[i] = edge;
+        if (!is_valid_node_adj(graph, i))
+            continue;
+
+        valid[i >> 6] |= (uint64_t)1 << (i & 63);
+        memcpy(data + layout.nodes_ + i * graph->node_element_size_, get_node_adj_graph(graph, i), graph->node_element_size_);
+
+        const ordered_map_t* edge_list = get_edgelist_adj_graph(graph, i);
+        int64_t previous = -1;
+        for (size_t j = 0; j < edge_list->size_; j += run.count_)
+        {
+            run = keys_span_ordered_map(edge_list, j);
+            span_t values = values_span_ordered_map(edge_list, j);
+            if (encoding == GRAPH_FILE_VARINT_DESTINATIONS)
+                destinations += encode_run_graph_file(destinations, &run, i, &previous);
+            for (size_t k = 0; k < run.count_; ++k)
+            {
+                if (encoding == GRAPH_FILE_RAW_DESTINATIONS)
+                    memcpy(destinations + (edge + k) * sizeof(uint32_t), at_span(&run, k), sizeof(uint32_t));
+                memcpy(data + layout.edges_ + (edge + k) * graph->edge_element_size_, at_span(&values, k), graph->edge_element_size_);
+            }
+            edge += run.count_;
+        }
+    }
+    offsets[graph->nodes_] = edge;
+
+    finish_graph_file(file, &layout);
+    return 1;
+}
+
+int save_csr_graph(const csr_graph_t* graph, const char* path, graph_file_encoding_t encoding)
+{
+    graph_file_header_t header = { GRAPH_FILE_VERSION, encoding, graph->nodes_, graph->edges_, graph->node_element_size_, graph->edge_element_size_, 0, 0 };
+
+    if (encoding == GRAPH_FILE_VARINT_DESTINATIONS)
+    {
+        for (size_t i = 0; i < graph->nodes_; ++i)
+        {
+            int64_t previous = -1;
+            span_t run = create_span((void*)neighbors_csr_graph(graph, i), sizeof(uint32_t), degree_csr_graph(graph, i));
+            header.destination_bytes_ += encode_run_graph_file(NULL, &run, i, &previous);
+        }
+    }
+    else
+        header.destination_bytes_ = graph->edges_ * sizeof(uint32_t);
+
+    graph_file_layout_t layout;
+    mapped_file_t* file = create_graph_file(path, &header, &layout);
+    if (file == NULL)
+        return 0;
+
+    void* data = data_mapped_file(file);
+    memcpy(data + layout.valid_, graph->valid_.data_, words_for_bitset(graph->nodes_) * sizeof(uint64_t));
+    memcpy(data + layout.nodes_, graph->node_data_, graph->nodes_ * graph->node_element_size_);
+    memcpy(data + layout.offsets_, graph->offsets_, (graph->nodes_ + 1) * sizeof(uint64_t));
+    /* A graph without edges may have no edge or destination arrays */
+    if (graph->edges_ != 0)
+        memcpy(data + layout.edges_, graph->edge_data_, graph->edges_ * graph->edge_element_size_);
+
+    if (encoding == GRAPH_FILE_VARINT_DESTINATIONS)
+    {
+        unsigned char* destinations = (unsigned char*)(data + layout.destinations_);
+        for (size_t i = 0; i < graph->nodes_; ++i)
+        {
+            int64_t previous = -1;
+            span_t run = create_span((void*)neighbors_csr_graph(graph, i), sizeof(uint32_t), degree_csr_graph(graph, i));
+            destinations += encode_run_graph_file(destinations, &run, i, &previous);
+        }
+    }
+    else if (graph->edges_ != 0)
+        memcpy(data + layout.destinations_, graph->destinations_, graph->edges_ * sizeof(uint32_t));
+
+    finish_graph_file(file, &layout);
+    return 1;
+}
+
+adjacency_graph_t load_adj_graph(const char* path)
+{
+    adjacency_graph_t out;
+
+    out.data_ = NULL;
+    out.capacity_ = 0;
+    out.nodes_ = 0;
+    out.node_element_size_ = 0;
+    out.edge_element_size_ = 0;
+    out.in_edges_ = NULL;
+    /* The free list of a graph that could not be read is in the state of a destroyed list */
+    memset(&out.free_nodes_, 0, sizeof(array_list_t));
+
+    graph_file_header_t header;
+    graph_file_layout_t layout;
+    mapped_file_t* file = open_graph_file(path, &header, &layout);
+    if (file == NULL)
+        return out;
+
+    /* The blocks are read front to back once, so the kernel can read ahead and drop the pages behind */
+    madvise(file->base_, file->length_, MADV_SEQUENTIAL);
+
+    const void* data = data_mapped_file(file);
+    const uint64_t* valid = (const uint64_t*)(data + layout.valid_);
+    const uint64_t* offsets = (const uint64_t*)(data + layout.offsets_);
+    const unsigned char* cursor = (const unsigned char*)(data + layout.destinations_);
+    const unsigned char* end = cursor + header.destination_bytes_;
+    size_t pair_size = sizeof(uint32_t) + header.edge_element_size_;
+
+    out = create_adj_graph(header.nodes_, header.node_element_size_, header.edge_element_size_);
+    for (; out.nodes_ < header.nodes_; ++out.nodes_)
+    {
+        uint32_t id = (uint32_t)out.nodes_;
+        ordered_map_t* edge_list = get_edgelist_adj_graph(&out, id);
+        memcpy(get_node_adj_graph(&out, id), data + layout.nodes_ + id * header.node_element_size_, header.node_element_size_);
+
+        size_t first = offsets[id];
+        size_t degree = offsets[id + 1] - first;
+        if (offsets[id + 1] < first || offsets[id + 1] > header.edges_)
+            break;
+        if (!is_valid_node_graph_file(valid, id))
+        {
+            /* An empty zero capacity edge list marks a deleted node */
+            memset(edge_list, 0, sizeof(ordered_map_t));
+            push_back_array_list(&out.free_nodes_, &id);
+            if (degree != 0)
+                break;
+            continue;
+        }
+
+        init_edgelist_adj_graph(&out, id, degree ? degree : 1);
+
+        int64_t previous = -1;
+        for (; edge_list->size_ < degree; ++edge_list->size_)
+        {
+            size_t edge = first + edge_list->size_;
+            if (header.encoding_ == GRAPH_FILE_VARINT_DESTINATIONS)
+            {
+                if (!decode_destination_graph_file(&cursor, end, id, &previous, header.nodes_))
+                    break;
+            }
+            else
+            {
+                uint32_t destination;
+                memcpy(&destination, cursor + edge * sizeof(uint32_t), sizeof(uint32_t));
+                if (destination >= header.nodes_ || (int64_t)destination <= previous)
+                    break;
+                previous = destination;
+            }
+            if (!is_valid_node_graph_file(valid, (uint64_t)previous))
+                break;
+
+            void* pair = edge_list->data_ + edge_list->size_ * pair_size;
+            *(uint32_t*)pair = (uint32_t)previous;
+            memcpy(pair + sizeof(uint32_t), data + layout.edges_ + edge * header.edge_element_size_, header.edge_element_size_);
+        }
+        if (edge_list->size_ != degree)
+        {
+            ++out.nodes_;
+            break;
+        }
+    }
+
+    close_mapped_file(file);
+    if (out.nodes_ != header.nodes_)
+        destroy_adj_graph(&out);
+    return out;
+}
+
+csr_graph_t open_mapped_csr_graph(const char* path)
+{
+    csr_graph_t out;
+
+    out.offsets_ = NULL;
+    out.destinations_ = NULL;
+    out.edge_data_ = NULL;
+    out.node_data_ = NULL;
+    out.valid_.bits_ = 0;
+    out.valid_.capacity_ = 0;
+    out.valid_.data_ = NULL;
+    out.nodes_ = 0;
+    out.edges_ = 0;
+    out.node_element_size_ = 0;
+    out.edge_element_size_ = 0;
+    out.mapping_ = NULL;
+
+    graph_file_header_t header;
+    graph_file_layout_t layout;
+    mapped_file_t* file = open_graph_file(path, &header, &layout);
+    if (file == NULL)
+        return out;
+
+    void* data = data_mapped_file(file);
+    size_t* offsets = (size_t*)(data + layout.offsets_);
+    const uint64_t* valid = (const uint64_t*)(data + layout.valid_);
+    const unsigned char* cursor = (const unsigned char*)(data + layout.destinations_);
+    const unsigned char* end = cursor + header.destination_bytes_;
+    int raw = header.encoding_ == GRAPH_FILE_RAW_DESTINATIONS;
+
+    /* An empty destination block is left NULL, so destroy_csr_graph can tell decoded destinations by their address */
+    uint32_t* destinations = NULL;
+    if (header.edges_ != 0)
+        destinations = raw ? (uint32_t*)(data + layout.destinations_) : (uint32_t*)malloc(header.edges_ * sizeof(uint32_t));
+
+    /* Raw destinations are used in place, so they get the same checks as the decoded ones before the graph is used */
+    int checked = 1;
+    for (uint32_t i = 0; checked && i < header.nodes_; ++i)
+    {
+        int64_t previous = -1;
+        checked = offsets[i] <= offsets[i + 1] && offsets[i + 1] <= header.edges_
+            && (offsets[i] == offsets[i + 1] || is_valid_node_graph_file(valid, i));
+        for (size_t edge = offsets[i]; checked && edge < offsets[i + 1]; ++edge)
+        {
+            if (raw)
+            {
+                checked = destinations[edge] < header.nodes_ && (int64_t)destinations[edge] > previous;
+                previous = destinations[edge];
+            }
+            else
+            {
+                checked = decode_destination_graph_file(&cursor, end, i, &previous, header.nodes_);
+                destinations[edge] = (uint32_t)previous;
+            }
+            checked = checked && is_valid_node_graph_file(valid, (uint64_t)previous);
+        }
+    }
+    if (!checked)
+    {
+        if (!raw)
+            free(destinations);
+        close_mapped_file(file);
+        return out;
+    }
+
+    out.offsets_ = offsets;
+    out.destinations_ = destinations;
+    out.edge_data_ = data + layout.edges_;
+    out.node_data_ = data + layout.nodes_;
+    out.valid_.bits_ = header.nodes_;
+    out.valid_.capacity_ = words_for_bitset(header.nodes_);
+    out.valid_.data_ = (uint64_t*)(data + layout.valid_);
+    out.nodes_ = header.nodes_;
+    out.edges_ = header.edges_;
+    out.node_element_size_ = header.node_element_size_;
+    out.edge_element_size_ = header.edge_element_size_;
+    out.mapping_ = file;
+
+    return out;
+}
+
+int verify_mapped_csr_graph(const csr_graph_t* graph)
+{
+    return graph->mapping_ != NULL && verify_mapped_file(graph->mapping_);
+}
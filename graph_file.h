@@ -0,0 +1,132 @@
+#ifndef DATA_GRAPH_FILE_H
+#define DATA_GRAPH_FILE_H
+
+/**
+ * @file graph_file.h
+ * @author Edwin Solis (esolis6@gatech.edu)
+ * @brief Binary files holding an adjacency graph or a CSR graph
+ * @version 0.1
+ * @date 2021-11-13
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include "adjacency_graph.h"
+#include "csr_graph.h"
+#include "mapped_file.h"
+
+#include <stdint.h>
+
+/**
+ * @details Format
+ * 
+ * A graph file is a mapped file (see mapped_file.h) with the magic "DSGRAPH1", an element size of 1 and a count of
+ * the bytes of the graph, so the checksum of the header covers the whole graph. The bytes after the header are:
+ * 
+ *     graph_file_header_t    version, destination encoding, counts and element sizes
+ *     valid block            words_for_bitset(nodes_) 64 bit words, the bit of every valid node is set
+ *     node block             nodes_ * node_element_size_ bytes, the data of every node in id order
+ *     offset block           nodes_ + 1 64 bit edge offsets, the edges of node i are [offsets[i], offsets[i + 1])
+ *     destination block      the destination of every edge, sorted inside the range of each node
+ *     edge block             edges_ * edge_element_size_ bytes, the data of every edge parallel to the destinations
+ * 
+ * Every block starts on a 64 byte boundary of the file, so the blocks of a mapped file can be used in place.
+ * 
+ * With GRAPH_FILE_VARINT_DESTINATIONS the destinations of every node are written as LEB128 varints: the first one
+ * as the zigzag encoded distance to the source id, the next ones as the distance to the previous destination
+ * minus one. Graphs whose edges connect nearby ids take one or two bytes per edge instead of four.
+ * With GRAPH_FILE_RAW_DESTINATIONS they are written as 32 bit ids, so a mapped graph uses every block in place.
+ * 
+ * The numbers are written in the byte order of the machine, the files are meant to be read on the same platform.
+ */
+
+/**
+ * @brief Version of the format written by the save functions, files with other versions are rejected
+ */
+#define GRAPH_FILE_VERSION 1
+
+/**
+ * @brief Encodings of the destination block of a graph file
+ */
+typedef enum data_graph_file_encoding_en
+{
+    GRAPH_FILE_VARINT_DESTINATIONS,
+    GRAPH_FILE_RAW_DESTINATIONS
+} graph_file_encoding_t;
+
+/**
+ * @brief Header stored at the start of the bytes of a graph file
+ * 
+ * @var version_ stores the version of the format, GRAPH_FILE_VERSION
+ * @var encoding_ stores the encoding of the destination block, a graph_file_encoding_t
+ * @var nodes_ stores the number of node ids
+ * @var edges_ stores the number of edges
+ * @var node_element_size_ stores the size in bytes of the node's type
+ * @var edge_element_size_ stores the size in bytes of the edge's type
+ * @var destination_bytes_ stores the size in bytes of the destination block
+ */
+typedef struct data_graph_file_header_st
+{
+    uint64_t version_;
+    uint64_t encoding_;
+    uint64_t nodes_;
+    uint64_t edges_;
+    uint64_t node_element_size_;
+    uint64_t edge_element_size_;
+    uint64_t destination_bytes_;
+    uint64_t reserved_;
+} graph_file_header_t;
+
+/**
+ * @brief Writes the given graph to a graph file at the given path, replacing any existing file.
+ *        The file is sized exactly before it is written, and is flushed to the disk before returning.
+ * 
+ * @param graph graph to be written
+ * @param path path of the file
+ * @param encoding encoding of the destination block
+ * @return int 1 if the file was written, 0 if it could not be created
+ */
+int save_adj_graph(const adjacency_graph_t* graph, const char* path, graph_file_encoding_t encoding);
+
+/**
+ * @brief Writes the given CSR graph to a graph file at the given path, replacing any existing file.
+ * 
+ * @param graph graph to be written
+ * @param path path of the file
+ * @param encoding encoding of the destination block
+ * @return int 1 if the file was written, 0 if it could not be created
+ */
+int save_csr_graph(const csr_graph_t* graph, const char* path, graph_file_encoding_t encoding);
+
+/**
+ * @brief Reads the graph file at the given path into a new adjacency graph.
+ *        The file is read once from start to end, and the node array and every edge list are allocated with
+ *        their exact final size. The checksum is not verified, but the offsets and destinations are: a file with
+ *        an edge to an id out of range or to a deleted node is rejected.
+ * 
+ * @param path path of the file
+ * @return adjacency_graph_t the graph, with a NULL data_ if the file could not be read or is not a valid graph file
+ */
+adjacency_graph_t load_adj_graph(const char* path);
+
+/**
+ * @brief Maps the graph file at the given path read-only as a CSR graph. The node, edge, offset and valid blocks are
+ *        used in place, only varint destinations are decoded into an array. The graph must not be modified, and
+ *        destroy_csr_graph unmaps the file. The checksum is not verified, but every offset and destination is checked
+ *        once as in load_adj_graph, raw destinations included, before the graph is returned.
+ * 
+ * @param path path of the file
+ * @return csr_graph_t the graph, with a NULL mapping_ if the file could not be mapped or is not a valid graph file
+ */
+csr_graph_t open_mapped_csr_graph(const char* path);
+
+/**
+ * @brief Returns if the checksum of the file of a mapped CSR graph matches its contents
+ * 
+ * @param graph graph to be checked
+ * @return int 1 if it matches, 0 if it does not or the graph is not mapped
+ */
+int verify_mapped_csr_graph(const csr_graph_t* graph);
+
+#endif /* DATA_GRAPH_FILE_H */
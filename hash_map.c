@@ -0,0 +1,394 @@
+#include "hash_map.h"
+
+#include <string.h>
+
+static const size_t BASE_CAPACITY = 8;
+static const uint8_t MAX_DISTANCE = UINT8_MAX;
+
+static size_t slots_for_hash_map(size_t elements)
+{
+    size_t needed = elements + elements / 7 + 1;
+    size_t slots = BASE_CAPACITY;
+    while (slots < needed)
+        slots *= 2;
+    return slots;
+}
+
+static size_t log2_hash_map(size_t slots)
+{
+    size_t count = 0;
+    while (slots > 1)
+    {
+        slots >>= 1;
+        ++count;
+    }
+    return count;
+}
+
+static size_t max_load_hash_map(size_t slots)
+{
+    return slots - slots / 8;
+}
+
+static inline size_t slot_size_hash_map(const hash_map_t* map)
+{
+    return map->key_size_ + map->value_size_;
+}
+
+static inline void* slot_hash_map(const hash_map_t* map, size_t slot)
+{
+    return map->data_ + slot * slot_size_hash_map(map);
+}
+
+static inline uint64_t mix_uint64(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= key >> 33;
+    return key;
+}
+
+static inline uint64_t hash_key_hash_map(const hash_map_t* map, const void* key)
+{
+    if (map->hash_func_ != NULL)
+        return map->hash_func_(key);
+    if (map->key_size_ == sizeof(uint32_t))
+    {
+        uint32_t value;
+        memcpy(&value, key, sizeof(uint32_t));
+        return mix_uint64(value);
+    }
+    if (map->key_size_ == sizeof(uint64_t))
+    {
+        uint64_t value;
+        memcpy(&value, key, sizeof(uint64_t));
+        return mix_uint64(value);
+    }
+    return hash_bytes(key, map->key_size_);
+}
+
+static inline int keys_equal_hash_map(const hash_map_t* map, const void* left, const void* right)
+{
+    if (map->equal_func_ != NULL)
+        return map->equal_func_(left, right);
+    if (map->key_size_ == sizeof(uint32_t))
+    {
+        uint32_t l, r;
+        memcpy(&l, left, sizeof(uint32_t));
+        memcpy(&r, right, sizeof(uint32_t));
+        return l == r;
+    }
+    if (map->key_size_ == sizeof(uint64_t))
+    {
+        uint64_t l, r;
+        memcpy(&l, left, sizeof(uint64_t));
+        memcpy(&r, right, sizeof(uint64_t));
+        return l == r;
+    }
+    return memcmp(left, right, map->key_size_) == 0;
+}
+
+static inline size_t home_slot_hash_map(const hash_map_t* map, uint64_t hash)
+{
+    return (size_t)((hash * 0x9E3779B97F4A7C15ULL) >> map->shift_);
+}
+
+/* Control byte of an entry at the given probe distance (+ 1), MAX_DISTANCE stands for any larger distance too */
+static inline uint8_t control_hash_map(size_t distance)
+{
+    return distance < MAX_DISTANCE ? (uint8_t)distance : MAX_DISTANCE;
+}
+
+/* Exact probe distance (+ 1) of the entry in the slot, recomputed from its hash */
+static inline size_t distance_hash_map(const hash_map_t* map, size_t slot)
+{
+    size_t home = home_slot_hash_map(map, hash_key_hash_map(map, slot_hash_map(map, slot)));
+    return ((slot - home) & (map->capacity_ - 1)) + 1;
+}
+
+/*
+ * Probe distance (+ 1) of the entry in the slot, exact whenever it matters against a probe at the given distance.
+ * A saturated control byte is only resolved from the hash once the probe itself is at MAX_DISTANCE or further.
+ */
+static inline size_t resident_distance_hash_map(const hash_map_t* map, size_t slot, size_t distance)
+{
+    size_t resident = map->control_[slot];
+    if (resident == MAX_DISTANCE && distance >= MAX_DISTANCE)
+        resident = distance_hash_map(map, slot);
+    return resident;
+}
+
+static size_t find_slot_hash_map(const hash_map_t* map, const void* key)
+{
+    if (map->size_ == 0)
+        return SIZE_MAX;
+
+    size_t mask = map->capacity_ - 1;
+    size_t slot = home_slot_hash_map(map, hash_key_hash_map(map, key));
+
+    /* The search stops at an empty slot or an entry closer to its home than the key would be */
+    for (size_t distance = 1; map->control_[slot] != 0; ++distance)
+    {
+        size_t resident = resident_distance_hash_map(map, slot, distance);
+        if (resident < distance)
+            break;
+        if (resident == distance && keys_equal_hash_map(map, slot_hash_map(map, slot), key))
+            return slot;
+        slot = (slot + 1) & mask;
+    }
+    return SIZE_MAX;
+}
+
+/* Places the entry (key + value bytes) in scratch_ without checking for duplicates */
+static void place_entry_hash_map(hash_map_t* map)
+{
+    size_t slot_size = slot_size_hash_map(map);
+    void* entry = map->scratch_;
+    void* temp = map->scratch_ + slot_size;
+    size_t mask = map->capacity_ - 1;
+    size_t slot = home_slot_hash_map(map, hash_key_hash_map(map, entry));
+    size_t distance = 1;
+
+    /*
+     * Many keys with the same hash (a weak user hash) make probe sequences longer than MAX_DISTANCE. Those entries
+     * are still displaced by their exact distance, so the probe order stays the same as with an exact control array
+     * and the table only grows with its load: a weak hash is slower but never makes the table grow without bound.
+     */
+    while (map->control_[slot] != 0)
+    {
+        size_t resident = resident_distance_hash_map(map, slot, distance);
+        if (resident < distance)
+        {
+            map->control_[slot] = control_hash_map(distance);
+            distance = resident;
+
+            memcpy(temp, slot_hash_map(map, slot), slot_size);
+            memcpy(slot_hash_map(map, slot), entry, slot_size);
+            memcpy(entry, temp, slot_size);
+        }
+
+        slot = (slot + 1) & mask;
+        ++distance;
+    }
+
+    map->control_[slot] = control_hash_map(distance);
+    memcpy(slot_hash_map(map, slot), entry, slot_size);
+}
+
+static void rehash_hash_map(hash_map_t* map, size_t slots)
+{
+    size_t old_capacity = map->capacity_;
+    uint8_t* old_control = map->control_;
+    void* old_data = map->data_;
+    size_t slot_size = slot_size_hash_map(map);
+
+    map->capacity_ = slots;
+    map->shift_ = 64 - log2_hash_map(slots);
+    map->control_ = (uint8_t*)calloc(slots, sizeof(uint8_t));
+    map->data_ = malloc(slots * slot_size);
+
+    for (size_t i = 0; i < old_capacity; ++i)
+    {
+        if (old_control[i] != 0)
+        {
+            memcpy(map->scratch_, old_data + i * slot_size, slot_size);
+            place_entry_hash_map(map);
+        }
+    }
+
+    free(old_control);
+    free(old_data);
+}
+
+static void remove_slot_hash_map(hash_map_t* map, size_t slot)
+{
+    size_t slot_size = slot_size_hash_map(map);
+    size_t mask = map->capacity_ - 1;
+    size_t next = (slot + 1) & mask;
+
+    while (map->control_[next] > 1)
+    {
+        if (map->control_[next] == MAX_DISTANCE)
+            map->control_[slot] = control_hash_map(distance_hash_map(map, next) - 1);
+        else
+            map->control_[slot] = map->control_[next] - 1;
+        memcpy(slot_hash_map(map, slot), slot_hash_map(map, next), slot_size);
+        slot = next;
+        next = (next + 1) & mask;
+    }
+    map->control_[slot] = 0;
+    --map->size_;
+}
+
+hash_map_t create_hash_map(size_t key_size, size_t value_size, size_t capacity, HASH_FUNC hash_function, EQUALS_FUNC equal_function)
+{
+    hash_map_t out;
+
+    out.size_ = 0;
+    out.key_size_ = key_size;
+    out.value_size_ = value_size;
+    out.capacity_ = slots_for_hash_map(capacity);
+    out.shift_ = 64 - log2_hash_map(out.capacity_);
+    out.control_ = (uint8_t*)calloc(out.capacity_, sizeof(uint8_t));
+    out.data_ = malloc(out.capacity_ * (key_size + value_size));
+    out.scratch_ = malloc(2 * (key_size + value_size));
+    out.hash_func_ = hash_function;
+    out.equal_func_ = equal_function;
+
+    return out;
+}
+
+void destroy_hash_map(hash_map_t* map)
+{
+    map->size_ = 0;
+    map->capacity_ = 0;
+    map->key_size_ = 0;
+    map->value_size_ = 0;
+    map->shift_ = 0;
+    map->hash_func_ = NULL;
+    map->equal_func_ = NULL;
+    free(map->control_);
+    free(map->data_);
+    free(map->scratch_);
+    map->control_ = NULL;
+    map->data_ = NULL;
+    map->scratch_ = NULL;
+}
+
+void reserve_hash_map(hash_map_t* map, size_t new_capacity)
+{
+    if (new_capacity > max_load_hash_map(map->capacity_))
+        rehash_hash_map(map, slots_for_hash_map(new_capacity));
+}
+
+void reuse_hash_map(hash_map_t* map, size_t key_size, size_t value_size, size_t capacity, HASH_FUNC hash_function, EQUALS_FUNC equal_function)
+{
+    size_t slots = slots_for_hash_map(capacity);
+    if (slots * (key_size + value_size) > map->capacity_ * (map->key_size_ + map->value_size_))
+        map->data_ = realloc(map->data_, slots * (key_size + value_size));
+    if (key_size + value_size > map->key_size_ + map->value_size_)
+        map->scratch_ = realloc(map->scratch_, 2 * (key_size + value_size));
+    if (slots > map->capacity_)
+        map->control_ = (uint8_t*)realloc(map->control_, slots * sizeof(uint8_t));
+    memset(map->control_, 0, slots * sizeof(uint8_t));
+
+    map->size_ = 0;
+    map->capacity_ = slots;
+    map->shift_ = 64 - log2_hash_map(slots);
+    map->key_size_ = key_size;
+    map->value_size_ = value_size;
+    map->hash_func_ = hash_function;
+    map->equal_func_ = equal_function;
+}
+
+size_t next_capacity_hash_map(size_t capacity)
+{
+    return capacity ? capacity * 2 : BASE_CAPACITY;
+}
+
+void clear_hash_map(hash_map_t* map)
+{
+    memset(map->control_, 0, map->capacity_ * sizeof(uint8_t));
+    map->size_ = 0;
+}
+
+void* get_hash_map(const hash_map_t* map, const void* key)
+{
+    size_t slot = find_slot_hash_map(map, key);
+    return slot != SIZE_MAX ? slot_hash_map(map, slot) + map->key_size_ : NULL;
+}
+
+void set_hash_map(hash_map_t* map, const void* key, const void* data)
+{
+    void* pos = get_hash_map(map, key);
+    if (pos != NULL)
+        memcpy(pos, data, map->value_size_);
+}
+
+const void* find_hash_map(const hash_map_t* map, const void* key)
+{
+    size_t slot = find_slot_hash_map(map, key);
+    return slot != SIZE_MAX ? slot_hash_map(map, slot) : NULL;
+}
+
+void insert_pair_hash_map(hash_map_t* map, const void* key, const void* value)
+{
+    if (find_slot_hash_map(map, key) != SIZE_MAX)
+        return;
+
+    if (map->size_ + 1 > max_load_hash_map(map->capacity_))
+        rehash_hash_map(map, next_capacity_hash_map(map->capacity_));
+
+    memcpy(map->scratch_, key, map->key_size_);
+    memcpy(map->scratch_ + map->key_size_, value, map->value_size_);
+    place_entry_hash_map(map);
+    ++map->size_;
+}
+
+void remove_pair_hash_map(hash_map_t* map, const void* key)
+{
+    size_t slot = find_slot_hash_map(map, key);
+    if (slot != SIZE_MAX)
+        remove_slot_hash_map(map, slot);
+}
+
+void extract_pair_hash_map(hash_map_t* map, const void* key, void* value)
+{
+    size_t slot = find_slot_hash_map(map, key);
+    if (slot != SIZE_MAX)
+    {
+        memcpy(value, slot_hash_map(map, slot) + map->key_size_, map->value_size_);
+        remove_slot_hash_map(map, slot);
+    }
+}
+
+int contains_hash_map(const hash_map_t* map, const void* key)
+{
+    return find_slot_hash_map(map, key) != SIZE_MAX;
+}
+
+size_t next_slot_hash_map(const hash_map_t* map, size_t slot)
+{
+    for (; slot < map->capacity_; ++slot)
+    {
+        if (map->control_[slot] != 0)
+            return slot;
+    }
+    return SIZE_MAX;
+}
+
+const void* get_key_hash_map(const hash_map_t* map, size_t slot)
+{
+    if (slot < map->capacity_ && map->control_[slot] != 0)
+        return slot_hash_map(map, slot);
+    return NULL;
+}
+
+void* at_slot_hash_map(const hash_map_t* map, size_t slot)
+{
+    if (slot < map->capacity_ && map->control_[slot] != 0)
+        return slot_hash_map(map, slot) + map->key_size_;
+    return NULL;
+}
+
+size_t hash_uint32_func(const void* key)
+{
+    return mix_uint64(*(const uint32_t*)key);
+}
+
+size_t hash_uint64_func(const void* key)
+{
+    return mix_uint64(*(const uint64_t*)key);
+}
+
+size_t hash_bytes(const void* data, size_t size)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
@@ -0,0 +1,250 @@
+#ifndef DATA_HASH_MAP_H
+#define DATA_HASH_MAP_H
+
+/**
+ * @file hash_map.h
+ * @author Edwin Solis (edwinsolisf12@gmail.com)
+ * @brief A type adjustable implementation of an open addressing hash map
+ * @version 0.1
+ * @date 2021-10-28
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include "algorithm.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+
+/**
+ * @details Implementation
+ * 
+ * The map is an open addressing table with linear probing and Robin Hood insertion: while probing, an entry
+ * that is further away from its home slot takes the place of an entry that is closer to its own home slot.
+ * That keeps the probe sequences short and allows lookups to stop as soon as they reach an entry closer to its
+ * home than the searched key would be. Removal shifts the following entries back instead of leaving tombstones.
+ * 
+ * The slots store the key bytes immediately followed by the value bytes (same layout as the ordered_map).
+ * A separate control array stores one byte per slot: 0 if the slot is empty, or the probe distance + 1, saturated
+ * at 255. A saturated byte (only possible when many keys share a hash) is resolved to the exact distance from the
+ * hash when a probe reaches that far, so the Robin Hood order holds for any hash: a weak hash makes the map slower
+ * but it only grows with its load.
+ * 
+ * The number of slots is always a power of two, and the slot of a hash is chosen with a multiplicative
+ * (fibonacci) hash, so weak user hash functions still spread over the table.
+ * 
+ * If no hash function is given, keys of 4 or 8 bytes are hashed and compared as fixed width integers without
+ * calling through function pointers. Keys of any other size are hashed and compared byte by byte.
+ * 
+ */
+
+/**
+ * @brief Function signature of the hash of a key.
+ *        Equal keys must produce equal hashes.
+ */
+typedef size_t (*HASH_FUNC)(const void* key);
+
+/**
+ * @brief Struct representing a hash_map
+ *        Stores a unique pair of a key and value in no particular order
+ * @var size_ stores the number of elements
+ * @var capacity_ stores the number of slots of the table (a power of two)
+ * @var key_size_ stores the size in bytes of the keys' type
+ * @var value_size_ stores the size in bytes of the values' type
+ * @var shift_ stores the shift used to reduce a hash to a slot
+ * @var control_ stores the pointer to the array of probe distances of the slots
+ * @var data_ stores the pointer to the array of slots
+ * @var scratch_ stores the pointer to two slots of scratch space used to move entries on insertion
+ * @var hash_func_ stores a pointer to the hash function for the keys (NULL for the built-in hash)
+ * @var equal_func_ stores a pointer to the equality function for the keys (NULL for the built-in comparison)
+ */
+typedef struct data_hash_map_st
+{
+    size_t size_;
+    size_t capacity_;
+    size_t key_size_;
+    size_t value_size_;
+    size_t shift_;
+    uint8_t* control_;
+    void* data_;
+    void* scratch_;
+    HASH_FUNC hash_func_;
+    EQUALS_FUNC equal_func_;
+} hash_map_t;
+
+/**
+ * @brief Create a hash map with the given parameters
+ * 
+ * @param key_size size in bytes of the key data types to be stored
+ * @param value_size size in bytes of the value data types to be stored
+ * @param capacity number of elements the map should be able to store without growing
+ * @param hash_function function pointer to the hash function of the keys (NULL to use the built-in hash)
+ * @param equal_function function pointer to the equality function of the keys (NULL to compare the key bytes)
+ * @return hash_map_t
+ */
+hash_map_t create_hash_map(size_t key_size, size_t value_size, size_t capacity, HASH_FUNC hash_function, EQUALS_FUNC equal_function);
+
+/**
+ * @brief Destroy the instance hash_map passed.
+ *        Cleans up the arrays and resets all parameters.
+ * 
+ * @param map map to be destroyed
+ */
+void destroy_hash_map(hash_map_t* map);
+
+/**
+ * @brief Grows the table so it can store the given number of elements without growing again
+ * 
+ * @param map hash_map which table will be resized
+ * @param new_capacity number of elements the map should be able to store
+ */
+void reserve_hash_map(hash_map_t* map, size_t new_capacity);
+
+/**
+ * @brief Reuses a previously created hash_map and resets its parameters
+ * 
+ * @param map hash_map to be repurposed
+ * @param key_size size in bytes of the key data types to be stored
+ * @param value_size size in bytes of the value data types to be stored
+ * @param capacity number of elements the map should be able to store without growing
+ * @param hash_function the new hash function for the map
+ * @param equal_function the new equality function for the map
+ */
+void reuse_hash_map(hash_map_t* map, size_t key_size, size_t value_size, size_t capacity, HASH_FUNC hash_function, EQUALS_FUNC equal_function);
+
+/**
+ * @brief Returns the next number of slots for a resized table from a previous known number of slots
+ * 
+ * @param capacity the old number of slots of the table
+ * @return the new number of slots of the table
+ */
+size_t next_capacity_hash_map(size_t capacity);
+
+/**
+ * @brief Removes all the elements of the map while keeping its table
+ * 
+ * @param map the hash_map to be cleared
+ */
+void clear_hash_map(hash_map_t* map);
+
+/**
+ * @brief Gets the address of the value with the given key in the map.
+ *        If the key is not in the map, the function returns NULL
+ * 
+ * @param map the hash_map from which the element is retrieved
+ * @param key the key of the element to be retrieved
+ * @return pointer to the data
+ */
+void* get_hash_map(const hash_map_t* map, const void* key);
+
+/**
+ * @brief Sets the new value of the element with the given key in the map
+ * 
+ * @param map the hash_map in which the element is set
+ * @param key the key of the element to be set
+ * @param data the data to copy into the value
+ */
+void set_hash_map(hash_map_t* map, const void* key, const void* data);
+
+/**
+ * @brief Gets the address of the key in the map.
+ *        If the key is not in the map, the function returns NULL
+ * 
+ * @param map the map to search in
+ * @param key the key to search
+ * @return const pointer to the key position
+ */
+const void* find_hash_map(const hash_map_t* map, const void* key);
+
+/**
+ * @brief Inserts the given pair into the hash_map.
+ *        If the key is already in the map, the map is not modified.
+ * 
+ * @param map the hash_map to be added to
+ * @param key the key of the value to be added
+ * @param value the value to be added
+ */
+void insert_pair_hash_map(hash_map_t* map, const void* key, const void* value);
+
+/**
+ * @brief Removes the pair with the given key from the hash_map
+ * 
+ * @param map the hash_map to be removed from
+ * @param key the key of the pair to be removed
+ */
+void remove_pair_hash_map(hash_map_t* map, const void* key);
+
+/**
+ * @brief Removes the pair with the given key from the hash_map and returns its value
+ * 
+ * @param map the hash_map to be removed from
+ * @param key the key of the value to be removed
+ * @param value pointer to be written to
+ */
+void extract_pair_hash_map(hash_map_t* map, const void* key, void* value);
+
+/**
+ * @brief Searches for the given key in the map and returns 1 if it is in the hash map
+ *        else it returns 0
+ * 
+ * @param map the hash_map to be searched
+ * @param key the key to be searched
+ * @return 1 if contains, 0 if does not contain
+ */
+int contains_hash_map(const hash_map_t* map, const void* key);
+
+/**
+ * @brief Returns the first occupied slot at or after the given slot, used to iterate over the elements.
+ *        If there are no more elements, the function returns SIZE_MAX
+ * 
+ * @param map the hash_map to iterate
+ * @param slot the slot where the search starts
+ * @return size_t the occupied slot
+ */
+size_t next_slot_hash_map(const hash_map_t* map, size_t slot);
+
+/**
+ * @brief Gets the key stored at the given slot of the map
+ * 
+ * @param map the map to retrieve from
+ * @param slot the slot of the key
+ * @return const pointer to the key, NULL if the slot is empty
+ */
+const void* get_key_hash_map(const hash_map_t* map, size_t slot);
+
+/**
+ * @brief Gets the address of the value stored at the given slot of the map
+ * 
+ * @param map the map to retrieve from
+ * @param slot the slot of the value
+ * @return pointer to the value, NULL if the slot is empty
+ */
+void* at_slot_hash_map(const hash_map_t* map, size_t slot);
+
+/**
+ * @brief Built-in hash of a 32 bit integer
+ * 
+ * @param key pointer to a uint32_t
+ * @return size_t hash of the key
+ */
+size_t hash_uint32_func(const void* key);
+
+/**
+ * @brief Built-in hash of a 64 bit integer
+ * 
+ * @param key pointer to a uint64_t
+ * @return size_t hash of the key
+ */
+size_t hash_uint64_func(const void* key);
+
+/**
+ * @brief Hashes the given number of bytes (FNV-1a)
+ * 
+ * @param data pointer to the bytes
+ * @param size number of bytes
+ * @return size_t hash of the bytes
+ */
+size_t hash_bytes(const void* data, size_t size);
+
+#endif /* DATA_HASH_MAP_H */
@@ -1,11 +1,109 @@
 #include "heap.h"
 
+#include <string.h>
+#include <alloca.h>
+
+/* Order of the elements in the array: by order_func for a min heap, reversed for the max heap of heap_sort_array */
+static inline int before_heap_array(const void* left, const void* right, LESS_THAN_FUNC order_func, int reversed)
+{
+    return reversed ? order_func(right, left) : order_func(left, right);
+}
+
+static const size_t BASE_ARITY_HEAP = 2;
+
+/* Moves the element at node down to its place, shifting the best child up into the hole instead of swapping per level */
+static void sift_down_heap_array(void* data, size_t size, size_t element_size, size_t arity, size_t node, LESS_THAN_FUNC order_func, int reversed)
+{
+    if (node >= size)
+        return;
+
+    void* element = alloca(element_size);
+    memcpy(element, data + node * element_size, element_size);
+
+    for (;;)
+    {
+        size_t first_child = node * arity + 1;
+        if (first_child >= size)
+            break;
+
+        size_t last_child = first_child + arity < size ? first_child + arity : size;
+        size_t best = first_child;
+        void* best_data = data + first_child * element_size;
+        for (size_t child = first_child + 1; child < last_child; ++child)
+        {
+            void* child_data = data + child * element_size;
+            if (before_heap_array(child_data, best_data, order_func, reversed))
+            {
+                best = child;
+                best_data = child_data;
+            }
+        }
+
+        if (!before_heap_array(best_data, element, order_func, reversed))
+            break;
+        memcpy(data + node * element_size, best_data, element_size);
+        node = best;
+    }
+
+    memcpy(data + node * element_size, element, element_size);
+}
+
+/* Moves the element at node up to its place, shifting the parents down into the hole */
+static void sift_up_heap_array(void* data, size_t element_size, size_t arity, size_t node, LESS_THAN_FUNC order_func)
+{
+    void* element = alloca(element_size);
+    memcpy(element, data + node * element_size, element_size);
+
+    while (node != 0)
+    {
+        size_t parent = (node - 1) / arity;
+        void* parent_data = data + parent * element_size;
+        if (!order_func(element, parent_data))
+            break;
+        memcpy(data + node * element_size, parent_data, element_size);
+        node = parent;
+    }
+
+    memcpy(data + node * element_size, element, element_size);
+}
+
+/* Floyd's construction: sifts down every internal node from the last one up, O(N) in total */
+static void build_heap_array(void* data, size_t size, size_t element_size, size_t arity, LESS_THAN_FUNC order_func, int reversed)
+{
+    size_t internal_nodes = size > 1 ? (size - 2) / arity + 1 : 0;
+    for (size_t node = internal_nodes; node-- > 0;)
+        sift_down_heap_array(data, size, element_size, arity, node, order_func, reversed);
+}
+
 heap create_heap(size_t initial_capacity, size_t element_size, LESS_THAN_FUNC less_than_func)
+{
+    return create_dary_heap(initial_capacity, element_size, BASE_ARITY_HEAP, less_than_func);
+}
+
+heap create_dary_heap(size_t initial_capacity, size_t element_size, size_t arity, LESS_THAN_FUNC less_than_func)
 {
     heap out;
 
-    out.tree_ = create_binary_tree(initial_capacity, element_size);
+    out.tree_ = create_dense_binary_tree(initial_capacity, element_size);
     out.order_func = less_than_func;
+    out.arity_ = arity >= 2 ? arity : BASE_ARITY_HEAP;
+
+    return out;
+}
+
+heap make_heap_from_array(const void* array, size_t count, size_t element_size, LESS_THAN_FUNC less_than_func)
+{
+    return make_dary_heap_from_array(array, count, element_size, BASE_ARITY_HEAP, less_than_func);
+}
+
+heap make_dary_heap_from_array(const void* array, size_t count, size_t element_size, size_t arity, LESS_THAN_FUNC less_than_func)
+{
+    heap out = create_dary_heap(count, element_size, arity, less_than_func);
+
+    if (count != 0)
+        memcpy(out.tree_.data_, array, count * element_size);
+    out.tree_.size_ = count;
+    build_heap_array(out.tree_.data_, count, element_size, out.arity_, less_than_func, 0);
 
     return out;
 }
@@ -16,6 +114,7 @@ heap copy_heap(const heap* heap_)
 
     out.tree_ = copy_binary_tree(&heap_->tree_);
     out.order_func = heap_->order_func;
+    out.arity_ = heap_->arity_;
 
     return out;
 }
@@ -50,15 +149,56 @@ void push_heap(heap* heap_, const void* data)
 
 void pop_last_heap(heap* heap_, void* data)
 {
-    pop_binary_tree(&heap_->tree_, --heap_->tree_.size_, data);
+    binary_tree* tree = &heap_->tree_;
+    if (tree->size_ != 0)
+        memcpy(data, get_element_binary_tree(tree, --tree->size_), tree->element_size_);
 }
 
 void pop_root_heap(heap* heap_, void* data)
 {
     binary_tree* tree = &heap_->tree_;
-    swap(get_element_heap(heap_, 0), get_element_heap(heap_, tree->size_ - 1), tree->element_size_);
-    pop_binary_tree(tree, tree->size_ - 1, data);
-    heapify_down(heap_, 0);
+    if (tree->size_ == 0)
+        return;
+
+    size_t last = --tree->size_;
+    memcpy(data, tree->data_, tree->element_size_);
+    memcpy(tree->data_, tree->data_ + last * tree->element_size_, tree->element_size_);
+    sift_down_heap_array(tree->data_, last, tree->element_size_, heap_->arity_, 0, heap_->order_func, 0);
+}
+
+void push_many_heap(heap* heap_, const void* data, size_t count)
+{
+    binary_tree* tree = &heap_->tree_;
+    size_t size = tree->size_;
+    if (count == 0)
+        return;
+
+    if (size + count > tree->capacity_)
+    {
+        size_t capacity = next_capacity_binary_tree(tree->capacity_);
+        reserve_heap(heap_, capacity > size + count ? capacity : size + count);
+    }
+    memcpy(tree->data_ + size * tree->element_size_, data, count * tree->element_size_);
+    tree->size_ = size + count;
+
+    /* Sifting up each element costs O(count log N), rebuilding the whole heap costs O(N) */
+    size_t levels = (64 - __builtin_clzll((unsigned long long)tree->size_)) / (63 - __builtin_clzll((unsigned long long)heap_->arity_)) + 1;
+    if (count * levels > tree->size_)
+        build_heap_array(tree->data_, tree->size_, tree->element_size_, heap_->arity_, heap_->order_func, 0);
+    else
+    {
+        for (size_t node = size; node < size + count; ++node)
+            heapify_up(heap_, (int)node);
+    }
+}
+
+void pop_many_heap(heap* heap_, void* data, size_t count)
+{
+    if (count > heap_->tree_.size_)
+        count = heap_->tree_.size_;
+
+    for (size_t i = 0; i < count; ++i)
+        pop_root_heap(heap_, data + i * heap_->tree_.element_size_);
 }
 
 void* get_element_heap(const heap* heap_, int node)
@@ -78,73 +218,199 @@ void set_element_heap(heap* heap_, int node, void* data)
 
 void heapify_down(heap* heap_, int node)
 {
-    int parent = node;
-    void* parent_node = get_element_heap(heap_, parent);
+    sift_down_heap_array(heap_->tree_.data_, heap_->tree_.size_, heap_->tree_.element_size_, heap_->arity_, node, heap_->order_func, 0);
+}
 
-    while (parent < heap_->tree_.size_)
+void heapify_up(heap* heap_, int node)
+{
+    sift_up_heap_array(heap_->tree_.data_, heap_->tree_.element_size_, heap_->arity_, node, heap_->order_func);
+}
+
+int is_heap(const heap* heap_)
+{
+    for (int i = 1; i < heap_->tree_.size_; ++i)
     {
-        int left_child = left_child_node_binary_tree(parent);
-        int right_child = right_child_node_binary_tree(parent);
+        if (heap_->order_func(get_element_heap(heap_, i), get_element_heap(heap_, (i - 1) / heap_->arity_)))
+            return 0;
+    }
+    return 1;
+}
 
-        if (left_child >= heap_->tree_.size_)
-            break;
+void heap_sort_array(void* array, size_t count, size_t element_size, LESS_THAN_FUNC less_than_func)
+{
+    build_heap_array(array, count, element_size, BASE_ARITY_HEAP, less_than_func, 1);
+    for (size_t end = count; end-- > 1;)
+    {
+        swap(array, array + end * element_size, element_size);
+        sift_down_heap_array(array, end, element_size, BASE_ARITY_HEAP, 0, less_than_func, 1);
+    }
+}
 
-        void* left_node = get_element_heap(heap_, left_child);
-        void* right_node = get_element_heap(heap_, right_child);
+const uint32_t INVALID_HEAP_POSITION = UINT32_MAX;
 
-        if (heap_->order_func(left_node, parent_node) || heap_->order_func(right_node, parent_node))
-        {
-            if (right_child >= heap_->tree_.size_ || heap_->order_func(left_node, right_node))
-            {
-                swap(left_node, parent_node, heap_->tree_.element_size_);
-                parent = left_child;
-                parent_node = left_node;
-            }
-            else
-            {
-                swap(right_node, parent_node, heap_->tree_.element_size_);
-                parent = right_child;
-                parent_node = right_node;
-            }
-        }
-        else
+static const size_t BASE_ARITY_INDEXED_HEAP = 4;
+
+static void* key_indexed_heap(const indexed_heap* heap_, uint32_t id)
+{
+    return heap_->keys_ + (size_t)id * heap_->element_size_;
+}
+
+static void place_indexed_heap(indexed_heap* heap_, size_t slot, uint32_t id)
+{
+    heap_->heap_[slot] = id;
+    heap_->position_[id] = slot;
+}
+
+static void sift_up_indexed_heap(indexed_heap* heap_, size_t slot)
+{
+    uint32_t id = heap_->heap_[slot];
+    const void* key = key_indexed_heap(heap_, id);
+
+    while (slot != 0)
+    {
+        size_t parent = (slot - 1) / heap_->arity_;
+        uint32_t parent_id = heap_->heap_[parent];
+        if (!heap_->order_func(key, key_indexed_heap(heap_, parent_id)))
             break;
+        place_indexed_heap(heap_, slot, parent_id);
+        slot = parent;
     }
+    place_indexed_heap(heap_, slot, id);
 }
 
-void heapify_up(heap* heap_, int node)
+static void sift_down_indexed_heap(indexed_heap* heap_, size_t slot)
 {
-    int child = node;
-    void* child_node = get_element_heap(heap_, child);
-    while (child != 0)
+    uint32_t id = heap_->heap_[slot];
+    const void* key = key_indexed_heap(heap_, id);
+
+    while (1)
     {
-        int parent = parent_node_binary_tree(child);
-        void* parent_node = get_element_heap(heap_, parent);
+        size_t first_child = slot * heap_->arity_ + 1;
+        if (first_child >= heap_->size_)
+            break;
+
+        size_t last_child = first_child + heap_->arity_;
+        if (last_child > heap_->size_)
+            last_child = heap_->size_;
 
-        if (heap_->order_func(child_node, parent_node))
+        size_t best = first_child;
+        const void* best_key = key_indexed_heap(heap_, heap_->heap_[first_child]);
+        for (size_t child = first_child + 1; child < last_child; ++child)
         {
-            swap(child_node, parent_node, heap_->tree_.element_size_);
-            child = parent;
-            child_node = parent_node;
+            const void* child_key = key_indexed_heap(heap_, heap_->heap_[child]);
+            if (heap_->order_func(child_key, best_key))
+            {
+                best = child;
+                best_key = child_key;
+            }
         }
-        else
+
+        if (!heap_->order_func(best_key, key))
             break;
+        place_indexed_heap(heap_, slot, heap_->heap_[best]);
+        slot = best;
     }
+    place_indexed_heap(heap_, slot, id);
 }
 
-int is_heap(const heap* heap_)
+indexed_heap create_indexed_heap(size_t capacity, size_t element_size, size_t arity, LESS_THAN_FUNC less_than_func)
 {
-    for (int i = 0; i < heap_->tree_.size_; ++i)
+    indexed_heap out;
+
+    out.size_ = 0;
+    out.capacity_ = capacity;
+    out.element_size_ = element_size;
+    out.arity_ = arity >= 2 ? arity : BASE_ARITY_INDEXED_HEAP;
+    out.order_func = less_than_func;
+    out.heap_ = (uint32_t*)malloc(capacity * sizeof(uint32_t));
+    out.position_ = (uint32_t*)malloc(capacity * sizeof(uint32_t));
+    out.keys_ = malloc(capacity * element_size);
+    memset(out.position_, 0xFF, capacity * sizeof(uint32_t));
+
+    return out;
+}
+
+void destroy_indexed_heap(indexed_heap* heap_)
+{
+    free(heap_->heap_);
+    free(heap_->position_);
+    free(heap_->keys_);
+    heap_->heap_ = NULL;
+    heap_->position_ = NULL;
+    heap_->keys_ = NULL;
+    heap_->size_ = 0;
+    heap_->capacity_ = 0;
+    heap_->element_size_ = 0;
+}
+
+void reserve_indexed_heap(indexed_heap* heap_, size_t capacity)
+{
+    if (capacity > heap_->capacity_)
     {
-        int left = left_child_node_binary_tree(i);
-        int right = right_child_node_binary_tree(i);
+        heap_->heap_ = (uint32_t*)realloc(heap_->heap_, capacity * sizeof(uint32_t));
+        heap_->position_ = (uint32_t*)realloc(heap_->position_, capacity * sizeof(uint32_t));
+        heap_->keys_ = realloc(heap_->keys_, capacity * heap_->element_size_);
+        memset(heap_->position_ + heap_->capacity_, 0xFF, (capacity - heap_->capacity_) * sizeof(uint32_t));
+        heap_->capacity_ = capacity;
+    }
+}
 
-        if (heap_->order_func(get_element_heap(heap_, left), get_element_heap(heap_, i))
-            || heap_->order_func(get_element_heap(heap_, right), get_element_heap(heap_, i)))
-        {
-            if (left < heap_->tree_.size_ && right < heap_->tree_.size_)
-                return 0;
-        }
+void clear_indexed_heap(indexed_heap* heap_)
+{
+    for (size_t i = 0; i < heap_->size_; ++i)
+        heap_->position_[heap_->heap_[i]] = INVALID_HEAP_POSITION;
+    heap_->size_ = 0;
+}
+
+void push_indexed_heap(indexed_heap* heap_, uint32_t id, const void* key)
+{
+    if (id >= heap_->capacity_ || heap_->position_[id] != INVALID_HEAP_POSITION)
+        return;
+
+    memcpy(key_indexed_heap(heap_, id), key, heap_->element_size_);
+    heap_->heap_[heap_->size_] = id;
+    sift_up_indexed_heap(heap_, heap_->size_++);
+}
+
+void pop_root_indexed_heap(indexed_heap* heap_, uint32_t* id, void* key)
+{
+    if (heap_->size_ == 0)
+        return;
+
+    uint32_t root = heap_->heap_[0];
+    if (id != NULL)
+        *id = root;
+    if (key != NULL)
+        memcpy(key, key_indexed_heap(heap_, root), heap_->element_size_);
+
+    heap_->position_[root] = INVALID_HEAP_POSITION;
+    if (--heap_->size_ != 0)
+    {
+        heap_->heap_[0] = heap_->heap_[heap_->size_];
+        sift_down_indexed_heap(heap_, 0);
     }
-    return 1;
-}
\ No newline at end of file
+}
+
+void decrease_key_indexed_heap(indexed_heap* heap_, uint32_t id, const void* key)
+{
+    if (!contains_indexed_heap(heap_, id))
+        return;
+
+    memcpy(key_indexed_heap(heap_, id), key, heap_->element_size_);
+    sift_up_indexed_heap(heap_, heap_->position_[id]);
+}
+
+uint32_t top_indexed_heap(const indexed_heap* heap_)
+{
+    return heap_->size_ != 0 ? heap_->heap_[0] : INVALID_HEAP_POSITION;
+}
+
+void* get_key_indexed_heap(const indexed_heap* heap_, uint32_t id)
+{
+    return contains_indexed_heap(heap_, id) ? key_indexed_heap(heap_, id) : NULL;
+}
+
+int contains_indexed_heap(const indexed_heap* heap_, uint32_t id)
+{
+    return id < heap_->capacity_ && heap_->position_[id] != INVALID_HEAP_POSITION;
+}
@@ -2,17 +2,30 @@
 #define DATA_HEAP_H
 
 #include "binary_tree.h"
+#include "algorithm.h"
 
-typedef int (*LESS_THAN_FUNC)(void* left, void* right);
-typedef int (*GREATER_THAN_FUNC)(void* left, void* right);
+#include <stdint.h>
 
+typedef int (*GREATER_THAN_FUNC)(const void* left, const void* right);
+
+/*
+ * The elements are stored in the array of tree_ (a dense binary_tree, without occupancy bitmap) in breadth first order,
+ * with the children of a node next to each other.
+ * arity_ is the number of children per node: heaps of 4 or 8 children are half or a third as deep as binary heaps, so a
+ * pop touches fewer cache lines on large heaps, and the children of a node with small elements share one or two lines.
+ */
 typedef struct data_heap_st
 {
     binary_tree tree_;
     LESS_THAN_FUNC order_func;
+    size_t arity_;
 } heap;
 
 heap create_heap(size_t initial_capacity, size_t element_size, LESS_THAN_FUNC less_than_func);
+heap create_dary_heap(size_t initial_capacity, size_t element_size, size_t arity, LESS_THAN_FUNC less_than_func);
+/* Creates a heap holding a copy of the array, ordered in O(N) with Floyd's construction instead of N pushes */
+heap make_heap_from_array(const void* array, size_t count, size_t element_size, LESS_THAN_FUNC less_than_func);
+heap make_dary_heap_from_array(const void* array, size_t count, size_t element_size, size_t arity, LESS_THAN_FUNC less_than_func);
 heap copy_heap(const heap* heap_);
 void destroy_heap(heap* heap_);
 void reuse_heap(heap* heap_, size_t element_size);
@@ -23,6 +36,10 @@ void push_heap(heap* heap_, const void* data);
 void pop_last_heap(heap* heap_, void* data);
 void pop_root_heap(heap* heap_, void* data);
 
+/* Bulk operations: push_many_heap rebuilds the heap in O(N) when the batch is large, pop_many_heap writes up to count roots in order */
+void push_many_heap(heap* heap_, const void* data, size_t count);
+void pop_many_heap(heap* heap_, void* data, size_t count);
+
 void* get_element_heap(const heap* heap_, int node);
 void set_element_heap(heap* heap_, int node, void* data);
 
@@ -31,4 +48,126 @@ void heapify_up(heap* heap_, int node);
 
 int is_heap(const heap* heap_);
 
+/* Sorts the array in place in ascending order of less_than_func, O(N log N) without extra memory */
+void heap_sort_array(void* array, size_t count, size_t element_size, LESS_THAN_FUNC less_than_func);
+
+/*
+ * Typed heap specialization
+ *
+ * DEFINE_TYPED_HEAP(tag, T, LESS) stamps out static inline functions for a heap of T ordered by LESS(left, right),
+ * a macro or function comparing two values (DEFAULT_LESS_THAN for types with a built-in < operator):
+ *
+ * create_tag_heap(initial_capacity), push_tag_heap(heap_, value), pop_root_tag_heap(heap_), top_tag_heap(heap_)
+ *
+ * The heap is a regular heap created with an order function calling LESS, so it can also be passed to the generic
+ * functions (create_dary_heap(capacity, sizeof(T), arity, less_tag_heap) creates one with more children per node).
+ * The typed functions sift with plain assignments into a hole instead of swapping element_size_ bytes through the
+ * order function at every level. pop_root returns a zeroed T when the heap is empty.
+ */
+#define DEFINE_TYPED_HEAP(tag, T, LESS)                                                                         \
+static inline int less_##tag##_heap(const void* left, const void* right)                                        \
+{                                                                                                               \
+    T l, r;                                                                                                     \
+    memcpy(&l, left, sizeof(T));                                                                                \
+    memcpy(&r, right, sizeof(T));                                                                               \
+    return LESS(l, r);                                                                                          \
+}                                                                                                               \
+                                                                                                                \
+static inline heap create_##tag##_heap(size_t initial_capacity)                                                 \
+{                                                                                                               \
+    return create_heap(initial_capacity, sizeof(T), less_##tag##_heap);                                         \
+}                                                                                                               \
+                                                                                                                \
+static inline T top_##tag##_heap(const heap* heap_)                                                             \
+{                                                                                                               \
+    return ((const T*)heap_->tree_.data_)[0];                                                                   \
+}                                                                                                               \
+                                                                                                                \
+static inline void push_##tag##_heap(heap* heap_, T value)                                                      \
+{                                                                                                               \
+    binary_tree* tree = &heap_->tree_;                                                                          \
+    if (tree->size_ == tree->capacity_)                                                                         \
+        reserve_heap(heap_, next_capacity_binary_tree(tree->capacity_));                                        \
+                                                                                                                \
+    T* data = (T*)tree->data_;                                                                                  \
+    size_t child = tree->size_;                                                                                 \
+    ++tree->size_;                                                                                              \
+    while (child != 0)                                                                                          \
+    {                                                                                                           \
+        size_t parent = (child - 1) / heap_->arity_;                                                            \
+        if (!(LESS(value, data[parent])))                                                                       \
+            break;                                                                                              \
+        data[child] = data[parent];                                                                             \
+        child = parent;                                                                                         \
+    }                                                                                                           \
+    data[child] = value;                                                                                        \
+}                                                                                                               \
+                                                                                                                \
+static inline T pop_root_##tag##_heap(heap* heap_)                                                              \
+{                                                                                                               \
+    binary_tree* tree = &heap_->tree_;                                                                          \
+    T out = {0};                                                                                                \
+    if (tree->size_ == 0)                                                                                       \
+        return out;                                                                                             \
+                                                                                                                \
+    T* data = (T*)tree->data_;                                                                                  \
+    size_t size = --tree->size_;                                                                                \
+    T last = data[size];                                                                                        \
+    out = data[0];                                                                                              \
+                                                                                                                \
+    size_t parent = 0;                                                                                          \
+    for (;;)                                                                                                    \
+    {                                                                                                           \
+        size_t child = parent * heap_->arity_ + 1;                                                              \
+        if (child >= size)                                                                                      \
+            break;                                                                                              \
+        size_t last_child = child + heap_->arity_ < size ? child + heap_->arity_ : size;                        \
+        for (size_t sibling = child + 1; sibling < last_child; ++sibling)                                       \
+        {                                                                                                       \
+            if (LESS(data[sibling], data[child]))                                                               \
+                child = sibling;                                                                                \
+        }                                                                                                       \
+        if (!(LESS(data[child], last)))                                                                         \
+            break;                                                                                              \
+        data[parent] = data[child];                                                                             \
+        parent = child;                                                                                         \
+    }                                                                                                           \
+    data[parent] = last;                                                                                        \
+    return out;                                                                                                 \
+}
+
+/*
+ * Indexed d-ary heap
+ *
+ * Stores ids in [0, capacity_) ordered by a key kept per id. position_ maps every id to its slot in heap_
+ * (or INVALID_HEAP_POSITION when the id is not in the heap), which allows the key of an id already in the
+ * heap to be decreased in O(log_d N) without searching for it.
+ */
+typedef struct data_indexed_heap_st
+{
+    uint32_t* heap_;
+    uint32_t* position_;
+    void* keys_;
+    size_t size_;
+    size_t capacity_;
+    size_t element_size_;
+    size_t arity_;
+    LESS_THAN_FUNC order_func;
+} indexed_heap;
+
+extern const uint32_t INVALID_HEAP_POSITION;/* = UINT32_MAX; */
+
+indexed_heap create_indexed_heap(size_t capacity, size_t element_size, size_t arity, LESS_THAN_FUNC less_than_func);
+void destroy_indexed_heap(indexed_heap* heap_);
+void reserve_indexed_heap(indexed_heap* heap_, size_t capacity);
+void clear_indexed_heap(indexed_heap* heap_);
+
+void push_indexed_heap(indexed_heap* heap_, uint32_t id, const void* key);
+void pop_root_indexed_heap(indexed_heap* heap_, uint32_t* id, void* key);
+void decrease_key_indexed_heap(indexed_heap* heap_, uint32_t id, const void* key);
+
+uint32_t top_indexed_heap(const indexed_heap* heap_);
+void* get_key_indexed_heap(const indexed_heap* heap_, uint32_t id);
+int contains_indexed_heap(const indexed_heap* heap_, uint32_t id);
+
 #endif /* DATA_HEAP_H */
\ No newline at end of file
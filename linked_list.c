@@ -1,8 +1,28 @@
 #include "linked_list.h"
 
 #include <string.h>
+#include <stdint.h>
 #include <assert.h>
 
+static linked_list_node new_node_llist(linked_list* list, const void* data, const linked_list_node next)
+{
+    if (list->pool_ == NULL)
+        return create_linked_list_node(list->element_size_, data, next);
+
+    linked_list_node node = alloc_node_pool(list->pool_);
+    set_llist_node_next(node, next);
+    set_llist_node_data(node, list->element_size_, data);
+    return node;
+}
+
+static void delete_node_llist(linked_list* list, linked_list_node node)
+{
+    if (list->pool_ == NULL)
+        destroy_linked_list_node(node);
+    else
+        free_node_pool(list->pool_, node);
+}
+
 linked_list create_linked_list(size_t element_size)
 {
     linked_list list;
@@ -10,6 +30,17 @@ linked_list create_linked_list(size_t element_size)
     list.element_size_ = element_size;
     list.size_ = 0;
     list.head_ = NULL;
+    list.pool_ = NULL;
+
+    return list;
+}
+
+linked_list create_pooled_linked_list(size_t element_size)
+{
+    linked_list list = create_linked_list(element_size);
+
+    list.pool_ = (node_pool_t*)malloc(sizeof(node_pool_t));
+    *list.pool_ = create_node_pool(sizeof(void*) + element_size, 0);
 
     return list;
 }
@@ -19,6 +50,16 @@ void destroy_linked_list(linked_list* list)
     list->element_size_ = 0;
     list->size_ = 0;
     
+    if (list->pool_ != NULL)
+    {
+        /* Every node lives in the slabs of the pool, release them at once */
+        destroy_node_pool(list->pool_);
+        free(list->pool_);
+        list->pool_ = NULL;
+        list->head_ = NULL;
+        return;
+    }
+
     linked_list_node current = list->head_;
     while (current != NULL)
     {
@@ -26,6 +67,7 @@ void destroy_linked_list(linked_list* list)
         destroy_linked_list_node(current);
         current = temp;
     }
+    list->head_ = NULL;
 }
 
 linked_list begin_linked_list(size_t element_size, linked_list_node head)
@@ -33,6 +75,7 @@ linked_list begin_linked_list(size_t element_size, linked_list_node head)
     linked_list out;
     out.element_size_ = element_size;
     out.head_ = head;
+    out.pool_ = NULL;
 
     int i = 0;
     linked_list_node current = head;
@@ -48,17 +91,14 @@ linked_list begin_linked_list(size_t element_size, linked_list_node head)
 
 linked_list copy_linked_list(const linked_list* list)
 {
-    linked_list out;
-
-    out.size_ = 0;
-    out.element_size_ = list->element_size_;
-    out.head_ = NULL;
+    linked_list out = list->pool_ != NULL ? create_pooled_linked_list(list->element_size_) : create_linked_list(list->element_size_);
 
-    if (list->size_ == 0)
-        out.head_ = NULL;
-    else if (list->size_ == 1)
-        out.head_ = create_linked_list_node(list->element_size_, get_llist_node_data(list->head_), NULL);
-    else
+    if (list->size_ == 1)
+    {
+        out.head_ = new_node_llist(&out, get_llist_node_data(list->head_), NULL);
+        out.size_ = 1;
+    }
+    else if (list->size_ > 1)
     {
         linked_list_node current = list->head_;
         while (current != NULL)
@@ -140,11 +180,11 @@ void set_element_linked_list(linked_list* list, int node, const void* data)
 void push_linked_list(linked_list* list, const void* data)
 {
     if (list->size_ == 0)
-        list->head_ = create_linked_list_node(list->element_size_, data, NULL);
+        list->head_ = new_node_llist(list, data, NULL);
     else
     {
         linked_list_node last = get_linked_list_node(list, list->size_ - 1);
-        set_llist_node_next(last, create_linked_list_node(list->element_size_, data, NULL));
+        set_llist_node_next(last, new_node_llist(list, data, NULL));
     }
     ++list->size_;
 }
@@ -156,14 +196,14 @@ void pop_linked_list(linked_list* list, void* data)
     else if (list->size_ == 1)
     {
         memcpy(data, get_llist_node_data(list->head_), list->element_size_);
-        destroy_linked_list_node(list->head_);
+        delete_node_llist(list, list->head_);
         list->head_ = NULL;
     }
     else
     {
         linked_list_node prev_last = get_linked_list_node(list, list->size_ - 2);
-        memcpy(data, get_llist_node_data(prev_last), list->element_size_);
-        destroy_linked_list_node(get_llist_node_next(prev_last));
+        memcpy(data, get_llist_node_data(get_llist_node_next(prev_last)), list->element_size_);
+        delete_node_llist(list, get_llist_node_next(prev_last));
         set_llist_node_next(prev_last, NULL);
     }
     --list->size_;
@@ -175,11 +215,11 @@ void insert_linked_list(linked_list* list, int node, const void* data)
         return;
     
     if (node == 0)
-        list->head_ = create_linked_list_node(list->element_size_, data, list->head_);
+        list->head_ = new_node_llist(list, data, list->head_);
     else
     {
         linked_list_node prev = get_linked_list_node(list, node - 1);
-        set_llist_node_next(prev, create_linked_list_node(list->element_size_, data, get_llist_node_next(prev)));
+        set_llist_node_next(prev, new_node_llist(list, data, get_llist_node_next(prev)));
     }
     ++list->size_;
 }
@@ -189,19 +229,20 @@ void remove_linked_list(linked_list* list, int node, void* data)
     if (node >= list->size_ || list->size_ == 0)
         return;
 
-    if (list->size_ == 1)
+    if (node == 0)
     {
-        memcpy(data, get_llist_node_data(list->head_), list->element_size_);
-        destroy_linked_list_node(list->head_);
-        list->head_ = NULL;
+        linked_list_node rm = list->head_;
+        memcpy(data, get_llist_node_data(rm), list->element_size_);
+        list->head_ = get_llist_node_next(rm);
+        delete_node_llist(list, rm);
     }
     else
     {
         linked_list_node prev = get_linked_list_node(list, node - 1);
         linked_list_node rm = get_llist_node_next(prev);
-        memcpy(data, rm, list->element_size_);
+        memcpy(data, get_llist_node_data(rm), list->element_size_);
         set_llist_node_next(prev, get_llist_node_next(rm));
-        destroy_linked_list_node(rm);
+        delete_node_llist(list, rm);
     }
 
     --list->size_;
@@ -1,6 +1,8 @@
 #ifndef DATA_LINKED_LIST_H
 #define DATA_LINKED_LIST_H
 
+#include "node_pool.h"
+
 #include <stdlib.h>
 
 typedef void* linked_list_node;
@@ -17,9 +19,11 @@ typedef struct data_linked_list_st
     size_t element_size_;
     size_t size_;
     linked_list_node head_;
+    node_pool_t* pool_;     /* NULL if every node is malloc'ed on its own */
 } linked_list;
 
 linked_list create_linked_list(size_t element_size);
+linked_list create_pooled_linked_list(size_t element_size);
 void destroy_linked_list(linked_list* list);
 linked_list begin_linked_list(size_t element_size, linked_list_node head);
 linked_list copy_linked_list(const linked_list* list);
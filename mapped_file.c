@@ -0,0 +1,168 @@
+#define _GNU_SOURCE
+#include "mapped_file.h"
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+_Static_assert(sizeof(mapped_header_t) == MAPPED_FILE_HEADER_SIZE, "the header must fill MAPPED_FILE_HEADER_SIZE bytes");
+
+static const uint64_t CHECKSUM_PRIME_1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t CHECKSUM_PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+
+static inline uint64_t rotate_left_checksum(uint64_t value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static inline uint64_t round_checksum(uint64_t lane, uint64_t word)
+{
+    return rotate_left_checksum(lane + word * CHECKSUM_PRIME_2, 31) * CHECKSUM_PRIME_1;
+}
+
+uint64_t checksum_mapped_data(const void* data, size_t bytes)
+{
+    const unsigned char* cursor = (const unsigned char*)data;
+    const unsigned char* end = cursor + bytes;
+    uint64_t lanes[4] = { CHECKSUM_PRIME_1 + CHECKSUM_PRIME_2, CHECKSUM_PRIME_2, 0, -CHECKSUM_PRIME_1 };
+    uint64_t word;
+
+    /* The four lanes do not depend on each other, so their multiplications overlap */
+    for (; end - cursor >= 32; cursor += 32)
+    {
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            memcpy(&word, cursor + lane * sizeof(uint64_t), sizeof(uint64_t));
+            lanes[lane] = round_checksum(lanes[lane], word);
+        }
+    }
+
+    uint64_t checksum = rotate_left_checksum(lanes[0], 1) + rotate_left_checksum(lanes[1], 7)
+        + rotate_left_checksum(lanes[2], 12) + rotate_left_checksum(lanes[3], 18) + bytes;
+
+    for (; end - cursor >= 8; cursor += 8)
+    {
+        memcpy(&word, cursor, sizeof(uint64_t));
+        checksum = rotate_left_checksum(checksum ^ round_checksum(0, word), 27) * CHECKSUM_PRIME_1 + CHECKSUM_PRIME_2;
+    }
+    for (; cursor < end; ++cursor)
+        checksum = rotate_left_checksum(checksum ^ (*cursor * CHECKSUM_PRIME_1), 11) * CHECKSUM_PRIME_2;
+
+    checksum ^= checksum >> 33;
+    checksum *= CHECKSUM_PRIME_2;
+    checksum ^= checksum >> 29;
+    return checksum;
+}
+
+static mapped_file_t* map_mapped_file(int fd, size_t length, int read_only)
+{
+    void* base = mmap(NULL, length, read_only ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    mapped_file_t* out = (mapped_file_t*)malloc(sizeof(mapped_file_t));
+    out->fd_ = fd;
+    out->read_only_ = read_only;
+    out->base_ = base;
+    out->length_ = length;
+
+    return out;
+}
+
+mapped_file_t* create_mapped_file(const char* path, size_t data_bytes)
+{
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return NULL;
+
+    size_t length = MAPPED_FILE_HEADER_SIZE + data_bytes;
+    if (ftruncate(fd, (off_t)length) != 0)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    return map_mapped_file(fd, length, 0);
+}
+
+mapped_file_t* open_mapped_file(const char* path, uint64_t magic, int read_only)
+{
+    int fd = open(path, read_only ? O_RDONLY : O_RDWR);
+    if (fd < 0)
+        return NULL;
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || (size_t)status.st_size < MAPPED_FILE_HEADER_SIZE)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    mapped_file_t* out = map_mapped_file(fd, (size_t)status.st_size, read_only);
+    if (out == NULL)
+        return NULL;
+
+    const mapped_header_t* header = header_mapped_file(out);
+    if (header->magic_ != magic || header->element_size_ == 0
+        || header->count_ > data_bytes_mapped_file(out) / header->element_size_)
+    {
+        close_mapped_file(out);
+        return NULL;
+    }
+
+    return out;
+}
+
+void close_mapped_file(mapped_file_t* file)
+{
+    munmap(file->base_, file->length_);
+    close(file->fd_);
+    free(file);
+}
+
+int grow_mapped_file(mapped_file_t* file, size_t data_bytes)
+{
+    if (data_bytes <= data_bytes_mapped_file(file))
+        return 1;
+    if (file->read_only_)
+        return 0;
+
+    size_t length = MAPPED_FILE_HEADER_SIZE + data_bytes;
+    if (ftruncate(file->fd_, (off_t)length) != 0)
+        return 0;
+
+    void* base = mremap(file->base_, file->length_, length, MREMAP_MAYMOVE);
+    if (base == MAP_FAILED)
+        return 0;
+
+    file->base_ = base;
+    file->length_ = length;
+    return 1;
+}
+
+void write_header_mapped_file(mapped_file_t* file, uint64_t magic, size_t element_size, size_t count, size_t columns, int flush)
+{
+    if (file->read_only_)
+        return;
+
+    mapped_header_t* header = header_mapped_file(file);
+    header->magic_ = magic;
+    header->element_size_ = element_size;
+    header->count_ = count;
+    header->columns_ = columns;
+    header->checksum_ = checksum_mapped_data(data_mapped_file(file), count * element_size);
+
+    if (flush)
+        msync(file->base_, file->length_, MS_SYNC);
+}
+
+int verify_mapped_file(const mapped_file_t* file)
+{
+    const mapped_header_t* header = header_mapped_file(file);
+    return header->checksum_ == checksum_mapped_data(data_mapped_file(file), header->count_ * header->element_size_);
+}
@@ -0,0 +1,171 @@
+#ifndef DATA_MAPPED_FILE_H
+#define DATA_MAPPED_FILE_H
+
+/**
+ * @file mapped_file.h
+ * @author Edwin Solis (edwinsolisf12@gmail.com)
+ * @brief File backed storage for the contiguous containers
+ * @version 0.1
+ * @date 2021-11-12
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+
+/**
+ * @details Layout
+ * 
+ * A mapped file starts with a header of MAPPED_FILE_HEADER_SIZE bytes followed by the elements, so the elements
+ * are aligned to a cache line and the container data_ points straight into the mapping. The file is mapped with
+ * MAP_SHARED: writes to the container go to the page cache and reach the file without copies, and other processes
+ * opening the same file share the same physical pages.
+ * 
+ * The header is only written when the container is synced or destroyed, so a file is consistent again after that.
+ * The checksum covers the element bytes and is not verified on open (attaching to a large dataset does not read it),
+ * the verify functions of the containers check it on demand.
+ */
+
+/**
+ * @brief Size in bytes of the header at the start of a mapped file
+ */
+#define MAPPED_FILE_HEADER_SIZE 64
+
+/**
+ * @brief Header stored at the start of a mapped file
+ * 
+ * @var magic_ stores the kind of container stored in the file
+ * @var element_size_ stores the size in bytes of the elements
+ * @var count_ stores the number of elements
+ * @var columns_ stores the number of columns of a matrix (0 for a list)
+ * @var checksum_ stores the checksum of the element bytes, from checksum_mapped_data
+ */
+typedef struct data_mapped_header_st
+{
+    uint64_t magic_;
+    uint64_t element_size_;
+    uint64_t count_;
+    uint64_t columns_;
+    uint64_t checksum_;
+    uint64_t reserved_[3];
+} mapped_header_t;
+
+/**
+ * @brief Struct representing an open mapped file
+ * 
+ * @var fd_ stores the file descriptor of the file
+ * @var read_only_ stores 1 if the file was opened read-only, else 0
+ * @var base_ stores the address of the mapping, starting at the header
+ * @var length_ stores the number of bytes mapped (the size of the file)
+ */
+typedef struct data_mapped_file_st
+{
+    int fd_;
+    int read_only_;
+    void* base_;
+    size_t length_;
+} mapped_file_t;
+
+/**
+ * @brief Creates (or truncates) the file at the given path with room for the given number of element bytes and maps it
+ * 
+ * @param path path of the file
+ * @param data_bytes number of bytes after the header
+ * @return mapped_file_t* the open file, NULL if the file could not be created or mapped
+ */
+mapped_file_t* create_mapped_file(const char* path, size_t data_bytes);
+
+/**
+ * @brief Maps an existing file with the given magic in its header
+ * 
+ * @param path path of the file
+ * @param magic kind of container expected in the file
+ * @param read_only 1 to map the file read-only (the container must not be modified), 0 to map it for writing
+ * @return mapped_file_t* the open file, NULL if the file could not be opened, is too small for its header or holds
+ *         another kind of container
+ */
+mapped_file_t* open_mapped_file(const char* path, uint64_t magic, int read_only);
+
+/**
+ * @brief Unmaps and closes the file and releases its resources. The header is not written.
+ * 
+ * @param file file to be closed
+ */
+void close_mapped_file(mapped_file_t* file);
+
+/**
+ * @brief Grows the file and its mapping to hold at least the given number of element bytes.
+ *        The mapping may move, so pointers into it must be taken again.
+ * 
+ * @param file file to be grown
+ * @param data_bytes number of bytes needed after the header
+ * @return int 1 if the file can hold the bytes, 0 if it is read-only or could not be grown
+ */
+int grow_mapped_file(mapped_file_t* file, size_t data_bytes);
+
+/**
+ * @brief Gets the address of the header of the file
+ * 
+ * @param file file to be accessed
+ * @return mapped_header_t* pointer to the header
+ */
+static inline mapped_header_t* header_mapped_file(const mapped_file_t* file)
+{
+    return (mapped_header_t*)file->base_;
+}
+
+/**
+ * @brief Gets the address of the first byte after the header of the file
+ * 
+ * @param file file to be accessed
+ * @return void* pointer to the element bytes
+ */
+static inline void* data_mapped_file(const mapped_file_t* file)
+{
+    return file->base_ + MAPPED_FILE_HEADER_SIZE;
+}
+
+/**
+ * @brief Gets the number of element bytes that the file can hold
+ * 
+ * @param file file to be accessed
+ * @return size_t number of bytes after the header
+ */
+static inline size_t data_bytes_mapped_file(const mapped_file_t* file)
+{
+    return file->length_ - MAPPED_FILE_HEADER_SIZE;
+}
+
+/**
+ * @brief Writes the header of the file with the checksum of its first count * element_size element bytes.
+ *        Does nothing on read-only files.
+ * 
+ * @param file file to be written
+ * @param magic kind of container stored in the file
+ * @param element_size size in bytes of the elements
+ * @param count number of elements
+ * @param columns number of columns of a matrix (0 for a list)
+ * @param flush 1 to also wait until the file is written to the disk, 0 to leave it to the page cache
+ */
+void write_header_mapped_file(mapped_file_t* file, uint64_t magic, size_t element_size, size_t count, size_t columns, int flush);
+
+/**
+ * @brief Returns if the checksum in the header of the file matches its element bytes
+ * 
+ * @param file file to be checked
+ * @return int 1 if it matches, 0 if it does not
+ */
+int verify_mapped_file(const mapped_file_t* file);
+
+/**
+ * @brief Computes the 64 bit checksum of the given bytes, reading them a word at a time in four independent lanes
+ * 
+ * @param data pointer to the bytes
+ * @param bytes number of bytes
+ * @return uint64_t checksum
+ */
+uint64_t checksum_mapped_data(const void* data, size_t bytes);
+
+#endif /* DATA_MAPPED_FILE_H */
@@ -10,12 +10,88 @@ matrix_t create_matrix(size_t element_size, size_t rows, size_t columns, const v
     out.rows_ = rows;
     out.columns_ = columns;
     out.data_ = malloc(element_size * rows *  columns);
+    out.mapping_ = NULL;
     if (data != NULL)
         memcpy(out.data_, data, element_size * rows * columns);
 
     return out;
 }
 
+/* "DSMATRX1" */
+static const uint64_t MAPPED_MATRIX_MAGIC = 0x31585254414D5344ULL;
+
+matrix_t create_mapped_matrix(const char* path, size_t element_size, size_t rows, size_t columns)
+{
+    matrix_t out;
+
+    out.element_size_ = element_size;
+    out.rows_ = 0;
+    out.columns_ = 0;
+    out.data_ = NULL;
+    out.mapping_ = create_mapped_file(path, element_size * rows * columns);
+    if (out.mapping_ != NULL)
+    {
+        out.rows_ = rows;
+        out.columns_ = columns;
+        out.data_ = data_mapped_file(out.mapping_);
+        write_header_mapped_file(out.mapping_, MAPPED_MATRIX_MAGIC, element_size, rows * columns, columns, 0);
+    }
+
+    return out;
+}
+
+matrix_t open_mapped_matrix(const char* path, int read_only)
+{
+    matrix_t out;
+
+    out.element_size_ = 0;
+    out.rows_ = 0;
+    out.columns_ = 0;
+    out.data_ = NULL;
+    out.mapping_ = open_mapped_file(path, MAPPED_MATRIX_MAGIC, read_only);
+    if (out.mapping_ != NULL)
+    {
+        const mapped_header_t* header = header_mapped_file(out.mapping_);
+        if (header->columns_ == 0 || header->count_ % header->columns_ != 0)
+        {
+            close_mapped_file(out.mapping_);
+            out.mapping_ = NULL;
+            return out;
+        }
+        out.element_size_ = header->element_size_;
+        out.columns_ = header->columns_;
+        out.rows_ = header->count_ / header->columns_;
+        out.data_ = data_mapped_file(out.mapping_);
+    }
+
+    return out;
+}
+
+void sync_matrix(matrix_t* matrix)
+{
+    if (matrix->mapping_ != NULL)
+        write_header_mapped_file(matrix->mapping_, MAPPED_MATRIX_MAGIC, matrix->element_size_, matrix->rows_ * matrix->columns_, matrix->columns_, 1);
+}
+
+int verify_mapped_matrix(const matrix_t* matrix)
+{
+    return matrix->mapping_ != NULL && verify_mapped_file(matrix->mapping_);
+}
+
+/* Makes room for the given number of bytes in the array of the matrix, returns 0 if a mapped matrix could not grow */
+static int reserve_matrix(matrix_t* matrix, size_t bytes)
+{
+    if (matrix->mapping_ != NULL)
+    {
+        if (!grow_mapped_file(matrix->mapping_, bytes))
+            return 0;
+        matrix->data_ = data_mapped_file(matrix->mapping_);
+    }
+    else if (bytes > matrix->rows_ * matrix->columns_ * matrix->element_size_)
+        matrix->data_ = realloc(matrix->data_, bytes);
+    return 1;
+}
+
 matrix_t clone_matrix(const matrix_t* matrix)
 {
     matrix_t out;
@@ -24,6 +100,7 @@ matrix_t clone_matrix(const matrix_t* matrix)
     out.rows_ = matrix->rows_;
     out.columns_ = matrix->columns_;
     out.data_ = malloc(out.element_size_ * out.rows_ * out.columns_);
+    out.mapping_ = NULL;
     memcpy(out.data_, matrix->data_, out.rows_ * out.columns_ * out.element_size_);
 
     return out;
@@ -45,10 +122,17 @@ void fill_matrix(matrix_t* matrix, const void* data)
 
 void destroy_matrix(matrix_t* matrix)
 {
+    if (matrix->mapping_ != NULL)
+    {
+        write_header_mapped_file(matrix->mapping_, MAPPED_MATRIX_MAGIC, matrix->element_size_, matrix->rows_ * matrix->columns_, matrix->columns_, 0);
+        close_mapped_file(matrix->mapping_);
+        matrix->mapping_ = NULL;
+    }
+    else
+        free(matrix->data_);
     matrix->element_size_ = 0;
     matrix->rows_ = 0;
     matrix->columns_ = 0;
-    free(matrix->data_);
     matrix->data_ = NULL;
 }
 
@@ -56,8 +140,8 @@ void resize_matrix(matrix_t* matrix, size_t rows, size_t columns)
 {
     if (rows != 0 && columns != 0)
     {
-        if (rows * columns > matrix->rows_ * matrix->columns_)
-            matrix->data_ = realloc(matrix->data_, rows * columns * matrix->element_size_);
+        if (!reserve_matrix(matrix, rows * columns * matrix->element_size_))
+            return;
         matrix->rows_ = rows;
         matrix->columns_ = columns;
     }
@@ -65,8 +149,8 @@ void resize_matrix(matrix_t* matrix, size_t rows, size_t columns)
 
 void reuse_matrix(matrix_t* matrix, size_t element_size, size_t rows, size_t columns, const void* data)
 {
-    if (rows * columns * element_size > matrix->columns_ * matrix->rows_ * matrix->element_size_)
-        matrix->data_ = realloc(matrix->data_, rows * columns * element_size);
+    if (!reserve_matrix(matrix, rows * columns * element_size))
+        return;
     matrix->rows_ = rows;
     matrix->columns_ = columns;
     matrix->element_size_ = element_size;
@@ -93,6 +177,21 @@ void* get_element_matrix(const matrix_t* matrix, size_t row, size_t column)
     return matrix->data_ + matrix->element_size_ * ((matrix->columns_ * row) + column);
 }
 
+span_t span_matrix(const matrix_t* matrix)
+{
+    return create_span(matrix->data_, matrix->element_size_, matrix->rows_ * matrix->columns_);
+}
+
+span_t row_span_matrix(const matrix_t* matrix, size_t row)
+{
+    return create_span(matrix->data_ + row * matrix->columns_ * matrix->element_size_, matrix->element_size_, matrix->columns_);
+}
+
+span_t column_span_matrix(const matrix_t* matrix, size_t column)
+{
+    return create_span(matrix->data_ + column * matrix->element_size_, matrix->columns_ * matrix->element_size_, matrix->rows_);
+}
+
 matrix_t create_int_matrix(size_t rows, size_t columns, const int* data)
 {
     return create_matrix(sizeof(int), rows, columns, data);
@@ -14,6 +14,9 @@
 
 #include <stdlib.h>
 
+#include "span.h"
+#include "mapped_file.h"
+
 /**
  * @brief Struct representing a 2D matrix stored in a row major order
  * 
@@ -21,6 +24,7 @@
  * @var columns_ stores the number of columns in the matrix
  * @var element_size_ stores the size in bytes of the elements' type
  * @var data_ stores a pointer to the array of data
+ * @var mapping_ stores the file holding the array of a file backed matrix, NULL if the array is in the heap
  */
 typedef struct data_matrix_st
 {
@@ -28,6 +32,7 @@ typedef struct data_matrix_st
     size_t columns_;
     size_t element_size_;
     void* data_;
+    mapped_file_t* mapping_;
 } matrix_t;
 
 /**
@@ -42,7 +47,49 @@ typedef struct data_matrix_st
 matrix_t create_matrix(size_t element_size, size_t rows, size_t columns, const void* data);
 
 /**
- * @brief Creates an exact deep copy of the given matrix
+ * @brief Create a matrix stored in the file at the given path, which is created or truncated.
+ *        The array is the file mapped in memory, so the matrix is used as any other matrix and its entries reach
+ *        the file without copies. The entries start zeroed. See mapped_file.h.
+ *        If the file cannot be created the matrix has a NULL data_ and no rows.
+ * 
+ * @param path path of the file
+ * @param element_size size in bytes of the data type to be stored
+ * @param rows number of rows of the matrix
+ * @param columns number of columns of the matrix
+ * @return matrix_t 
+ */
+matrix_t create_mapped_matrix(const char* path, size_t element_size, size_t rows, size_t columns);
+
+/**
+ * @brief Opens a matrix stored in a file by a mapped matrix, without reading or copying its entries.
+ *        A matrix opened read-only must not be modified, its pages are shared with every process opening the file.
+ *        If the file cannot be opened or does not hold a matrix the matrix has a NULL data_ and no rows.
+ * 
+ * @param path path of the file
+ * @param read_only 1 to open the matrix read-only, 0 to open it for writing
+ * @return matrix_t 
+ */
+matrix_t open_mapped_matrix(const char* path, int read_only);
+
+/**
+ * @brief Writes the dimensions, element size and checksum of a mapped matrix to its file and waits for the file
+ *        to reach the disk. Does nothing on matrices in the heap or opened read-only.
+ *        destroy_matrix also writes them, without waiting for the disk.
+ * 
+ * @param matrix matrix to be synced
+ */
+void sync_matrix(matrix_t* matrix);
+
+/**
+ * @brief Returns if the entries of a mapped matrix match the checksum written in its file by the last sync
+ * 
+ * @param matrix mapped matrix to be verified
+ * @return 1 if they match, 0 if they do not or the matrix is not mapped
+ */
+int verify_mapped_matrix(const matrix_t* matrix);
+
+/**
+ * @brief Creates an exact deep copy of the given matrix, stored in the heap
  * 
  * @param matrix matrix to be copied
  * @return matrix_t a clone of the matrix passed
@@ -121,6 +168,32 @@ void set_element_matrix(matrix_t* matrix, size_t row, size_t column, const void*
  */
 void* get_element_matrix(const matrix_t* matrix, size_t row, size_t column);
 
+/**
+ * @brief Returns a span over all the elements of the matrix in row-major order
+ * 
+ * @param matrix matrix to be viewed
+ * @return span_t span of rows_ * columns_ elements
+ */
+span_t span_matrix(const matrix_t* matrix);
+
+/**
+ * @brief Returns a span over the elements of the given row of the matrix
+ * 
+ * @param matrix matrix to be viewed
+ * @param row the row to be viewed
+ * @return span_t span of columns_ contiguous elements
+ */
+span_t row_span_matrix(const matrix_t* matrix, size_t row);
+
+/**
+ * @brief Returns a span over the elements of the given column of the matrix, one row apart
+ * 
+ * @param matrix matrix to be viewed
+ * @param column the column to be viewed
+ * @return span_t span of rows_ elements
+ */
+span_t column_span_matrix(const matrix_t* matrix, size_t column);
+
 /**
  * @brief Wrapper for creating an int specialized matrix
  * 
@@ -0,0 +1,631 @@
+#include "matrix_ops.h"
+
+#include <string.h>
+#include <alloca.h>
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MATRIX_OPS_X86
+#endif
+
+/* Cache blocks: MC x KC panels of A stay in L2, KC x NR micro-panels of B stay in L1 */
+#define GEMM_MC 96
+#define GEMM_KC 256
+#define GEMM_NC 2048
+
+/* Register tiles of the micro-kernels (MR rows by NR columns of C) */
+#define GEMM_MR 6
+#define GEMM_NR_FLOAT 16
+#define GEMM_NR_DOUBLE 8
+#define GEMM_NR_INT32 16
+
+#define TRANSPOSE_TILE 32
+
+/* Products smaller than this number of multiply adds always run on the calling thread */
+static const size_t PARALLEL_MIN_WORK = 128 * 128 * 128;
+static const size_t PANEL_ALIGNMENT = 64;
+
+static size_t thread_count = 1;
+
+void set_threads_matrix_ops(size_t threads)
+{
+    thread_count = threads ? threads : 1;
+}
+
+size_t get_threads_matrix_ops(void)
+{
+    return thread_count;
+}
+
+static int has_avx2_fma(void)
+{
+#ifdef MATRIX_OPS_X86
+    static int supported = -1;
+    if (supported < 0)
+    {
+        __builtin_cpu_init();
+        supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    }
+    return supported;
+#else
+    return 0;
+#endif
+}
+
+static inline size_t min_size(size_t left, size_t right)
+{
+    return left < right ? left : right;
+}
+
+static void* alloc_panel(size_t bytes)
+{
+    return aligned_alloc(PANEL_ALIGNMENT, (bytes + PANEL_ALIGNMENT - 1) / PANEL_ALIGNMENT * PANEL_ALIGNMENT);
+}
+
+/*
+ * Row panels: the rows [0, rows) are split in blocks of granularity rows between the threads,
+ * the first panel runs on the calling thread.
+ */
+typedef void (*ROW_RANGE_FUNC)(void* task, size_t begin, size_t end);
+
+typedef struct row_panel_st
+{
+    ROW_RANGE_FUNC func;
+    void* task;
+    size_t begin;
+    size_t end;
+} row_panel;
+
+static void* run_row_panel(void* argument)
+{
+    row_panel* panel = (row_panel*)argument;
+    panel->func(panel->task, panel->begin, panel->end);
+    return NULL;
+}
+
+static void parallel_rows(size_t rows, size_t granularity, size_t work, ROW_RANGE_FUNC func, void* task)
+{
+    size_t panels = (rows + granularity - 1) / granularity;
+    size_t threads = min_size(thread_count, panels);
+    if (threads <= 1 || work < PARALLEL_MIN_WORK)
+    {
+        func(task, 0, rows);
+        return;
+    }
+
+    size_t per_thread = (panels + threads - 1) / threads * granularity;
+    pthread_t* ids = (pthread_t*)alloca(threads * sizeof(pthread_t));
+    row_panel* parts = (row_panel*)alloca(threads * sizeof(row_panel));
+    int* started = (int*)alloca(threads * sizeof(int));
+
+    for (size_t t = 0; t < threads; ++t)
+    {
+        parts[t].func = func;
+        parts[t].task = task;
+        parts[t].begin = min_size(t * per_thread, rows);
+        parts[t].end = min_size((t + 1) * per_thread, rows);
+        started[t] = t != 0 && parts[t].begin < parts[t].end && pthread_create(&ids[t], NULL, run_row_panel, &parts[t]) == 0;
+    }
+
+    run_row_panel(&parts[0]);
+    for (size_t t = 1; t < threads; ++t)
+    {
+        if (started[t])
+            pthread_join(ids[t], NULL);
+        else if (parts[t].begin < parts[t].end)
+            run_row_panel(&parts[t]);
+    }
+}
+
+/*
+ * Generic parts of the kernels for each element type.
+ * T is the element type and ACC the type used for the arithmetic (unsigned for the integers so overflow wraps).
+ */
+#define DEFINE_GEMM(T, ACC, name, NR)                                                                           \
+typedef void (*GEMM_KERNEL_##name)(size_t kc, const T* a, const T* b, T* c, size_t ldc, T alpha, size_t mr, size_t nr); \
+                                                                                                                \
+static void pack_a_##name(const T* a, size_t lda, size_t mc, size_t kc, T* out)                                 \
+{                                                                                                               \
+    for (size_t i = 0; i < mc; i += GEMM_MR)                                                                    \
+    {                                                                                                           \
+        size_t rows = min_size(GEMM_MR, mc - i);                                                                \
+        for (size_t k = 0; k < kc; ++k, out += GEMM_MR)                                                         \
+        {                                                                                                       \
+            for (size_t r = 0; r < rows; ++r)                                                                   \
+                out[r] = a[(i + r) * lda + k];                                                                  \
+            for (size_t r = rows; r < GEMM_MR; ++r)                                                             \
+                out[r] = 0;                                                                                     \
+        }                                                                                                       \
+    }                                                                                                           \
+}                                                                                                               \
+                                                                                                                \
+static void pack_b_##name(const T* b, size_t ldb, size_t kc, size_t nc, T* out)                                 \
+{                                                                                                               \
+    for (size_t j = 0; j < nc; j += NR)                                                                         \
+    {                                                                                                           \
+        size_t columns = min_size(NR, nc - j);                                                                  \
+        for (size_t k = 0; k < kc; ++k, out += NR)                                                              \
+        {                                                                                                       \
+            memcpy(out, b + k * ldb + j, columns * sizeof(T));                                                  \
+            for (size_t c = columns; c < NR; ++c)                                                               \
+                out[c] = 0;                                                                                     \
+        }                                                                                                       \
+    }                                                                                                           \
+}                                                                                                               \
+                                                                                                                \
+static void kernel_scalar_##name(size_t kc, const T* a, const T* b, T* c, size_t ldc, T alpha, size_t mr, size_t nr) \
+{                                                                                                               \
+    ACC acc[GEMM_MR][NR];                                                                                       \
+    memset(acc, 0, sizeof(acc));                                                                                \
+    for (size_t k = 0; k < kc; ++k, a += GEMM_MR, b += NR)                                                      \
+    {                                                                                                           \
+        for (size_t i = 0; i < GEMM_MR; ++i)                                                                    \
+        {                                                                                                       \
+            ACC ai = (ACC)a[i];                                                                                 \
+            for (size_t j = 0; j < NR; ++j)                                                                     \
+                acc[i][j] += ai * (ACC)b[j];                                                                    \
+        }                                                                                                       \
+    }                                                                                                           \
+    for (size_t i = 0; i < mr; ++i)                                                                             \
+    {                                                                                                           \
+        for (size_t j = 0; j < nr; ++j)                                                                         \
+            c[i * ldc + j] = (T)((ACC)c[i * ldc + j] + (ACC)alpha * acc[i][j]);                                 \
+    }                                                                                                           \
+}                                                                                                               \
+                                                                                                                \
+typedef struct gemm_task_##name##_st                                                                            \
+{                                                                                                               \
+    const T* a;                                                                                                 \
+    const T* b;                                                                                                 \
+    T* c;                                                                                                       \
+    size_t n;                                                                                                   \
+    size_t k;                                                                                                   \
+    T alpha;                                                                                                    \
+    T beta;                                                                                                     \
+    GEMM_KERNEL_##name kernel;                                                                                  \
+} gemm_task_##name;                                                                                             \
+                                                                                                                \
+static void gemm_rows_##name(void* argument, size_t begin, size_t end)                                          \
+{                                                                                                               \
+    const gemm_task_##name* task = (const gemm_task_##name*)argument;                                           \
+    size_t n = task->n;                                                                                         \
+    size_t k = task->k;                                                                                         \
+                                                                                                                \
+    for (size_t i = begin; i < end; ++i)                                                                        \
+    {                                                                                                           \
+        T* row = task->c + i * n;                                                                               \
+        if (task->beta == 0)                                                                                    \
+            memset(row, 0, n * sizeof(T));                                                                      \
+        else if (task->beta != 1)                                                                               \
+        {                                                                                                       \
+            for (size_t j = 0; j < n; ++j)                                                                      \
+                row[j] = (T)((ACC)row[j] * (ACC)task->beta);                                                    \
+        }                                                                                                       \
+    }                                                                                                           \
+    if (task->alpha == 0 || k == 0)                                                                             \
+        return;                                                                                                 \
+                                                                                                                \
+    T* packed_a = (T*)alloc_panel(GEMM_MC * GEMM_KC * sizeof(T));                                               \
+    T* packed_b = (T*)alloc_panel(GEMM_KC * GEMM_NC * sizeof(T));                                               \
+                                                                                                                \
+    for (size_t jc = 0; jc < n; jc += GEMM_NC)                                                                  \
+    {                                                                                                           \
+        size_t nc = min_size(GEMM_NC, n - jc);                                                                  \
+        for (size_t pc = 0; pc < k; pc += GEMM_KC)                                                              \
+        {                                                                                                       \
+            size_t kc = min_size(GEMM_KC, k - pc);                                                              \
+            pack_b_##name(task->b + pc * n + jc, n, kc, nc, packed_b);                                          \
+                                                                                                                \
+            for (size_t ic = begin; ic < end; ic += GEMM_MC)                                                    \
+            {                                                                                                   \
+                size_t mc = min_size(GEMM_MC, end - ic);                                                        \
+                pack_a_##name(task->a + ic * k + pc, k, mc, kc, packed_a);                                      \
+                                                                                                                \
+                for (size_t jr = 0; jr < nc; jr += NR)                                                          \
+                {                                                                                               \
+                    for (size_t ir = 0; ir < mc; ir += GEMM_MR)                                                 \
+                    {                                                                                           \
+                        task->kernel(kc, packed_a + ir * kc, packed_b + jr * kc,                                \
+                            task->c + (ic + ir) * n + jc + jr, n, task->alpha,                                  \
+                            min_size(GEMM_MR, mc - ir), min_size(NR, nc - jr));                                 \
+                    }                                                                                           \
+                }                                                                                               \
+            }                                                                                                   \
+        }                                                                                                       \
+    }                                                                                                           \
+                                                                                                                \
+    free(packed_a);                                                                                             \
+    free(packed_b);                                                                                             \
+}                                                                                                               \
+                                                                                                                \
+static void gemm_##name(const matrix_t* a, const matrix_t* b, matrix_t* c, T alpha, T beta, GEMM_KERNEL_##name avx2_kernel) \
+{                                                                                                               \
+    if (a->element_size_ != sizeof(T) || b->element_size_ != sizeof(T) || c->element_size_ != sizeof(T) ||     \
+        a->columns_ != b->rows_ || c->rows_ != a->rows_ || c->columns_ != b->columns_)                          \
+        return;                                                                                                 \
+                                                                                                                \
+    gemm_task_##name task;                                                                                      \
+    task.a = (const T*)a->data_;                                                                                \
+    task.b = (const T*)b->data_;                                                                                \
+    task.c = (T*)c->data_;                                                                                      \
+    task.n = b->columns_;                                                                                       \
+    task.k = a->columns_;                                                                                       \
+    task.alpha = alpha;                                                                                         \
+    task.beta = beta;                                                                                           \
+    task.kernel = avx2_kernel != NULL && has_avx2_fma() ? avx2_kernel : kernel_scalar_##name;                   \
+                                                                                                                \
+    parallel_rows(a->rows_, GEMM_MR, a->rows_ * task.n * task.k, gemm_rows_##name, &task);                     \
+}
+
+DEFINE_GEMM(float, float, float, GEMM_NR_FLOAT)
+DEFINE_GEMM(double, double, double, GEMM_NR_DOUBLE)
+DEFINE_GEMM(int32_t, uint32_t, int32, GEMM_NR_INT32)
+
+#ifdef MATRIX_OPS_X86
+
+/* Two vectors per row of the register tile, one broadcast of A per row and step of k */
+#define TILE_ROW_FMA(i, type, broadcast, fmadd)                                                                 \
+    {                                                                                                           \
+        type ai = broadcast(a + i);                                                                             \
+        c##i##0 = fmadd(ai, b0, c##i##0);                                                                       \
+        c##i##1 = fmadd(ai, b1, c##i##1);                                                                       \
+    }
+
+#define TILE_ROWS(macro) macro(0) macro(1) macro(2) macro(3) macro(4) macro(5)
+
+__attribute__((target("avx2,fma")))
+static void kernel_avx2_float(size_t kc, const float* a, const float* b, float* c, size_t ldc, float alpha, size_t mr, size_t nr)
+{
+#define DECLARE_ROW(i) __m256 c##i##0 = _mm256_setzero_ps(), c##i##1 = _mm256_setzero_ps();
+#define FMA_ROW(i) TILE_ROW_FMA(i, __m256, _mm256_broadcast_ss, _mm256_fmadd_ps)
+#define STORE_ROW(i)                                                                                            \
+    _mm256_storeu_ps(c + i * ldc, _mm256_fmadd_ps(scale, c##i##0, _mm256_loadu_ps(c + i * ldc)));               \
+    _mm256_storeu_ps(c + i * ldc + 8, _mm256_fmadd_ps(scale, c##i##1, _mm256_loadu_ps(c + i * ldc + 8)));
+#define SPILL_ROW(i)                                                                                            \
+    _mm256_storeu_ps(tile[i], c##i##0);                                                                         \
+    _mm256_storeu_ps(tile[i] + 8, c##i##1);
+
+    TILE_ROWS(DECLARE_ROW)
+    for (size_t k = 0; k < kc; ++k, a += GEMM_MR, b += GEMM_NR_FLOAT)
+    {
+        __m256 b0 = _mm256_load_ps(b);
+        __m256 b1 = _mm256_load_ps(b + 8);
+        TILE_ROWS(FMA_ROW)
+    }
+
+    __m256 scale = _mm256_set1_ps(alpha);
+    if (mr == GEMM_MR && nr == GEMM_NR_FLOAT)
+    {
+        TILE_ROWS(STORE_ROW)
+        return;
+    }
+
+    float tile[GEMM_MR][GEMM_NR_FLOAT];
+    TILE_ROWS(SPILL_ROW)
+    for (size_t i = 0; i < mr; ++i)
+    {
+        for (size_t j = 0; j < nr; ++j)
+            c[i * ldc + j] += alpha * tile[i][j];
+    }
+
+#undef DECLARE_ROW
+#undef FMA_ROW
+#undef STORE_ROW
+#undef SPILL_ROW
+}
+
+__attribute__((target("avx2,fma")))
+static void kernel_avx2_double(size_t kc, const double* a, const double* b, double* c, size_t ldc, double alpha, size_t mr, size_t nr)
+{
+#define DECLARE_ROW(i) __m256d c##i##0 = _mm256_setzero_pd(), c##i##1 = _mm256_setzero_pd();
+#define FMA_ROW(i) TILE_ROW_FMA(i, __m256d, _mm256_broadcast_sd, _mm256_fmadd_pd)
+#define STORE_ROW(i)                                                                                            \
+    _mm256_storeu_pd(c + i * ldc, _mm256_fmadd_pd(scale, c##i##0, _mm256_loadu_pd(c + i * ldc)));               \
+    _mm256_storeu_pd(c + i * ldc + 4, _mm256_fmadd_pd(scale, c##i##1, _mm256_loadu_pd(c + i * ldc + 4)));
+#define SPILL_ROW(i)                                                                                            \
+    _mm256_storeu_pd(tile[i], c##i##0);                                                                         \
+    _mm256_storeu_pd(tile[i] + 4, c##i##1);
+
+    TILE_ROWS(DECLARE_ROW)
+    for (size_t k = 0; k < kc; ++k, a += GEMM_MR, b += GEMM_NR_DOUBLE)
+    {
+        __m256d b0 = _mm256_load_pd(b);
+        __m256d b1 = _mm256_load_pd(b + 4);
+        TILE_ROWS(FMA_ROW)
+    }
+
+    __m256d scale = _mm256_set1_pd(alpha);
+    if (mr == GEMM_MR && nr == GEMM_NR_DOUBLE)
+    {
+        TILE_ROWS(STORE_ROW)
+        return;
+    }
+
+    double tile[GEMM_MR][GEMM_NR_DOUBLE];
+    TILE_ROWS(SPILL_ROW)
+    for (size_t i = 0; i < mr; ++i)
+    {
+        for (size_t j = 0; j < nr; ++j)
+            c[i * ldc + j] += alpha * tile[i][j];
+    }
+
+#undef DECLARE_ROW
+#undef FMA_ROW
+#undef STORE_ROW
+#undef SPILL_ROW
+}
+
+__attribute__((target("avx2")))
+static inline __m256i broadcast_epi32(const int32_t* value)
+{
+    return _mm256_set1_epi32(*value);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i fmadd_epi32(__m256i left, __m256i right, __m256i add)
+{
+    return _mm256_add_epi32(_mm256_mullo_epi32(left, right), add);
+}
+
+__attribute__((target("avx2,fma")))
+static void kernel_avx2_int32(size_t kc, const int32_t* a, const int32_t* b, int32_t* c, size_t ldc, int32_t alpha, size_t mr, size_t nr)
+{
+#define DECLARE_ROW(i) __m256i c##i##0 = _mm256_setzero_si256(), c##i##1 = _mm256_setzero_si256();
+#define FMA_ROW(i) TILE_ROW_FMA(i, __m256i, broadcast_epi32, fmadd_epi32)
+#define STORE_ROW(i)                                                                                            \
+    _mm256_storeu_si256((__m256i*)(c + i * ldc),                                                                \
+        fmadd_epi32(scale, c##i##0, _mm256_loadu_si256((const __m256i*)(c + i * ldc))));                         \
+    _mm256_storeu_si256((__m256i*)(c + i * ldc + 8),                                                            \
+        fmadd_epi32(scale, c##i##1, _mm256_loadu_si256((const __m256i*)(c + i * ldc + 8))));
+#define SPILL_ROW(i)                                                                                            \
+    _mm256_storeu_si256((__m256i*)tile[i], c##i##0);                                                            \
+    _mm256_storeu_si256((__m256i*)(tile[i] + 8), c##i##1);
+
+    TILE_ROWS(DECLARE_ROW)
+    for (size_t k = 0; k < kc; ++k, a += GEMM_MR, b += GEMM_NR_INT32)
+    {
+        __m256i b0 = _mm256_load_si256((const __m256i*)b);
+        __m256i b1 = _mm256_load_si256((const __m256i*)(b + 8));
+        TILE_ROWS(FMA_ROW)
+    }
+
+    __m256i scale = _mm256_set1_epi32(alpha);
+    if (mr == GEMM_MR && nr == GEMM_NR_INT32)
+    {
+        TILE_ROWS(STORE_ROW)
+        return;
+    }
+
+    uint32_t tile[GEMM_MR][GEMM_NR_INT32];
+    TILE_ROWS(SPILL_ROW)
+    for (size_t i = 0; i < mr; ++i)
+    {
+        for (size_t j = 0; j < nr; ++j)
+            c[i * ldc + j] = (int32_t)((uint32_t)c[i * ldc + j] + (uint32_t)alpha * tile[i][j]);
+    }
+
+#undef DECLARE_ROW
+#undef FMA_ROW
+#undef STORE_ROW
+#undef SPILL_ROW
+}
+
+#define AVX2_KERNEL(name) kernel_avx2_##name
+#else
+#define AVX2_KERNEL(name) NULL
+#endif
+
+void gemm_float_matrix(const matrix_t* a, const matrix_t* b, matrix_t* c, float alpha, float beta)
+{
+    gemm_float(a, b, c, alpha, beta, AVX2_KERNEL(float));
+}
+
+void gemm_double_matrix(const matrix_t* a, const matrix_t* b, matrix_t* c, double alpha, double beta)
+{
+    gemm_double(a, b, c, alpha, beta, AVX2_KERNEL(double));
+}
+
+void gemm_int32_matrix(const matrix_t* a, const matrix_t* b, matrix_t* c, int32_t alpha, int32_t beta)
+{
+    gemm_int32(a, b, c, alpha, beta, AVX2_KERNEL(int32));
+}
+
+/*
+ * Matrix vector products: every row of A is a dot product with x. The dot products are written once and
+ * compiled twice, with and without AVX2/FMA enabled, so the compiler vectorizes each for its target.
+ */
+#define DEFINE_DOT(T, ACC, name, attributes)                                                                    \
+attributes static ACC dot_##name(const T* row, const T* x, size_t n)                                            \
+{                                                                                                               \
+    ACC sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;                                                                 \
+    size_t j = 0;                                                                                               \
+    for (; j + 4 <= n; j += 4)                                                                                  \
+    {                                                                                                           \
+        sum0 += (ACC)row[j] * (ACC)x[j];                                                                        \
+        sum1 += (ACC)row[j + 1] * (ACC)x[j + 1];                                                                \
+        sum2 += (ACC)row[j + 2] * (ACC)x[j + 2];                                                                \
+        sum3 += (ACC)row[j + 3] * (ACC)x[j + 3];                                                                \
+    }                                                                                                           \
+    for (; j < n; ++j)                                                                                          \
+        sum0 += (ACC)row[j] * (ACC)x[j];                                                                        \
+    return (sum0 + sum1) + (sum2 + sum3);                                                                       \
+}
+
+#define DEFINE_GEMV(T, ACC, name)                                                                               \
+DEFINE_DOT(T, ACC, scalar_##name, )                                                                             \
+                                                                                                                \
+typedef struct gemv_task_##name##_st                                                                            \
+{                                                                                                               \
+    const T* a;                                                                                                 \
+    const T* x;                                                                                                 \
+    T* y;                                                                                                       \
+    size_t n;                                                                                                   \
+    T alpha;                                                                                                    \
+    T beta;                                                                                                     \
+    ACC (*dot)(const T* row, const T* x, size_t n);                                                             \
+} gemv_task_##name;                                                                                             \
+                                                                                                                \
+static void gemv_rows_##name(void* argument, size_t begin, size_t end)                                          \
+{                                                                                                               \
+    const gemv_task_##name* task = (const gemv_task_##name*)argument;                                           \
+    for (size_t i = begin; i < end; ++i)                                                                        \
+    {                                                                                                           \
+        ACC product = (ACC)task->alpha * task->dot(task->a + i * task->n, task->x, task->n);                    \
+        task->y[i] = (T)(task->beta == 0 ? product : product + (ACC)task->beta * (ACC)task->y[i]);              \
+    }                                                                                                           \
+}                                                                                                               \
+                                                                                                                \
+static void gemv_##name(const matrix_t* a, const vector_t* x, vector_t* y, T alpha, T beta,                    \
+    ACC (*avx2_dot)(const T*, const T*, size_t))                                                                \
+{                                                                                                               \
+    if (a->element_size_ != sizeof(T) || x->element_size_ != sizeof(T) || y->element_size_ != sizeof(T) ||     \
+        a->columns_ != x->dimensions_ || a->rows_ != y->dimensions_)                                            \
+        return;                                                                                                 \
+                                                                                                                \
+    gemv_task_##name task;                                                                                      \
+    task.a = (const T*)a->data_;                                                                                \
+    task.x = (const T*)x->data_;                                                                                \
+    task.y = (T*)y->data_;                                                                                      \
+    task.n = a->columns_;                                                                                       \
+    task.alpha = alpha;                                                                                         \
+    task.beta = beta;                                                                                           \
+    task.dot = avx2_dot != NULL && has_avx2_fma() ? avx2_dot : dot_scalar_##name;                               \
+                                                                                                                \
+    parallel_rows(a->rows_, GEMM_MC, a->rows_ * a->columns_ * 64, gemv_rows_##name, &task);                     \
+}
+
+DEFINE_GEMV(float, float, float)
+DEFINE_GEMV(double, double, double)
+DEFINE_GEMV(int32_t, uint32_t, int32)
+
+#ifdef MATRIX_OPS_X86
+DEFINE_DOT(float, float, avx2_float, __attribute__((target("avx2,fma"))))
+DEFINE_DOT(double, double, avx2_double, __attribute__((target("avx2,fma"))))
+DEFINE_DOT(int32_t, uint32_t, avx2_int32, __attribute__((target("avx2,fma"))))
+#define AVX2_DOT(name) dot_avx2_##name
+#else
+#define AVX2_DOT(name) NULL
+#endif
+
+void gemv_float_matrix(const matrix_t* a, const vector_t* x, vector_t* y, float alpha, float beta)
+{
+    gemv_float(a, x, y, alpha, beta, AVX2_DOT(float));
+}
+
+void gemv_double_matrix(const matrix_t* a, const vector_t* x, vector_t* y, double alpha, double beta)
+{
+    gemv_double(a, x, y, alpha, beta, AVX2_DOT(double));
+}
+
+void gemv_int32_matrix(const matrix_t* a, const vector_t* x, vector_t* y, int32_t alpha, int32_t beta)
+{
+    gemv_int32(a, x, y, alpha, beta, AVX2_DOT(int32));
+}
+
+#define DEFINE_TRANSPOSE(T, name)                                                                               \
+static void transpose_tiles_##name(const T* source, T* destination, size_t rows, size_t columns)                \
+{                                                                                                               \
+    for (size_t ii = 0; ii < rows; ii += TRANSPOSE_TILE)                                                        \
+    {                                                                                                           \
+        size_t i_end = min_size(ii + TRANSPOSE_TILE, rows);                                                     \
+        for (size_t jj = 0; jj < columns; jj += TRANSPOSE_TILE)                                                 \
+        {                                                                                                       \
+            size_t j_end = min_size(jj + TRANSPOSE_TILE, columns);                                              \
+            for (size_t i = ii; i < i_end; ++i)                                                                 \
+            {                                                                                                   \
+                for (size_t j = jj; j < j_end; ++j)                                                             \
+                    destination[j * rows + i] = source[i * columns + j];                                        \
+            }                                                                                                   \
+        }                                                                                                       \
+    }                                                                                                           \
+}
+
+DEFINE_TRANSPOSE(uint32_t, 32)
+DEFINE_TRANSPOSE(uint64_t, 64)
+
+void transpose_matrix(const matrix_t* source, matrix_t* destination)
+{
+    size_t rows = source->rows_;
+    size_t columns = source->columns_;
+    size_t element_size = source->element_size_;
+
+    reuse_matrix(destination, element_size, columns, rows, NULL);
+
+    if (element_size == sizeof(uint32_t))
+        transpose_tiles_32(source->data_, destination->data_, rows, columns);
+    else if (element_size == sizeof(uint64_t))
+        transpose_tiles_64(source->data_, destination->data_, rows, columns);
+    else
+    {
+        for (size_t ii = 0; ii < rows; ii += TRANSPOSE_TILE)
+        {
+            for (size_t jj = 0; jj < columns; jj += TRANSPOSE_TILE)
+            {
+                for (size_t i = ii; i < min_size(ii + TRANSPOSE_TILE, rows); ++i)
+                {
+                    for (size_t j = jj; j < min_size(jj + TRANSPOSE_TILE, columns); ++j)
+                        memcpy(destination->data_ + (j * rows + i) * element_size, source->data_ + (i * columns + j) * element_size, element_size);
+                }
+            }
+        }
+    }
+}
+
+/* Elementwise kernels, compiled for the baseline and for AVX2 like the dot products */
+#define DEFINE_ELEMENTWISE_KERNELS(T, ACC, name, attributes)                                                    \
+attributes static void add_##name(const T* left, const T* right, T* out, size_t count)                          \
+{                                                                                                               \
+    for (size_t i = 0; i < count; ++i)                                                                          \
+        out[i] = (T)((ACC)left[i] + (ACC)right[i]);                                                             \
+}                                                                                                               \
+                                                                                                                \
+attributes static void scale_##name(T* data, size_t count, T scalar)                                            \
+{                                                                                                               \
+    for (size_t i = 0; i < count; ++i)                                                                          \
+        data[i] = (T)((ACC)data[i] * (ACC)scalar);                                                              \
+}
+
+#define DEFINE_ELEMENTWISE(T, ACC, name)                                                                        \
+DEFINE_ELEMENTWISE_KERNELS(T, ACC, scalar_##name, )                                                             \
+ELEMENTWISE_AVX2(T, ACC, name)                                                                                  \
+                                                                                                                \
+void add_##name##_matrix(const matrix_t* left, const matrix_t* right, matrix_t* out)                            \
+{                                                                                                               \
+    if (left->element_size_ != sizeof(T) || right->element_size_ != sizeof(T) || out->element_size_ != sizeof(T) || \
+        left->rows_ != right->rows_ || left->columns_ != right->columns_ ||                                     \
+        out->rows_ != left->rows_ || out->columns_ != left->columns_)                                           \
+        return;                                                                                                 \
+                                                                                                                \
+    size_t count = left->rows_ * left->columns_;                                                                \
+    if (has_avx2_fma())                                                                                         \
+        ADD_AVX2(name, left->data_, right->data_, out->data_, count);                                           \
+    else                                                                                                        \
+        add_scalar_##name(left->data_, right->data_, out->data_, count);                                        \
+}                                                                                                               \
+                                                                                                                \
+void scale_##name##_matrix(matrix_t* matrix, T scalar)                                                          \
+{                                                                                                               \
+    if (matrix->element_size_ != sizeof(T))                                                                     \
+        return;                                                                                                 \
+                                                                                                                \
+    size_t count = matrix->rows_ * matrix->columns_;                                                            \
+    if (has_avx2_fma())                                                                                         \
+        SCALE_AVX2(name, matrix->data_, count, scalar);                                                         \
+    else                                                                                                        \
+        scale_scalar_##name(matrix->data_, count, scalar);                                                      \
+}
+
+#ifdef MATRIX_OPS_X86
+#define ELEMENTWISE_AVX2(T, ACC, name) DEFINE_ELEMENTWISE_KERNELS(T, ACC, avx2_##name, __attribute__((target("avx2,fma"))))
+#define ADD_AVX2(name, left, right, out, count) add_avx2_##name(left, right, out, count)
+#define SCALE_AVX2(name, data, count, scalar) scale_avx2_##name(data, count, scalar)
+#else
+#define ELEMENTWISE_AVX2(T, ACC, name)
+#define ADD_AVX2(name, left, right, out, count) add_scalar_##name(left, right, out, count)
+#define SCALE_AVX2(name, data, count, scalar) scale_scalar_##name(data, count, scalar)
+#endif
+
+DEFINE_ELEMENTWISE(float, float, float)
+DEFINE_ELEMENTWISE(double, double, double)
+DEFINE_ELEMENTWISE(int32_t, uint32_t, int32)
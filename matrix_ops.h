@@ -0,0 +1,177 @@
+#ifndef DATA_MATRIX_OPS_H
+#define DATA_MATRIX_OPS_H
+
+/**
+ * @file matrix_ops.h
+ * @author Edwin Solis (edwinsolisf12@gmail.com)
+ * @brief Typed arithmetic kernels on matrix_t and vector_t
+ * @version 0.1
+ * @date 2021-11-08
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include "matrix.h"
+#include "vector.h"
+
+#include <stdint.h>
+
+/**
+ * @details Implementation
+ * 
+ * The kernels interpret the type erased data of the matrices as float, double or int32_t, so the element_size_
+ * of every operand must match the type of the function. Operands with mismatched dimensions or element sizes
+ * are left untouched.
+ * 
+ * The matrix products are cache blocked: blocks of B (KC x NC) and A (MC x KC) are packed into contiguous
+ * panels sized for the L1 and L2 caches, and a register blocked micro-kernel computes MR x NR tiles of C.
+ * On x86 the micro-kernels use AVX2/FMA when the running CPU supports them (checked once at runtime), otherwise
+ * a portable scalar kernel is used.
+ * 
+ * Products can be split over threads by blocks of rows of C (row panels), each thread packing its own panels.
+ * The number of threads is a global setting and defaults to 1.
+ * 
+ */
+
+/**
+ * @brief Sets the number of threads used by the matrix products
+ * 
+ * @param threads number of threads (0 or 1 runs on the calling thread)
+ */
+void set_threads_matrix_ops(size_t threads);
+
+/**
+ * @brief Returns the number of threads used by the matrix products
+ * 
+ * @return size_t number of threads
+ */
+size_t get_threads_matrix_ops(void);
+
+/**
+ * @brief General matrix product of floats: c = alpha * a * b + beta * c
+ * 
+ * @param a left matrix (m x k)
+ * @param b right matrix (k x n)
+ * @param c result matrix (m x n), must not alias a or b
+ * @param alpha scale of the product
+ * @param beta scale of the previous contents of c (0 ignores them)
+ */
+void gemm_float_matrix(const matrix_t* a, const matrix_t* b, matrix_t* c, float alpha, float beta);
+
+/**
+ * @brief General matrix product of doubles: c = alpha * a * b + beta * c
+ * 
+ * @param a left matrix (m x k)
+ * @param b right matrix (k x n)
+ * @param c result matrix (m x n), must not alias a or b
+ * @param alpha scale of the product
+ * @param beta scale of the previous contents of c (0 ignores them)
+ */
+void gemm_double_matrix(const matrix_t* a, const matrix_t* b, matrix_t* c, double alpha, double beta);
+
+/**
+ * @brief General matrix product of 32 bit integers: c = alpha * a * b + beta * c (wrapping on overflow)
+ * 
+ * @param a left matrix (m x k)
+ * @param b right matrix (k x n)
+ * @param c result matrix (m x n), must not alias a or b
+ * @param alpha scale of the product
+ * @param beta scale of the previous contents of c (0 ignores them)
+ */
+void gemm_int32_matrix(const matrix_t* a, const matrix_t* b, matrix_t* c, int32_t alpha, int32_t beta);
+
+/**
+ * @brief Matrix vector product of floats: y = alpha * a * x + beta * y
+ * 
+ * @param a matrix (m x n)
+ * @param x vector of n dimensions
+ * @param y result vector of m dimensions, must not alias x
+ * @param alpha scale of the product
+ * @param beta scale of the previous contents of y (0 ignores them)
+ */
+void gemv_float_matrix(const matrix_t* a, const vector_t* x, vector_t* y, float alpha, float beta);
+
+/**
+ * @brief Matrix vector product of doubles: y = alpha * a * x + beta * y
+ * 
+ * @param a matrix (m x n)
+ * @param x vector of n dimensions
+ * @param y result vector of m dimensions, must not alias x
+ * @param alpha scale of the product
+ * @param beta scale of the previous contents of y (0 ignores them)
+ */
+void gemv_double_matrix(const matrix_t* a, const vector_t* x, vector_t* y, double alpha, double beta);
+
+/**
+ * @brief Matrix vector product of 32 bit integers: y = alpha * a * x + beta * y (wrapping on overflow)
+ * 
+ * @param a matrix (m x n)
+ * @param x vector of n dimensions
+ * @param y result vector of m dimensions, must not alias x
+ * @param alpha scale of the product
+ * @param beta scale of the previous contents of y (0 ignores them)
+ */
+void gemv_int32_matrix(const matrix_t* a, const vector_t* x, vector_t* y, int32_t alpha, int32_t beta);
+
+/**
+ * @brief Writes the transpose of the source matrix into the destination, which is reshaped to columns x rows.
+ *        Works with any element size, in square tiles so both matrices are accessed a few cache lines at a time.
+ * 
+ * @param source matrix to be transposed
+ * @param destination matrix to be written to, must not alias the source
+ */
+void transpose_matrix(const matrix_t* source, matrix_t* destination);
+
+/**
+ * @brief Elementwise sum of floats: out = left + right (out can alias any operand)
+ * 
+ * @param left left matrix
+ * @param right right matrix
+ * @param out result matrix of the same dimensions
+ */
+void add_float_matrix(const matrix_t* left, const matrix_t* right, matrix_t* out);
+
+/**
+ * @brief Elementwise sum of doubles: out = left + right (out can alias any operand)
+ * 
+ * @param left left matrix
+ * @param right right matrix
+ * @param out result matrix of the same dimensions
+ */
+void add_double_matrix(const matrix_t* left, const matrix_t* right, matrix_t* out);
+
+/**
+ * @brief Elementwise sum of 32 bit integers: out = left + right (out can alias any operand)
+ * 
+ * @param left left matrix
+ * @param right right matrix
+ * @param out result matrix of the same dimensions
+ */
+void add_int32_matrix(const matrix_t* left, const matrix_t* right, matrix_t* out);
+
+/**
+ * @brief Multiplies every entry of a float matrix by the given scalar
+ * 
+ * @param matrix matrix to be scaled
+ * @param scalar scale factor
+ */
+void scale_float_matrix(matrix_t* matrix, float scalar);
+
+/**
+ * @brief Multiplies every entry of a double matrix by the given scalar
+ * 
+ * @param matrix matrix to be scaled
+ * @param scalar scale factor
+ */
+void scale_double_matrix(matrix_t* matrix, double scalar);
+
+/**
+ * @brief Multiplies every entry of a 32 bit integer matrix by the given scalar
+ * 
+ * @param matrix matrix to be scaled
+ * @param scalar scale factor
+ */
+void scale_int32_matrix(matrix_t* matrix, int32_t scalar);
+
+#endif /* DATA_MATRIX_OPS_H */
@@ -0,0 +1,113 @@
+#include "node_pool.h"
+
+static const size_t SLAB_BYTES = 64 * 1024;
+static const size_t MIN_NODES_PER_SLAB = 16;
+
+node_pool_t create_node_pool(size_t node_size, size_t nodes_per_slab)
+{
+    node_pool_t out;
+
+    out.node_size_ = (node_size + sizeof(void*) - 1) / sizeof(void*) * sizeof(void*);
+    if (out.node_size_ < sizeof(void*))
+        out.node_size_ = sizeof(void*);
+
+    if (nodes_per_slab == 0)
+        nodes_per_slab = SLAB_BYTES / out.node_size_;
+    out.nodes_per_slab_ = nodes_per_slab < MIN_NODES_PER_SLAB ? MIN_NODES_PER_SLAB : nodes_per_slab;
+
+    out.slabs_ = NULL;
+    out.free_list_ = NULL;
+    out.next_ = NULL;
+    out.end_ = NULL;
+
+    return out;
+}
+
+void destroy_node_pool(node_pool_t* pool)
+{
+    clear_node_pool(pool);
+    pool->node_size_ = 0;
+    pool->nodes_per_slab_ = 0;
+}
+
+void clear_node_pool(node_pool_t* pool)
+{
+    void* slab = pool->slabs_;
+    while (slab != NULL)
+    {
+        void* previous = *(void**)slab;
+        free(slab);
+        slab = previous;
+    }
+
+    pool->slabs_ = NULL;
+    pool->free_list_ = NULL;
+    pool->next_ = NULL;
+    pool->end_ = NULL;
+}
+
+void* alloc_node_pool(node_pool_t* pool)
+{
+    if (pool->free_list_ != NULL)
+    {
+        void* node = pool->free_list_;
+        pool->free_list_ = *(void**)node;
+        return node;
+    }
+
+    if (pool->next_ == pool->end_)
+    {
+        void* slab = malloc(sizeof(void*) + pool->nodes_per_slab_ * pool->node_size_);
+        *(void**)slab = pool->slabs_;
+        pool->slabs_ = slab;
+        pool->next_ = slab + sizeof(void*);
+        pool->end_ = pool->next_ + pool->nodes_per_slab_ * pool->node_size_;
+    }
+
+    void* node = pool->next_;
+    pool->next_ += pool->node_size_;
+    return node;
+}
+
+void free_node_pool(node_pool_t* pool, void* node)
+{
+    *(void**)node = pool->free_list_;
+    pool->free_list_ = node;
+}
+
+void merge_node_pool(node_pool_t* pool, node_pool_t* source)
+{
+    if (source->slabs_ == NULL)
+        return;
+
+    /* The uncarved tail of the source slab is dropped, the slab list keeps the current slab of the pool first */
+    void* last = source->slabs_;
+    while (*(void**)last != NULL)
+        last = *(void**)last;
+
+    if (pool->slabs_ == NULL)
+    {
+        pool->slabs_ = source->slabs_;
+        pool->next_ = source->next_;
+        pool->end_ = source->end_;
+    }
+    else
+    {
+        *(void**)last = *(void**)pool->slabs_;
+        *(void**)pool->slabs_ = source->slabs_;
+    }
+
+    if (source->free_list_ != NULL)
+    {
+        void* tail = source->free_list_;
+        while (*(void**)tail != NULL)
+            tail = *(void**)tail;
+        *(void**)tail = pool->free_list_;
+        pool->free_list_ = source->free_list_;
+    }
+
+    source->slabs_ = NULL;
+    source->free_list_ = NULL;
+    source->next_ = NULL;
+    source->end_ = NULL;
+}
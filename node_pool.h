@@ -0,0 +1,96 @@
+#ifndef DATA_NODE_POOL_H
+#define DATA_NODE_POOL_H
+
+/**
+ * @file node_pool.h
+ * @author Edwin Solis (edwinsolisf12@gmail.com)
+ * @brief A slab allocator of fixed size nodes for the linked containers
+ * @version 0.1
+ * @date 2021-11-05
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <stdlib.h>
+
+/**
+ * @details Implementation
+ * 
+ * Nodes are carved sequentially out of slabs that hold a fixed number of nodes, so nodes allocated one after
+ * the other are adjacent in memory. Released nodes are kept in an intrusive free list (the first bytes of a
+ * free node store the next free node) and are reused before carving new ones.
+ * The slabs are only returned to the system when the pool is cleared or destroyed.
+ * 
+ */
+
+/**
+ * @brief Struct representing a pool of nodes
+ * 
+ * @var node_size_ stores the size in bytes of each node (rounded up to a multiple of the pointer size)
+ * @var nodes_per_slab_ stores the number of nodes of each slab
+ * @var slabs_ stores the pointer to the last allocated slab, each slab starts with the pointer to the previous one
+ * @var free_list_ stores the pointer to the first released node
+ * @var next_ stores the pointer to the next node not yet carved from the last slab
+ * @var end_ stores the pointer to the end of the last slab
+ */
+typedef struct data_node_pool_st
+{
+    size_t node_size_;
+    size_t nodes_per_slab_;
+    void* slabs_;
+    void* free_list_;
+    void* next_;
+    void* end_;
+} node_pool_t;
+
+/**
+ * @brief Create an empty node pool. No memory is allocated until the first node is requested
+ * 
+ * @param node_size size in bytes of the nodes
+ * @param nodes_per_slab number of nodes allocated at once (0 chooses a default)
+ * @return node_pool_t 
+ */
+node_pool_t create_node_pool(size_t node_size, size_t nodes_per_slab);
+
+/**
+ * @brief Destroys the pool and releases all its slabs, including the nodes still in use
+ * 
+ * @param pool pool to be destroyed
+ */
+void destroy_node_pool(node_pool_t* pool);
+
+/**
+ * @brief Releases all the slabs of the pool, invalidating every node, but keeps it usable
+ * 
+ * @param pool pool to be cleared
+ */
+void clear_node_pool(node_pool_t* pool);
+
+/**
+ * @brief Returns an uninitialized node from the pool
+ * 
+ * @param pool pool to allocate from
+ * @return void* pointer to the node
+ */
+void* alloc_node_pool(node_pool_t* pool);
+
+/**
+ * @brief Returns the node to the pool so it can be reused
+ * 
+ * @param pool pool the node was allocated from
+ * @param node node to be released
+ */
+void free_node_pool(node_pool_t* pool, void* node);
+
+/**
+ * @brief Moves all the slabs and released nodes of the source pool to the destination pool, so the nodes
+ *        allocated from the source become owned by the destination. The source is left empty.
+ *        Both pools must have the same node size.
+ * 
+ * @param pool pool that takes the nodes
+ * @param source pool that gives its nodes away
+ */
+void merge_node_pool(node_pool_t* pool, node_pool_t* source);
+
+#endif /* DATA_NODE_POOL_H */
@@ -1,6 +1,7 @@
 #include "ordered_map.h"
 
 #include <string.h>
+#include <alloca.h>
 
 ordered_map_t create_ordered_map(size_t key_size, size_t value_size, size_t capacity, LESS_THAN_FUNC order_function)
 {
@@ -12,33 +13,154 @@ ordered_map_t create_ordered_map(size_t key_size, size_t value_size, size_t capa
     out.size_ = 0;
     out.data_ = malloc((key_size + value_size) * capacity);
     out.order_func_ = order_function;
+    out.backend_ = ORDERED_ARRAY_BACKEND;
+    out.key_kind_ = KEY_KIND_CUSTOM;
+    out.borrowed_ = 0;
 
     return out;
 }
 
+ordered_map_t create_ordered_map_in_buffer(size_t key_size, size_t value_size, void* buffer, size_t capacity, LESS_THAN_FUNC order_function)
+{
+    ordered_map_t out;
+
+    out.capacity_ = capacity;
+    out.key_size_ = key_size;
+    out.value_size_ = value_size;
+    out.size_ = 0;
+    out.data_ = buffer;
+    out.order_func_ = order_function;
+    out.backend_ = ORDERED_ARRAY_BACKEND;
+    out.key_kind_ = KEY_KIND_CUSTOM;
+    out.borrowed_ = 1;
+
+    return out;
+}
+
+static inline btree_t* tree_ordered_map(const ordered_map_t* map)
+{
+    return (btree_t*)map->data_;
+}
+
+/* Position of the first pair with a key not less than the given one in the array backend */
+static inline void* search_ordered_map(const ordered_map_t* map, const void* key)
+{
+    return (void*)binary_search_kind(key, map->data_, map->size_, map->key_size_ + map->value_size_, map->key_kind_, map->order_func_);
+}
+
+static inline int found_ordered_map(const ordered_map_t* map, const void* position, const void* key)
+{
+    return position != map->data_ + map->size_ * (map->key_size_ + map->value_size_) &&
+        equal_kind(position, key, map->key_kind_, map->order_func_);
+}
+
+ordered_map_t create_btree_ordered_map(size_t key_size, size_t value_size, LESS_THAN_FUNC order_function)
+{
+    ordered_map_t out;
+
+    out.capacity_ = SIZE_MAX;
+    out.key_size_ = key_size;
+    out.value_size_ = value_size;
+    out.size_ = 0;
+    out.data_ = malloc(sizeof(btree_t));
+    out.order_func_ = order_function;
+    out.backend_ = ORDERED_BTREE_BACKEND;
+    out.key_kind_ = KEY_KIND_CUSTOM;
+    out.borrowed_ = 0;
+    *tree_ordered_map(&out) = create_btree(key_size + value_size, key_size, order_function);
+
+    return out;
+}
+
+void set_backend_ordered_map(ordered_map_t* map, ordered_backend_t backend)
+{
+    if (map->backend_ == backend)
+        return;
+
+    size_t pair_size = map->key_size_ + map->value_size_;
+    if (backend == ORDERED_BTREE_BACKEND)
+    {
+        ordered_map_t out = create_btree_ordered_map(map->key_size_, map->value_size_, map->order_func_);
+        for (size_t i = 0; i < map->size_; ++i)
+            insert_btree(tree_ordered_map(&out), map->data_ + i * pair_size);
+        out.size_ = map->size_;
+        set_key_kind_ordered_map(&out, map->key_kind_);
+        destroy_ordered_map(map);
+        *map = out;
+    }
+    else
+    {
+        ordered_map_t out = create_ordered_map(map->key_size_, map->value_size_, map->size_, map->order_func_);
+        btree_cursor_t cursor = begin_btree(tree_ordered_map(map));
+        for (; cursor.leaf_ != NULL; next_btree_cursor(&cursor))
+            memcpy(out.data_ + out.size_++ * pair_size, get_btree_cursor(tree_ordered_map(map), &cursor), pair_size);
+        out.key_kind_ = map->key_kind_;
+        destroy_ordered_map(map);
+        *map = out;
+    }
+}
+
+void set_key_kind_ordered_map(ordered_map_t* map, key_kind_t kind)
+{
+    map->key_kind_ = kind;
+    if (map->backend_ == ORDERED_BTREE_BACKEND)
+        tree_ordered_map(map)->key_kind_ = kind;
+}
+
 void destroy_ordered_map(ordered_map_t* map)
 {
+    if (map->backend_ == ORDERED_BTREE_BACKEND)
+        destroy_btree(tree_ordered_map(map));
     map->capacity_ = 0;
     map->size_ = 0;
     map->key_size_ = 0;
     map->value_size_ = 0;
     map->order_func_ = NULL;
-    free(map->data_);
+    map->backend_ = ORDERED_ARRAY_BACKEND;
+    if (!map->borrowed_)
+        free(map->data_);
+    map->data_ = NULL;
+    map->borrowed_ = 0;
 }
 
 void reserve_ordered_map(ordered_map_t* map, size_t new_capacity)
 {
     if (new_capacity > map->capacity_)
     {
-        map->data_ = realloc(map->data_, new_capacity * (map->key_size_ + map->value_size_));
+        size_t pair_size = map->key_size_ + map->value_size_;
+        if (map->borrowed_)
+        {
+            /* Spill the pairs out of the caller's buffer, which stays untouched */
+            void* data = malloc(new_capacity * pair_size);
+            memcpy(data, map->data_, map->size_ * pair_size);
+            map->data_ = data;
+            map->borrowed_ = 0;
+        }
+        else
+            map->data_ = realloc(map->data_, new_capacity * pair_size);
         map->capacity_ = new_capacity;
     }
 }
 
 void reuse_ordered_map(ordered_map_t* map, size_t key_size, size_t value_size, size_t capacity, LESS_THAN_FUNC order_function)
 {
+    if (map->backend_ == ORDERED_BTREE_BACKEND)
+    {
+        destroy_btree(tree_ordered_map(map));
+        *tree_ordered_map(map) = create_btree(key_size + value_size, key_size, order_function);
+        tree_ordered_map(map)->key_kind_ = map->key_kind_;
+        map->size_ = 0;
+        map->key_size_ = key_size;
+        map->value_size_ = value_size;
+        map->order_func_ = order_function;
+        return;
+    }
+
     if ((key_size + value_size) * capacity > map->capacity_ * (map->key_size_ + map->value_size_))
-        map->data_ = realloc(map->data_, (key_size + value_size) * capacity);
+    {
+        map->data_ = map->borrowed_ ? malloc((key_size + value_size) * capacity) : realloc(map->data_, (key_size + value_size) * capacity);
+        map->borrowed_ = 0;
+    }
     
     map->size_ = 0;
     map->key_size_ = key_size;
@@ -54,17 +176,24 @@ size_t next_capacity_ordered_map(size_t capacity)
 
 void* get_ordered_map(const ordered_map_t* map, const void* key)
 {
-    return (void*)find_ordered_map(map, key) + map->key_size_;
+    const void* position = find_ordered_map(map, key);
+    return position != NULL ? (void*)position + map->key_size_ : NULL;
 }
 
 void set_ordered_map(const ordered_map_t* map, const void* key, const void* data)
 {
     void* pos = get_ordered_map(map, key);
-    memcpy(pos, data, map->value_size_);
+    if (pos != NULL)
+        memcpy(pos, data, map->value_size_);
 }
 
 void* at_index_ordered_map(const ordered_map_t* map, size_t index)
 {
+    if (map->backend_ == ORDERED_BTREE_BACKEND)
+    {
+        void* record = at_index_btree(tree_ordered_map(map), index);
+        return record != NULL ? record + map->key_size_ : NULL;
+    }
     if (index < map->size_)
         return map->data_ + (index * (map->value_size_ + map->key_size_)) + map->key_size_;
     return NULL;
@@ -72,6 +201,9 @@ void* at_index_ordered_map(const ordered_map_t* map, size_t index)
 
 size_t key_index_ordered_map(const ordered_map_t* map, const void* key)
 {
+    if (map->backend_ == ORDERED_BTREE_BACKEND)
+        return index_of_btree(tree_ordered_map(map), key);
+
     const void* data = find_ordered_map(map, key);
     if (data != NULL)
         return ((uintptr_t)data - (uintptr_t)map->data_) / (map->key_size_ + map->value_size_);
@@ -80,44 +212,86 @@ size_t key_index_ordered_map(const ordered_map_t* map, const void* key)
 
 const void* find_ordered_map(const ordered_map_t* map, const void* key)
 {
-    const void* position = binary_search(key, map->data_, map->size_, map->key_size_ + map->value_size_, map->order_func_);
-    if (!(map->order_func_(position, key) || map->order_func_(key, position)))
+    if (map->backend_ == ORDERED_BTREE_BACKEND)
+        return find_btree(tree_ordered_map(map), key);
+
+    const void* position = search_ordered_map(map, key);
+    if (found_ordered_map(map, position, key))
         return position;
     return NULL;
 }
 
 const void* get_key_ordered_map(const ordered_map_t* map, size_t index)
 {
+    if (map->backend_ == ORDERED_BTREE_BACKEND)
+        return at_index_btree(tree_ordered_map(map), index);
+
     if (index < map->size_)
         return map->data_ + (map->key_size_ + map->value_size_) * index;
     return NULL;
 }
 
+size_t run_ordered_map(const ordered_map_t* map, size_t index, const void** run)
+{
+    if (map->backend_ == ORDERED_BTREE_BACKEND)
+    {
+        btree_cursor_t cursor = cursor_at_btree(tree_ordered_map(map), index);
+        *run = get_btree_cursor(tree_ordered_map(map), &cursor);
+        return run_btree_cursor(&cursor);
+    }
+
+    *run = index < map->size_ ? map->data_ + index * (map->key_size_ + map->value_size_) : NULL;
+    return index < map->size_ ? map->size_ - index : 0;
+}
+
+span_t keys_span_ordered_map(const ordered_map_t* map, size_t index)
+{
+    const void* run;
+    size_t count = run_ordered_map(map, index, &run);
+    return create_span((void*)run, map->key_size_ + map->value_size_, count);
+}
+
+span_t values_span_ordered_map(const ordered_map_t* map, size_t index)
+{
+    const void* run;
+    size_t count = run_ordered_map(map, index, &run);
+    return create_span(count ? (void*)run + map->key_size_ : NULL, map->key_size_ + map->value_size_, count);
+}
+
 void remove_pair_ordered_map(ordered_map_t* map, const void* key)
 {
-    void* position = (void*)binary_search(key, map->data_, map->size_, map->key_size_ + map->value_size_, map->order_func_);
-    if (!(map->order_func_(position, key) || map->order_func_(key, position)))
+    if (map->backend_ == ORDERED_BTREE_BACKEND)
+    {
+        map->size_ -= remove_btree(tree_ordered_map(map), key, NULL);
+        return;
+    }
+
+    void* position = search_ordered_map(map, key);
+    if (found_ordered_map(map, position, key))
     {
         memmove(position, position + map->key_size_ + map->value_size_,
-            (uintptr_t)(map->data_ + map->size_ * (map->key_size_ + map->value_size_)) - (uintptr_t)position);
+            (uintptr_t)(map->data_ + (map->size_ - 1) * (map->key_size_ + map->value_size_)) - (uintptr_t)position);
         --map->size_;
     }
 }
 
 void insert_pair_ordered_map(ordered_map_t* map, const void* key, const void* value)
 {
+    if (map->backend_ == ORDERED_BTREE_BACKEND)
+    {
+        void* record = alloca(map->key_size_ + map->value_size_);
+        memcpy(record, key, map->key_size_);
+        memcpy(record + map->key_size_, value, map->value_size_);
+        map->size_ += insert_btree(tree_ordered_map(map), record);
+        return;
+    }
+
     if (map->size_ == map->capacity_)
         reserve_ordered_map(map, next_capacity_ordered_map(map->capacity_));
 
-    if (map->size_ == 0)
-    {
-        memcpy(map->data_, key, map->key_size_);
-        memcpy(map->data_ + map->key_size_, value, map->value_size_);
-        ++map->size_;
-    }
-    void* position = (void*)binary_search(key, map->data_, map->size_, map->key_size_ + map->value_size_, map->order_func_);
+    void* position = search_ordered_map(map, key);
 
-    if (map->order_func_(position, key) != map->order_func_(key, position))
+    if (!found_ordered_map(map, position, key))
     {
         size_t offset = (uintptr_t)(map->data_ + (map->size_ * (map->key_size_ + map->value_size_))) - (uintptr_t)position;
         memmove(position + map->key_size_ + map->value_size_, position, offset);
@@ -127,19 +301,105 @@ void insert_pair_ordered_map(ordered_map_t* map, const void* key, const void* va
     }
 }
 
+void insert_many_ordered_map(ordered_map_t* map, const void* pairs, size_t count)
+{
+    size_t pair_size = map->key_size_ + map->value_size_;
+    size_t* order = (size_t*)malloc(count * sizeof(size_t));
+    stable_order_kind(order, pairs, count, pair_size, map->key_kind_, map->order_func_);
+
+    if (map->backend_ == ORDERED_BTREE_BACKEND)
+    {
+        /* Inserting in key order keeps the tree descending to neighbouring leaves */
+        for (size_t i = 0; i < count; ++i)
+            map->size_ += insert_btree(tree_ordered_map(map), pairs + order[i] * pair_size);
+        free(order);
+        return;
+    }
+
+    /* The new pairs are gathered in key order, an empty map gathers them in place */
+    if (map->size_ == 0)
+        reserve_ordered_map(map, count);
+    void* incoming = map->size_ == 0 ? map->data_ : malloc(count * pair_size);
+    size_t added = 0;
+    size_t existing = 0;
+    const void* previous = NULL;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const void* pair = pairs + order[i] * pair_size;
+        if (previous != NULL && equal_kind(previous, pair, map->key_kind_, map->order_func_))
+            continue;
+        previous = pair;
+
+        while (existing < map->size_ && less_than_kind(map->data_ + existing * pair_size, pair, map->key_kind_, map->order_func_))
+            ++existing;
+        if (existing < map->size_ && !less_than_kind(pair, map->data_ + existing * pair_size, map->key_kind_, map->order_func_))
+            continue;
+
+        memcpy(incoming + added++ * pair_size, pair, pair_size);
+    }
+    free(order);
+
+    if (incoming == map->data_)
+    {
+        map->size_ = added;
+        return;
+    }
+
+    /* Merge from the back, so every stored pair is moved at most once, as part of a run */
+    reserve_ordered_map(map, map->size_ + added);
+    size_t left = map->size_;
+    size_t out = map->size_ + added;
+    for (size_t right = added; right > 0; --right)
+    {
+        const void* pair = incoming + (right - 1) * pair_size;
+        size_t run_start = upper_bound_kind(pair, map->data_, left, pair_size, map->key_kind_, map->order_func_);
+
+        out -= left - run_start;
+        memmove(map->data_ + out * pair_size, map->data_ + run_start * pair_size, (left - run_start) * pair_size);
+        left = run_start;
+        memcpy(map->data_ + --out * pair_size, pair, pair_size);
+    }
+    map->size_ += added;
+    free(incoming);
+}
+
+ordered_map_t create_ordered_map_from_pairs(size_t key_size, size_t value_size, const void* pairs, size_t count, LESS_THAN_FUNC order_function, key_kind_t kind)
+{
+    ordered_map_t out = create_ordered_map(key_size, value_size, 0, order_function);
+
+    out.key_kind_ = kind;
+    insert_many_ordered_map(&out, pairs, count);
+
+    return out;
+}
+
 void extract_pair_ordered_map(ordered_map_t* map, const void* key, void* value)
 {
-    void* position = (void*)binary_search(key, map->data_, map->size_, map->key_size_ + map->value_size_, map->order_func_);
-    if (!(map->order_func_(position, key) || map->order_func_(key, position)))
+    if (map->backend_ == ORDERED_BTREE_BACKEND)
+    {
+        void* record = alloca(map->key_size_ + map->value_size_);
+        if (remove_btree(tree_ordered_map(map), key, record))
+        {
+            memcpy(value, record + map->key_size_, map->value_size_);
+            --map->size_;
+        }
+        return;
+    }
+
+    void* position = search_ordered_map(map, key);
+    if (found_ordered_map(map, position, key))
     {
         memcpy(value, position + map->key_size_, map->value_size_);
         memmove(position, position + map->key_size_ + map->value_size_,
-            (uintptr_t)(map->data_ + map->size_ * (map->key_size_ + map->value_size_)) - (uintptr_t)position);
+            (uintptr_t)(map->data_ + (map->size_ - 1) * (map->key_size_ + map->value_size_)) - (uintptr_t)position);
         --map->size_;
     }
 }
 
 int contains_ordered_map(const ordered_map_t* map, const void* key)
 {
-    return sorted_array_contains(key, map->data_, map->size_, map->key_size_ + map->value_size_, map->order_func_);
+    if (map->backend_ == ORDERED_BTREE_BACKEND)
+        return find_btree(tree_ordered_map(map), key) != NULL;
+    return sorted_array_contains_kind(key, map->data_, map->size_, map->key_size_ + map->value_size_, map->key_kind_, map->order_func_);
 }
\ No newline at end of file
@@ -15,6 +15,8 @@
  */
 
 #include "algorithm.h"
+#include "btree.h"
+#include "span.h"
 
 #include <stdlib.h>
 
@@ -26,6 +28,12 @@
  * @var element_size_ stores the size in bytes of the elements' type
  * @var data_ stores the pointer to the array of data
  * @var order_func_ stores a pointer to the comparison function for the type
+ * @var backend_ stores the kind of storage of the pairs
+ * @var key_kind_ stores the built-in kind of the keys, used to search without calling order_func_
+ * @var borrowed_ stores 1 if data_ is a buffer owned by the caller (see create_ordered_map_in_buffer), else 0
+ * 
+ * With ORDERED_BTREE_BACKEND data_ points to a btree_t holding the pairs (key followed by value) and
+ * capacity_ is SIZE_MAX, so insertions and removals are O(log N) instead of moving the tail of the array.
  */
 typedef struct data_ordered_map_st
 {
@@ -35,6 +43,9 @@ typedef struct data_ordered_map_st
     size_t value_size_;
     void* data_;
     LESS_THAN_FUNC order_func_;
+    ordered_backend_t backend_;
+    key_kind_t key_kind_;
+    int borrowed_;
 } ordered_map_t;
 
 /**
@@ -48,6 +59,63 @@ typedef struct data_ordered_map_st
  */
 ordered_map_t create_ordered_map(size_t key_size, size_t value_size, size_t capacity, LESS_THAN_FUNC order_function);
 
+/**
+ * @brief Create an ordered map that stores its first pairs in a buffer owned by the caller.
+ *        The pairs are moved to a heap buffer the first time the map grows past the given capacity,
+ *        the caller's buffer is never freed nor reallocated by the map.
+ *        While borrowed_ is set, the caller must update data_ if it moves the buffer.
+ * 
+ * @param key_size size in bytes of the key data types to be stored
+ * @param value_size size in bytes of the value data types to be stored
+ * @param buffer pointer to the storage of capacity pairs
+ * @param capacity number of pairs that the buffer can store
+ * @param order_function function pointer to the comparison function for the type
+ * @return ordered_map
+ */
+ordered_map_t create_ordered_map_in_buffer(size_t key_size, size_t value_size, void* buffer, size_t capacity, LESS_THAN_FUNC order_function);
+
+/**
+ * @brief Create an ordered map stored in a B+tree
+ * 
+ * @param key_size size in bytes of the key data types to be stored
+ * @param value_size size in bytes of the value data types to be stored
+ * @param order_function function pointer to the comparison function for the type
+ * @return ordered_map
+ */
+ordered_map_t create_btree_ordered_map(size_t key_size, size_t value_size, LESS_THAN_FUNC order_function);
+
+/**
+ * @brief Create an ordered map stored in a sorted array from a batch of unsorted pairs.
+ *        Behaves as creating an empty map and calling insert_many_ordered_map.
+ * 
+ * @param key_size size in bytes of the key data types to be stored
+ * @param value_size size in bytes of the value data types to be stored
+ * @param pairs pointer to the batch of pairs, each one as the key immediately followed by the value
+ * @param count number of pairs in the batch
+ * @param order_function function pointer to the comparison function for the type
+ * @param kind built-in kind of the keys (KEY_KIND_CUSTOM to always use the order function)
+ * @return ordered_map
+ */
+ordered_map_t create_ordered_map_from_pairs(size_t key_size, size_t value_size, const void* pairs, size_t count, LESS_THAN_FUNC order_function, key_kind_t kind);
+
+/**
+ * @brief Moves the pairs of the map to the given storage.
+ *        Does nothing if the map already uses it.
+ * 
+ * @param map ordered_map to be migrated
+ * @param backend the new storage of the map
+ */
+void set_backend_ordered_map(ordered_map_t* map, ordered_backend_t backend);
+
+/**
+ * @brief Sets the built-in kind of the keys of the map, so searches compare them directly instead of
+ *        calling the order function. The order of the kind must match the order function of the map.
+ * 
+ * @param map ordered_map to be modified
+ * @param kind kind of the keys (KEY_KIND_CUSTOM to always use the order function)
+ */
+void set_key_kind_ordered_map(ordered_map_t* map, key_kind_t kind);
+
 /**
  * @brief Destroy the instance ordered_map passed.
  *        Cleans up the array and resets all parameters.
@@ -84,7 +152,8 @@ void reuse_ordered_map(ordered_map_t* map, size_t key_size, size_t value_size, s
 size_t next_capacity_ordered_map(size_t capacity);
 
 /**
- * @brief Gets the address of the value with the given key in the map
+ * @brief Gets the address of the value with the given key in the map.
+ *        If the key is not in the map, the function returns NULL
  * 
  * @param map the ordered_map from which the element is retrieved
  * @param key the key of the element to be retrieved
@@ -138,6 +207,38 @@ const void* find_ordered_map(const ordered_map_t* map, const void* key);
  */
 const void* get_key_ordered_map(const ordered_map_t* map, size_t index);
 
+/**
+ * @brief Gets the contiguous run of pairs that starts at the given index, used to scan the map in order.
+ *        The array backend returns all the remaining pairs, the btree backend the rest of the leaf.
+ *        Each pair is the key followed by the value.
+ * 
+ * @param map the ordered_map to scan
+ * @param index the index of the first pair of the run
+ * @param run pointer written with the address of the first pair (NULL if index is out of range)
+ * @return size_t number of pairs in the run
+ */
+size_t run_ordered_map(const ordered_map_t* map, size_t index, const void** run);
+
+/**
+ * @brief Returns a span over the keys of the contiguous run of pairs that starts at the given index (see run_ordered_map).
+ *        The stride of the span is the size of a pair. The span is empty if the index is out of range.
+ * 
+ * @param map the ordered_map to scan
+ * @param index the index of the first pair of the run
+ * @return span_t span of the keys of the run
+ */
+span_t keys_span_ordered_map(const ordered_map_t* map, size_t index);
+
+/**
+ * @brief Returns a span over the values of the contiguous run of pairs that starts at the given index (see run_ordered_map).
+ *        The stride of the span is the size of a pair. The span is empty if the index is out of range.
+ * 
+ * @param map the ordered_map to scan
+ * @param index the index of the first pair of the run
+ * @return span_t span of the values of the run
+ */
+span_t values_span_ordered_map(const ordered_map_t* map, size_t index);
+
 /**
  * @brief Removes the given element from the ordered_map
  * 
@@ -155,6 +256,21 @@ void remove_pair_ordered_map(ordered_map_t* map, const void* key);
  */
 void insert_pair_ordered_map(ordered_map_t* map, const void* key, const void* value);
 
+/**
+ * @brief Inserts a batch of pairs into the ordered_map.
+ *        The pairs are stored contiguously in the batch, each one as the key immediately followed by the value.
+ *        The result is the same as inserting the pairs one by one in the order of the batch: keys already in
+ *        the map are not modified and only the first pair of a repeated key is inserted.
+ *        With the array storage the batch is sorted (radix sorted for built-in key kinds), and merged with the
+ *        stored pairs in one pass from the back, so n pairs are added to a map of m pairs in O(n log n + m)
+ *        instead of one memmove per pair.
+ * 
+ * @param map the ordered_map to be added to
+ * @param pairs pointer to the batch of pairs
+ * @param count number of pairs in the batch
+ */
+void insert_many_ordered_map(ordered_map_t* map, const void* pairs, size_t count);
+
 /**
  * @brief Removes the given element from the ordered_map and returns the value with the given key
  * 
@@ -174,4 +290,130 @@ void extract_pair_ordered_map(ordered_map_t* map, const void* key, void* value);
  */
 int contains_ordered_map(const ordered_map_t* map, const void* key);
 
+/**
+ * @brief Stamps out a typed specialization of the ordered_map for keys of type K ordered by LESS(left, right),
+ *        a macro or function comparing two keys (DEFAULT_LESS_THAN for types with a built-in < operator), and
+ *        values of type V. The map is a regular ordered_map_t whose order function calls LESS, so it can be passed
+ *        to both the typed and the generic functions. With the array backend the typed functions search with an
+ *        inlined branchless binary search over the pairs and move whole pairs, other backends go through the
+ *        generic functions.
+ *        Pairs are stored unpadded, so values are returned by copy instead of by pointer.
+ * 
+ * Generated types and functions, with xxx the given tag:
+ * pair_xxx_omap_t: the packed layout of a stored pair, with fields key_ and value_
+ * less_xxx_omap(left, right): the LESS_THAN_FUNC of the map
+ * create_xxx_omap(capacity)
+ * lower_bound_xxx_omap(map, key): index of the first pair with a key not less than key (array backend only)
+ * search_xxx_omap(map, key): pointer to the stored pair with the key, or NULL
+ * insert_xxx_omap(map, key, value): keys already in the map are not modified
+ * set_xxx_omap(map, key, value): modifies the value of a key already in the map
+ * find_xxx_omap(map, key, value): returns 1 and copies the value to the pointer if the key is in the map, else 0
+ * remove_xxx_omap(map, key), contains_xxx_omap(map, key)
+ * 
+ * @param tag name of the specialization used in the generated type and function names
+ * @param K type of the keys
+ * @param V type of the values
+ * @param LESS comparison of two values of type K
+ */
+#define DEFINE_TYPED_ORDERED_MAP(tag, K, V, LESS)                                                               \
+typedef struct __attribute__((packed)) data_pair_##tag##_omap_st                                                \
+{                                                                                                               \
+    K key_;                                                                                                     \
+    V value_;                                                                                                   \
+} pair_##tag##_omap_t;                                                                                          \
+                                                                                                                \
+static inline int less_##tag##_omap(const void* left, const void* right)                                        \
+{                                                                                                               \
+    K l, r;                                                                                                     \
+    memcpy(&l, left, sizeof(K));                                                                                \
+    memcpy(&r, right, sizeof(K));                                                                               \
+    return LESS(l, r);                                                                                          \
+}                                                                                                               \
+                                                                                                                \
+static inline ordered_map_t create_##tag##_omap(size_t capacity)                                                \
+{                                                                                                               \
+    return create_ordered_map(sizeof(K), sizeof(V), capacity, less_##tag##_omap);                               \
+}                                                                                                               \
+                                                                                                                \
+static inline size_t lower_bound_##tag##_omap(const ordered_map_t* map, K key)                                  \
+{                                                                                                               \
+    const pair_##tag##_omap_t* data = (const pair_##tag##_omap_t*)map->data_;                                   \
+    const pair_##tag##_omap_t* base = data;                                                                     \
+    size_t count = map->size_;                                                                                  \
+    if (count == 0)                                                                                             \
+        return 0;                                                                                               \
+    while (count > 1)                                                                                           \
+    {                                                                                                           \
+        size_t half = count / 2;                                                                                \
+        base = LESS(base[half].key_, key) ? base + half : base;                                                 \
+        count -= half;                                                                                          \
+    }                                                                                                           \
+    return (size_t)(base - data) + (LESS(base->key_, key) ? 1 : 0);                                             \
+}                                                                                                               \
+                                                                                                                \
+static inline pair_##tag##_omap_t* search_##tag##_omap(const ordered_map_t* map, K key)                         \
+{                                                                                                               \
+    if (map->backend_ != ORDERED_ARRAY_BACKEND)                                                                 \
+        return (pair_##tag##_omap_t*)find_ordered_map(map, &key);                                               \
+                                                                                                                \
+    size_t index = lower_bound_##tag##_omap(map, key);                                                          \
+    pair_##tag##_omap_t* pair = (pair_##tag##_omap_t*)map->data_ + index;                                       \
+    return index < map->size_ && !(LESS(key, pair->key_)) ? pair : NULL;                                        \
+}                                                                                                               \
+                                                                                                                \
+static inline void insert_##tag##_omap(ordered_map_t* map, K key, V value)                                      \
+{                                                                                                               \
+    if (map->backend_ != ORDERED_ARRAY_BACKEND)                                                                 \
+    {                                                                                                           \
+        insert_pair_ordered_map(map, &key, &value);                                                             \
+        return;                                                                                                 \
+    }                                                                                                           \
+                                                                                                                \
+    size_t index = lower_bound_##tag##_omap(map, key);                                                          \
+    if (index < map->size_ && !(LESS(key, ((const pair_##tag##_omap_t*)map->data_)[index].key_)))               \
+        return;                                                                                                 \
+    if (map->size_ == map->capacity_)                                                                           \
+        reserve_ordered_map(map, next_capacity_ordered_map(map->capacity_));                                    \
+    pair_##tag##_omap_t* data = (pair_##tag##_omap_t*)map->data_;                                               \
+    memmove(data + index + 1, data + index, (map->size_ - index) * sizeof(pair_##tag##_omap_t));                \
+    data[index].key_ = key;                                                                                     \
+    data[index].value_ = value;                                                                                 \
+    ++map->size_;                                                                                               \
+}                                                                                                               \
+                                                                                                                \
+static inline void set_##tag##_omap(ordered_map_t* map, K key, V value)                                         \
+{                                                                                                               \
+    pair_##tag##_omap_t* pair = search_##tag##_omap(map, key);                                                  \
+    if (pair != NULL)                                                                                           \
+        pair->value_ = value;                                                                                   \
+}                                                                                                               \
+                                                                                                                \
+static inline int find_##tag##_omap(const ordered_map_t* map, K key, V* value)                                  \
+{                                                                                                               \
+    const pair_##tag##_omap_t* pair = search_##tag##_omap(map, key);                                            \
+    if (pair == NULL)                                                                                           \
+        return 0;                                                                                               \
+    *value = pair->value_;                                                                                      \
+    return 1;                                                                                                   \
+}                                                                                                               \
+                                                                                                                \
+static inline int contains_##tag##_omap(const ordered_map_t* map, K key)                                        \
+{                                                                                                               \
+    return search_##tag##_omap(map, key) != NULL;                                                               \
+}                                                                                                               \
+                                                                                                                \
+static inline void remove_##tag##_omap(ordered_map_t* map, K key)                                               \
+{                                                                                                               \
+    if (map->backend_ != ORDERED_ARRAY_BACKEND)                                                                 \
+    {                                                                                                           \
+        remove_pair_ordered_map(map, &key);                                                                     \
+        return;                                                                                                 \
+    }                                                                                                           \
+                                                                                                                \
+    size_t index = lower_bound_##tag##_omap(map, key);                                                          \
+    pair_##tag##_omap_t* data = (pair_##tag##_omap_t*)map->data_;                                               \
+    if (index < map->size_ && !(LESS(key, data[index].key_)))                                                   \
+        memmove(data + index, data + index + 1, (--map->size_ - index) * sizeof(pair_##tag##_omap_t));          \
+}
+
 #endif /* DATA_ORDERED_MAP */
\ No newline at end of file
@@ -12,17 +12,89 @@ ordered_set_t create_ordered_set(size_t capacity, size_t element_size, LESS_THAN
     out.size_ = 0;
     out.data_ = malloc(element_size * capacity);
     out.order_func_ = order_function;
+    out.backend_ = ORDERED_ARRAY_BACKEND;
+    out.key_kind_ = KEY_KIND_CUSTOM;
 
     return out;
 }
 
+static inline btree_t* tree_ordered_set(const ordered_set_t* set)
+{
+    return (btree_t*)set->data_;
+}
+
+/* Position of the first element not less than the given one in the array backend */
+static inline void* search_ordered_set(const ordered_set_t* set, const void* element)
+{
+    return (void*)binary_search_kind(element, set->data_, set->size_, set->element_size_, set->key_kind_, set->order_func_);
+}
+
+static inline int found_ordered_set(const ordered_set_t* set, const void* position, const void* element)
+{
+    return position != set->data_ + set->size_ * set->element_size_ && equal_kind(position, element, set->key_kind_, set->order_func_);
+}
+
+ordered_set_t create_btree_ordered_set(size_t element_size, LESS_THAN_FUNC order_function)
+{
+    ordered_set_t out;
+
+    out.capacity_ = SIZE_MAX;
+    out.element_size_ = element_size;
+    out.size_ = 0;
+    out.data_ = malloc(sizeof(btree_t));
+    out.order_func_ = order_function;
+    out.backend_ = ORDERED_BTREE_BACKEND;
+    out.key_kind_ = KEY_KIND_CUSTOM;
+    *tree_ordered_set(&out) = create_btree(element_size, element_size, order_function);
+
+    return out;
+}
+
+void set_backend_ordered_set(ordered_set_t* set, ordered_backend_t backend)
+{
+    if (set->backend_ == backend)
+        return;
+
+    if (backend == ORDERED_BTREE_BACKEND)
+    {
+        ordered_set_t out = create_btree_ordered_set(set->element_size_, set->order_func_);
+        for (size_t i = 0; i < set->size_; ++i)
+            insert_btree(tree_ordered_set(&out), set->data_ + i * set->element_size_);
+        out.size_ = set->size_;
+        set_key_kind_ordered_set(&out, set->key_kind_);
+        destroy_ordered_set(set);
+        *set = out;
+    }
+    else
+    {
+        ordered_set_t out = create_ordered_set(set->size_, set->element_size_, set->order_func_);
+        btree_cursor_t cursor = begin_btree(tree_ordered_set(set));
+        for (; cursor.leaf_ != NULL; next_btree_cursor(&cursor))
+            memcpy(out.data_ + out.size_++ * out.element_size_, get_btree_cursor(tree_ordered_set(set), &cursor), out.element_size_);
+        out.key_kind_ = set->key_kind_;
+        destroy_ordered_set(set);
+        *set = out;
+    }
+}
+
+void set_key_kind_ordered_set(ordered_set_t* set, key_kind_t kind)
+{
+    set->key_kind_ = kind;
+    if (set->backend_ == ORDERED_BTREE_BACKEND)
+        tree_ordered_set(set)->key_kind_ = kind;
+}
+
 void destroy_ordered_set(ordered_set_t* set)
 {
+    if (set->backend_ == ORDERED_BTREE_BACKEND)
+        destroy_btree(tree_ordered_set(set));
     set->capacity_ = 0;
     set->size_ = 0;
     set->element_size_ = 0;
     set->order_func_ = NULL;
+    set->backend_ = ORDERED_ARRAY_BACKEND;
     free(set->data_);
+    set->data_ = NULL;
 }
 
 void reserve_ordered_set(ordered_set_t* set, size_t new_capacity)
@@ -36,6 +108,17 @@ void reserve_ordered_set(ordered_set_t* set, size_t new_capacity)
 
 void reuse_ordered_set(ordered_set_t* set, size_t capacity, size_t element_size, LESS_THAN_FUNC order_function)
 {
+    if (set->backend_ == ORDERED_BTREE_BACKEND)
+    {
+        destroy_btree(tree_ordered_set(set));
+        *tree_ordered_set(set) = create_btree(element_size, element_size, order_function);
+        tree_ordered_set(set)->key_kind_ = set->key_kind_;
+        set->size_ = 0;
+        set->element_size_ = element_size;
+        set->order_func_ = order_function;
+        return;
+    }
+
     if (element_size * capacity > set->capacity_ * set->element_size_)
         set->data_ = realloc(set->data_, element_size * capacity);
     
@@ -52,6 +135,8 @@ size_t next_capacity_ordered_set(size_t capacity)
 
 const void* get_element_ordered_set(const ordered_set_t* set, size_t index)
 {
+    if (set->backend_ == ORDERED_BTREE_BACKEND)
+        return at_index_btree(tree_ordered_set(set), index);
     if (index < set->size_ && index >= 0)
         return set->data_ + (index * set->element_size_);
     return NULL;
@@ -59,24 +144,34 @@ const void* get_element_ordered_set(const ordered_set_t* set, size_t index)
 
 void remove_element_ordered_set(ordered_set_t* set, const void* element)
 {
-    void* position = (void*)binary_search(element, set->data_, set->size_, set->element_size_, set->order_func_);
-    if (!(set->order_func_(position, element) || set->order_func_(element, position)))
+    if (set->backend_ == ORDERED_BTREE_BACKEND)
+    {
+        set->size_ -= remove_btree(tree_ordered_set(set), element, NULL);
+        return;
+    }
+
+    void* position = search_ordered_set(set, element);
+    if (found_ordered_set(set, position, element))
     {
-        memmove(position, position + set->element_size_, (uintptr_t)(set->data_ + set->size_ * set->element_size_) - (uintptr_t)position);
+        memmove(position, position + set->element_size_, (uintptr_t)(set->data_ + (set->size_ - 1) * set->element_size_) - (uintptr_t)position);
         --set->size_;
     }
 }
 
 void insert_element_ordered_set(ordered_set_t* set, const void* element)
 {
+    if (set->backend_ == ORDERED_BTREE_BACKEND)
+    {
+        set->size_ += insert_btree(tree_ordered_set(set), element);
+        return;
+    }
+
     if (set->size_ == set->capacity_)
         reserve_ordered_set(set, next_capacity_ordered_set(set->capacity_));
 
-    if (set->size_ == 0)
-        memcpy(set->data_, element, set->element_size_), ++set->size_;
-    void* position = (void*)binary_search(element, set->data_, set->size_, set->element_size_, set->order_func_);
+    void* position = search_ordered_set(set, element);
 
-    if (set->order_func_(position, element) != set->order_func_(element, position))
+    if (!found_ordered_set(set, position, element))
     {
         size_t offset = (uintptr_t)(set->data_ + set->size_ * set->element_size_) - (uintptr_t)position;
         memmove(position + set->element_size_, position, offset);
@@ -85,39 +180,58 @@ void insert_element_ordered_set(ordered_set_t* set, const void* element)
     }
 }
 
-int contains_ordered_set(const ordered_set_t* set, const void* element)
+const void* find_ordered_set(const ordered_set_t* set, const void* element)
 {
-    return sorted_array_contains(element, set->data_, set->size_, set->element_size_, set->order_func_);
-}
+    if (set->backend_ == ORDERED_BTREE_BACKEND)
+        return find_btree(tree_ordered_set(set), element);
 
-int int_less_than_func(const void* left, const void* right)
-{
-    return *(const int*)left < *(const int*)right;
+    const void* position = search_ordered_set(set, element);
+    if (found_ordered_set(set, position, element))
+        return position;
+    return NULL;
 }
 
-ordered_set_t create_int_oset(size_t capacity)
+size_t index_of_ordered_set(const ordered_set_t* set, const void* element)
 {
-    return create_ordered_set(sizeof(int), capacity, int_less_than_func);
+    if (set->backend_ == ORDERED_BTREE_BACKEND)
+        return index_of_btree(tree_ordered_set(set), element);
+
+    const void* position = find_ordered_set(set, element);
+    if (position != NULL)
+        return ((uintptr_t)position - (uintptr_t)set->data_) / set->element_size_;
+    return SIZE_MAX;
 }
 
-void reuse_int_oset(ordered_set_t* set, size_t capacity)
+size_t run_ordered_set(const ordered_set_t* set, size_t index, const void** run)
 {
-    reuse_ordered_set(set, sizeof(int), capacity, int_less_than_func);
+    if (set->backend_ == ORDERED_BTREE_BACKEND)
+    {
+        btree_cursor_t cursor = cursor_at_btree(tree_ordered_set(set), index);
+        *run = get_btree_cursor(tree_ordered_set(set), &cursor);
+        return run_btree_cursor(&cursor);
+    }
+
+    *run = index < set->size_ ? set->data_ + index * set->element_size_ : NULL;
+    return index < set->size_ ? set->size_ - index : 0;
 }
 
-void insert_int_oset(ordered_set_t* set, int val)
+span_t span_ordered_set(const ordered_set_t* set, size_t index)
 {
-    insert_element_ordered_set(set, &val);
+    const void* run;
+    size_t count = run_ordered_set(set, index, &run);
+    return create_span((void*)run, set->element_size_, count);
 }
 
-void remove_int_oset(ordered_set_t* set, int val)
+int contains_ordered_set(const ordered_set_t* set, const void* element)
 {
-    remove_element_ordered_set(set, &val);
+    if (set->backend_ == ORDERED_BTREE_BACKEND)
+        return find_btree(tree_ordered_set(set), element) != NULL;
+    return sorted_array_contains_kind(element, set->data_, set->size_, set->element_size_, set->key_kind_, set->order_func_);
 }
 
-int get_int_oset(const ordered_set_t* set, int index)
+int int_less_than_func(const void* left, const void* right)
 {
-    return *(const int*)get_element_ordered_set(set, index);
+    return *(const int*)left < *(const int*)right;
 }
 
 void print_int_oset(const ordered_set_t* set)
@@ -126,9 +240,4 @@ void print_int_oset(const ordered_set_t* set)
     for (int i = 0; i < set->size_; ++i)
         printf(" %d,", get_int_oset(set, i));
     printf(" )\n");
-}
-
-int contains_int_oset(const ordered_set_t* set, int value)
-{
-    return contains_ordered_set(set, &value);
 }
\ No newline at end of file
@@ -13,6 +13,8 @@
  */
 
 #include "algorithm.h"
+#include "btree.h"
+#include "span.h"
 
 #include <stdlib.h>
 
@@ -24,6 +26,11 @@
  * element_size_ stores the size in bytes of the elements' type
  * data_ stores the pointer to the array of data
  * order_func_ stores a pointer to the comparison function for the type
+ * backend_ stores the kind of storage of the elements
+ * key_kind_ stores the built-in kind of the elements, used to search without calling order_func_
+ * 
+ * With ORDERED_BTREE_BACKEND data_ points to a btree_t holding the elements and capacity_ is SIZE_MAX,
+ * so insertions and removals are O(log N) instead of moving the tail of the array.
  */
 typedef struct data_ordered_set_st
 {
@@ -32,6 +39,8 @@ typedef struct data_ordered_set_st
     size_t element_size_;
     void* data_;
     LESS_THAN_FUNC order_func_;
+    ordered_backend_t backend_;
+    key_kind_t key_kind_;
 } ordered_set_t;
 
 /**
@@ -44,6 +53,33 @@ typedef struct data_ordered_set_st
  */
 ordered_set_t create_ordered_set(size_t capacity, size_t element_size, LESS_THAN_FUNC order_function);
 
+/**
+ * @brief Create an ordered set stored in a B+tree
+ * 
+ * @param element_size size in bytes of the data types to be stored
+ * @param order_function function pointer to the comparison function for the type
+ * @return ordered_set 
+ */
+ordered_set_t create_btree_ordered_set(size_t element_size, LESS_THAN_FUNC order_function);
+
+/**
+ * @brief Moves the elements of the set to the given storage.
+ *        Does nothing if the set already uses it.
+ * 
+ * @param set ordered_set to be migrated
+ * @param backend the new storage of the set
+ */
+void set_backend_ordered_set(ordered_set_t* set, ordered_backend_t backend);
+
+/**
+ * @brief Sets the built-in kind of the elements of the set, so searches compare them directly instead of
+ *        calling the order function. The order of the kind must match the order function of the set.
+ * 
+ * @param set ordered_set to be modified
+ * @param kind kind of the elements (KEY_KIND_CUSTOM to always use the order function)
+ */
+void set_key_kind_ordered_set(ordered_set_t* set, key_kind_t kind);
+
 /**
  * @brief Destroy the instance ordered_set passed.
  *        Cleans up the array and resets all parameters.
@@ -104,64 +140,166 @@ void remove_element_ordered_set(ordered_set_t* set, const void* element);
 void insert_element_ordered_set(ordered_set_t* set, const void* element);
 
 /**
- * @brief Searches for the given element in the set and returns 1 if it is in the ordered set
- *        else it returns 0
+ * @brief Gets the address of the element in the set.
+ *        If the element is not in the set, the function returns NULL
  * 
- * @param set the ordered_set to be searched
- * @param element the element to be searched
- * @return 1 if contains, 0 if does not contain
+ * @param set the ordered_set to search in
+ * @param element the element to search
+ * @return const pointer to the element position
  */
-int contains_ordered_set(const ordered_set_t* set, const void* element);
+const void* find_ordered_set(const ordered_set_t* set, const void* element);
 
 /**
- * @brief Wrapper for creating an int specialized ordered_set
+ * @brief Returns current index of the element in the set.
+ *        If the element is not in the set it returns SIZE_MAX
  * 
- * @param capacity initial capacity that the set should be able to store
- * @return ordered_set of ints
+ * @param set the ordered_set to search in
+ * @param element the element to search
+ * @return size_t index of the element
  */
-ordered_set_t create_int_oset(size_t capacity);
+size_t index_of_ordered_set(const ordered_set_t* set, const void* element);
 
 /**
- * @brief Wrapper for reusing an int specialized ordered_set
+ * @brief Gets the contiguous run of elements that starts at the given index, used to scan the set in order.
+ *        The array backend returns all the remaining elements, the btree backend the rest of the leaf.
  * 
- * @param set set to be reused
- * @param capacity new capacity of the ordered_set
+ * @param set the ordered_set to scan
+ * @param index the index of the first element of the run
+ * @param run pointer written with the address of the first element (NULL if index is out of range)
+ * @return size_t number of elements in the run
  */
-void reuse_int_oset(ordered_set_t* set, size_t capacity);
+size_t run_ordered_set(const ordered_set_t* set, size_t index, const void** run);
 
 /**
- * @brief Wrapper for inserting an element in an int specialized ordered_set
+ * @brief Returns a span over the contiguous run of elements that starts at the given index (see run_ordered_set).
+ *        The span is empty if the index is out of range.
  * 
- * @param set ordered_set to be inserted to
- * @param val value to be inserted
+ * @param set the ordered_set to scan
+ * @param index the index of the first element of the run
+ * @return span_t span of the run
  */
-void insert_int_oset(ordered_set_t* set, int val);
+span_t span_ordered_set(const ordered_set_t* set, size_t index);
 
 /**
- * @brief Wrapper for removing an element in an int specialized ordered_set
+ * @brief Searches for the given element in the set and returns 1 if it is in the ordered set
+ *        else it returns 0
  * 
- * @param set ordered_set to be removed from
- * @param val value to be removed
+ * @param set the ordered_set to be searched
+ * @param element the element to be searched
+ * @return 1 if contains, 0 if does not contain
  */
-void remove_int_oset(ordered_set_t* set, int val);
+int contains_ordered_set(const ordered_set_t* set, const void* element);
 
 /**
- * @brief Getter wrapper an int specialized ordered_set
+ * @brief Stamps out a typed specialization of the ordered_set for the element type T ordered by LESS(left, right),
+ *        a macro or function comparing two values (DEFAULT_LESS_THAN for types with a built-in < operator).
+ *        The set is a regular ordered_set_t whose order function calls LESS, so it can be passed to both the typed
+ *        and the generic functions. With the array backend the typed functions search with an inlined branchless
+ *        binary search and move whole T values, other backends go through the generic functions.
  * 
- * @param set the ordered_set from which the element is retrieved
- * @param index index of the element in the set
- * @return value at index
+ * Generated functions, with xxx the given tag:
+ * less_xxx_oset(left, right): the LESS_THAN_FUNC of the set
+ * create_xxx_oset(capacity), reuse_xxx_oset(set, capacity)
+ * lower_bound_xxx_oset(set, value): index of the first element not less than value (array backend only)
+ * insert_xxx_oset(set, value), remove_xxx_oset(set, value), contains_xxx_oset(set, value)
+ * get_xxx_oset(set, index): without bounds checks
+ * 
+ * @param tag name of the specialization used in the generated function names
+ * @param T type of the elements
+ * @param LESS comparison of two values of type T
  */
-int get_int_oset(const ordered_set_t* set, int index);
+#define DEFINE_TYPED_ORDERED_SET(tag, T, LESS)                                                                  \
+static inline int less_##tag##_oset(const void* left, const void* right)                                        \
+{                                                                                                               \
+    T l, r;                                                                                                     \
+    memcpy(&l, left, sizeof(T));                                                                                \
+    memcpy(&r, right, sizeof(T));                                                                               \
+    return LESS(l, r);                                                                                          \
+}                                                                                                               \
+                                                                                                                \
+static inline ordered_set_t create_##tag##_oset(size_t capacity)                                                \
+{                                                                                                               \
+    return create_ordered_set(capacity, sizeof(T), less_##tag##_oset);                                          \
+}                                                                                                               \
+                                                                                                                \
+static inline void reuse_##tag##_oset(ordered_set_t* set, size_t capacity)                                      \
+{                                                                                                               \
+    reuse_ordered_set(set, capacity, sizeof(T), less_##tag##_oset);                                             \
+}                                                                                                               \
+                                                                                                                \
+static inline size_t lower_bound_##tag##_oset(const ordered_set_t* set, T value)                                \
+{                                                                                                               \
+    const T* data = (const T*)set->data_;                                                                       \
+    const T* base = data;                                                                                       \
+    size_t count = set->size_;                                                                                  \
+    if (count == 0)                                                                                             \
+        return 0;                                                                                               \
+    while (count > 1)                                                                                           \
+    {                                                                                                           \
+        size_t half = count / 2;                                                                                \
+        base = LESS(base[half], value) ? base + half : base;                                                    \
+        count -= half;                                                                                          \
+    }                                                                                                           \
+    return (size_t)(base - data) + (LESS(*base, value) ? 1 : 0);                                                \
+}                                                                                                               \
+                                                                                                                \
+static inline void insert_##tag##_oset(ordered_set_t* set, T value)                                             \
+{                                                                                                               \
+    if (set->backend_ != ORDERED_ARRAY_BACKEND)                                                                 \
+    {                                                                                                           \
+        insert_element_ordered_set(set, &value);                                                                \
+        return;                                                                                                 \
+    }                                                                                                           \
+                                                                                                                \
+    size_t index = lower_bound_##tag##_oset(set, value);                                                        \
+    if (index < set->size_ && !(LESS(value, ((const T*)set->data_)[index])))                                    \
+        return;                                                                                                 \
+    if (set->size_ == set->capacity_)                                                                           \
+        reserve_ordered_set(set, next_capacity_ordered_set(set->capacity_));                                    \
+    T* data = (T*)set->data_;                                                                                   \
+    memmove(data + index + 1, data + index, (set->size_ - index) * sizeof(T));                                  \
+    data[index] = value;                                                                                        \
+    ++set->size_;                                                                                               \
+}                                                                                                               \
+                                                                                                                \
+static inline void remove_##tag##_oset(ordered_set_t* set, T value)                                             \
+{                                                                                                               \
+    if (set->backend_ != ORDERED_ARRAY_BACKEND)                                                                 \
+    {                                                                                                           \
+        remove_element_ordered_set(set, &value);                                                                \
+        return;                                                                                                 \
+    }                                                                                                           \
+                                                                                                                \
+    size_t index = lower_bound_##tag##_oset(set, value);                                                        \
+    T* data = (T*)set->data_;                                                                                   \
+    if (index < set->size_ && !(LESS(value, data[index])))                                                      \
+    {                                                                                                           \
+        memmove(data + index, data + index + 1, (--set->size_ - index) * sizeof(T));                            \
+    }                                                                                                           \
+}                                                                                                               \
+                                                                                                                \
+static inline int contains_##tag##_oset(const ordered_set_t* set, T value)                                      \
+{                                                                                                               \
+    if (set->backend_ != ORDERED_ARRAY_BACKEND)                                                                 \
+        return contains_ordered_set(set, &value);                                                               \
+                                                                                                                \
+    size_t index = lower_bound_##tag##_oset(set, value);                                                        \
+    return index < set->size_ && !(LESS(value, ((const T*)set->data_)[index]));                                 \
+}                                                                                                               \
+                                                                                                                \
+static inline T get_##tag##_oset(const ordered_set_t* set, size_t index)                                        \
+{                                                                                                               \
+    T out;                                                                                                      \
+    if (set->backend_ == ORDERED_ARRAY_BACKEND)                                                                 \
+        return ((const T*)set->data_)[index];                                                                   \
+    memcpy(&out, get_element_ordered_set(set, index), sizeof(T));                                               \
+    return out;                                                                                                 \
+}
 
 /**
- * @brief Wrapper for an int specialized ordered_set of the contains function
- * 
- * @param set the ordered_set to be searched
- * @param value value to be searched
- * @return 1 if contains, 0 if does not contain
+ * @brief int specialization of the ordered_set (create_int_oset, insert_int_oset, contains_int_oset, ...)
  */
-int contains_int_oset(const ordered_set_t* set, int value);
+DEFINE_TYPED_ORDERED_SET(int, int, DEFAULT_LESS_THAN)
 
 /**
  * @brief Prints the information and elements of an ordered_set of ints
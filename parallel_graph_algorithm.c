@@ -0,0 +1,308 @@
+#include "parallel_graph_algorithm.h"
+
+#include "bitset.h"
+
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/* Top-down to bottom-up when the frontier edges exceed unexplored edges / ALPHA, back when the frontier is below nodes / BETA */
+#define BFS_ALPHA 14
+#define BFS_BETA 24
+
+/* Number of frontier nodes (top-down) or bitset words (bottom-up) taken by a thread at a time */
+#define BFS_TOP_DOWN_CHUNK 64
+#define BFS_BOTTOM_UP_CHUNK 16
+
+/* Frontier found by one thread in the current level, padded so the threads do not share cache lines */
+typedef struct bfs_local_st
+{
+    uint32_t* nodes;
+    size_t size;
+    size_t capacity;
+    size_t edges;
+    size_t offset;
+} __attribute__((aligned(64))) bfs_local;
+
+typedef struct bfs_state_st
+{
+    const csr_graph_t* graph;
+    const csr_graph_t* reverse;
+    uint32_t* depths;
+    uint32_t* parents;
+    bitset_t visited;
+    bitset_t frontier_bits;
+    bitset_t next_bits;
+    uint32_t* frontier;
+    size_t frontier_size;
+    size_t cursor;
+    size_t unexplored_edges;
+    uint32_t depth;
+    int bottom_up;
+    int was_bottom_up;
+    int done;
+    size_t threads;
+    bfs_local* locals;
+    pthread_barrier_t barrier;
+} bfs_state;
+
+typedef struct bfs_worker_st
+{
+    bfs_state* state;
+    size_t id;
+} bfs_worker;
+
+static void push_local_bfs(bfs_local* local, uint32_t node, size_t degree)
+{
+    if (local->size == local->capacity)
+    {
+        local->capacity = local->capacity ? local->capacity * 2 : 1024;
+        local->nodes = (uint32_t*)realloc(local->nodes, local->capacity * sizeof(uint32_t));
+    }
+    local->nodes[local->size++] = node;
+    local->edges += degree;
+}
+
+static void top_down_step_bfs(bfs_state* state, bfs_local* local)
+{
+    const csr_graph_t* graph = state->graph;
+    uint32_t depth = state->depth + 1;
+
+    for (;;)
+    {
+        size_t begin = __atomic_fetch_add(&state->cursor, BFS_TOP_DOWN_CHUNK, __ATOMIC_RELAXED);
+        if (begin >= state->frontier_size)
+            break;
+
+        size_t end = begin + BFS_TOP_DOWN_CHUNK < state->frontier_size ? begin + BFS_TOP_DOWN_CHUNK : state->frontier_size;
+        for (size_t i = begin; i < end; ++i)
+        {
+            uint32_t node = state->frontier[i];
+            for (size_t edge = graph->offsets_[node]; edge < graph->offsets_[node + 1]; ++edge)
+            {
+                uint32_t adjacent_node = graph->destinations_[edge];
+                if (!atomic_test_and_set_bit_bitset(&state->visited, adjacent_node))
+                {
+                    state->depths[adjacent_node] = depth;
+                    if (state->parents != NULL)
+                        state->parents[adjacent_node] = node;
+                    push_local_bfs(local, adjacent_node, degree_csr_graph(graph, adjacent_node));
+                }
+            }
+        }
+    }
+}
+
+static void bottom_up_step_bfs(bfs_state* state, bfs_local* local)
+{
+    const csr_graph_t* reverse = state->reverse;
+    size_t words = words_for_bitset(state->graph->nodes_);
+    uint32_t depth = state->depth + 1;
+
+    for (;;)
+    {
+        size_t begin = __atomic_fetch_add(&state->cursor, BFS_BOTTOM_UP_CHUNK, __ATOMIC_RELAXED);
+        if (begin >= words)
+            break;
+
+        size_t end = begin + BFS_BOTTOM_UP_CHUNK < words ? begin + BFS_BOTTOM_UP_CHUNK : words;
+        for (size_t word = begin; word < end; ++word)
+        {
+            uint64_t unvisited = ~state->visited.data_[word];
+            if (word == words - 1 && (state->graph->nodes_ & 63))
+                unvisited &= ((uint64_t)1 << (state->graph->nodes_ & 63)) - 1;
+
+            while (unvisited != 0)
+            {
+                uint32_t node = (uint32_t)(word * 64 + __builtin_ctzll(unvisited));
+                unvisited &= unvisited - 1;
+
+                for (size_t edge = reverse->offsets_[node]; edge < reverse->offsets_[node + 1]; ++edge)
+                {
+                    uint32_t parent = reverse->destinations_[edge];
+                    if (test_bit_bitset(&state->frontier_bits, parent))
+                    {
+                        state->depths[node] = depth;
+                        if (state->parents != NULL)
+                            state->parents[node] = parent;
+                        set_bit_bitset(&state->visited, node);
+                        set_bit_bitset(&state->next_bits, node);
+                        push_local_bfs(local, node, degree_csr_graph(state->graph, node));
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+/* Runs on the first thread between levels: chooses the direction of the next step and where each local frontier goes */
+static void next_level_bfs(bfs_state* state)
+{
+    size_t nodes = 0;
+    size_t edges = 0;
+    for (size_t t = 0; t < state->threads; ++t)
+    {
+        state->locals[t].offset = nodes;
+        nodes += state->locals[t].size;
+        edges += state->locals[t].edges;
+        state->locals[t].edges = 0;
+    }
+
+    size_t previous_size = state->frontier_size;
+    state->done = nodes == 0;
+    state->frontier_size = nodes;
+    state->unexplored_edges = state->unexplored_edges > edges ? state->unexplored_edges - edges : 0;
+    state->cursor = 0;
+    ++state->depth;
+
+    state->was_bottom_up = state->bottom_up;
+    if (state->reverse != NULL)
+    {
+        if (!state->bottom_up)
+            state->bottom_up = edges > state->unexplored_edges / BFS_ALPHA;
+        else
+            state->bottom_up = !(nodes < previous_size && nodes < state->graph->nodes_ / BFS_BETA);
+    }
+
+    if (state->bottom_up && state->was_bottom_up)
+    {
+        bitset_t temp = state->frontier_bits;
+        state->frontier_bits = state->next_bits;
+        state->next_bits = temp;
+        reset_bitset(&state->next_bits);
+    }
+    else if (state->bottom_up)
+    {
+        reset_bitset(&state->frontier_bits);
+        reset_bitset(&state->next_bits);
+    }
+}
+
+static void* run_bfs_worker(void* argument)
+{
+    bfs_worker* worker = (bfs_worker*)argument;
+    bfs_state* state = worker->state;
+    bfs_local* local = &state->locals[worker->id];
+
+    for (;;)
+    {
+        if (state->bottom_up)
+            bottom_up_step_bfs(state, local);
+        else
+            top_down_step_bfs(state, local);
+
+        pthread_barrier_wait(&state->barrier);
+        if (worker->id == 0)
+            next_level_bfs(state);
+        pthread_barrier_wait(&state->barrier);
+
+        if (state->done)
+            break;
+
+        /* The old frontier is no longer read, so the new one is written over it */
+        if (!state->bottom_up)
+        {
+            if (local->size != 0)
+                memcpy(state->frontier + local->offset, local->nodes, local->size * sizeof(uint32_t));
+        }
+        else if (!state->was_bottom_up)
+        {
+            for (size_t i = 0; i < local->size; ++i)
+                atomic_set_bit_bitset(&state->frontier_bits, local->nodes[i]);
+        }
+        local->size = 0;
+
+        pthread_barrier_wait(&state->barrier);
+    }
+
+    return NULL;
+}
+
+void parallel_bfs_csr_graph(const csr_graph_t* graph, const csr_graph_t* reverse, uint32_t source, size_t threads,
+    array_list_t* depths, array_list_t* parents)
+{
+    const uint32_t unreached = UNREACHED_BFS_DEPTH;
+    const uint32_t zero = 0;
+
+    *depths = create_array_list(graph->nodes_, sizeof(uint32_t));
+    resize_array_list(depths, graph->nodes_);
+    fill_array_list(depths, &unreached);
+    if (parents != NULL)
+    {
+        *parents = create_array_list(graph->nodes_, sizeof(uint32_t));
+        resize_array_list(parents, graph->nodes_);
+        fill_array_list(parents, &INVALID_ADJGRAPH_NODE);
+    }
+
+    if (!is_valid_node_csr(graph, source))
+        return;
+
+    if (threads == 0)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (size_t)online : 1;
+    }
+
+    bfs_state state;
+    state.graph = graph;
+    state.reverse = reverse;
+    state.depths = (uint32_t*)depths->data_;
+    state.parents = parents != NULL ? (uint32_t*)parents->data_ : NULL;
+    state.visited = create_bitset(graph->nodes_);
+    state.frontier_bits = create_bitset(reverse != NULL ? graph->nodes_ : 0);
+    state.next_bits = create_bitset(reverse != NULL ? graph->nodes_ : 0);
+    state.frontier = (uint32_t*)malloc(graph->nodes_ * sizeof(uint32_t));
+    state.frontier_size = 1;
+    state.cursor = 0;
+    state.unexplored_edges = graph->edges_ - degree_csr_graph(graph, source);
+    state.depth = 0;
+    state.bottom_up = 0;
+    state.was_bottom_up = 0;
+    state.done = 0;
+    state.threads = threads;
+    state.locals = (bfs_local*)aligned_alloc(64, threads * sizeof(bfs_local));
+    memset(state.locals, 0, threads * sizeof(bfs_local));
+    pthread_barrier_init(&state.barrier, NULL, (unsigned)threads);
+
+    state.frontier[0] = source;
+    state.depths[source] = zero;
+    if (state.parents != NULL)
+        state.parents[source] = source;
+    set_bit_bitset(&state.visited, source);
+
+    pthread_t* ids = (pthread_t*)malloc(threads * sizeof(pthread_t));
+    bfs_worker* workers = (bfs_worker*)malloc(threads * sizeof(bfs_worker));
+    for (size_t t = 0; t < threads; ++t)
+    {
+        workers[t].state = &state;
+        workers[t].id = t;
+    }
+    for (size_t t = 1; t < threads; ++t)
+        pthread_create(&ids[t], NULL, run_bfs_worker, &workers[t]);
+    run_bfs_worker(&workers[0]);
+    for (size_t t = 1; t < threads; ++t)
+        pthread_join(ids[t], NULL);
+
+    for (size_t t = 0; t < threads; ++t)
+        free(state.locals[t].nodes);
+    free(state.locals);
+    free(ids);
+    free(workers);
+    free(state.frontier);
+    destroy_bitset(&state.visited);
+    destroy_bitset(&state.frontier_bits);
+    destroy_bitset(&state.next_bits);
+    pthread_barrier_destroy(&state.barrier);
+}
+
+void parallel_bfs_adj_graph(const adjacency_graph_t* graph, uint32_t source, size_t threads, array_list_t* depths, array_list_t* parents)
+{
+    csr_graph_t frozen = freeze_adj_graph(graph);
+    csr_graph_t reverse = transpose_csr_graph(&frozen);
+
+    parallel_bfs_csr_graph(&frozen, &reverse, source, threads, depths, parents);
+
+    destroy_csr_graph(&frozen);
+    destroy_csr_graph(&reverse);
+}
@@ -0,0 +1,75 @@
+#ifndef DATA_PARALLEL_GRAPH_ALGORITHM_H
+#define DATA_PARALLEL_GRAPH_ALGORITHM_H
+
+/**
+ * @file parallel_graph_algorithm.h
+ * @author Edwin Solis (esolis6@gatech.edu)
+ * @brief Multithreaded traversals of graphs
+ * @version 0.1
+ * @date 2021-11-08
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include "adjacency_graph.h"
+#include "csr_graph.h"
+#include "array_list.h"
+
+#include <stdint.h>
+
+/**
+ * @details Implementation
+ * 
+ * The breadth first search is level synchronous: every level the threads expand the current frontier and
+ * meet at a barrier before the next level starts, so the depth of every node is its exact distance in edges.
+ * 
+ * In a top-down step the frontier is an array of node ids split in small chunks that the threads take from a
+ * shared counter. A node is claimed by the thread that sets its bit in the visited bitset with an atomic
+ * operation, and goes to the local frontier of that thread. The local frontiers are copied side by side
+ * into the frontier array of the next level.
+ * 
+ * In a bottom-up step the frontier is a bitset and every unvisited node looks through its incoming edges
+ * for a parent in the frontier, stopping at the first one. The threads take blocks of 64 nodes at a time,
+ * so each bitset word is only written by one thread and no atomic operations are needed.
+ * 
+ * The search switches to bottom-up steps when the edges leaving the frontier are more than a fraction of
+ * the edges not explored yet (the frontier covers a large part of the graph), and back to top-down steps
+ * once the frontier shrinks to a small fraction of the nodes. Bottom-up steps need the incoming edges of the
+ * nodes, given by the transpose of the graph.
+ * 
+ */
+
+/**
+ * @brief Depth of the nodes not reached by the search
+ */
+#define UNREACHED_BFS_DEPTH UINT32_MAX
+
+/**
+ * @brief Traverses the frozen graph in breadth first search order from the given source node using several threads.
+ *        Unreached nodes have a depth of UNREACHED_BFS_DEPTH and a parent of INVALID_ADJGRAPH_NODE,
+ *        the source node is its own parent.
+ * 
+ * @param graph graph to be traversed
+ * @param reverse transpose of the graph (from transpose_csr_graph), NULL to only take top-down steps
+ * @param source id of the source node
+ * @param threads number of threads to be used (0 to use one per online processor)
+ * @param depths pointer where the created list of uint32_t with the depth of each node is stored
+ * @param parents pointer where the created list of uint32_t with the parent of each node is stored (can be NULL)
+ */
+void parallel_bfs_csr_graph(const csr_graph_t* graph, const csr_graph_t* reverse, uint32_t source, size_t threads,
+    array_list_t* depths, array_list_t* parents);
+
+/**
+ * @brief Traverses the graph in breadth first search order from the given source node using several threads.
+ *        The graph is frozen and transposed before the search, see parallel_bfs_csr_graph.
+ * 
+ * @param graph graph to be traversed
+ * @param source id of the source node
+ * @param threads number of threads to be used (0 to use one per online processor)
+ * @param depths pointer where the created list of uint32_t with the depth of each node is stored
+ * @param parents pointer where the created list of uint32_t with the parent of each node is stored (can be NULL)
+ */
+void parallel_bfs_adj_graph(const adjacency_graph_t* graph, uint32_t source, size_t threads, array_list_t* depths, array_list_t* parents);
+
+#endif /* DATA_PARALLEL_GRAPH_ALGORITHM_H */
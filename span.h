@@ -0,0 +1,113 @@
+#ifndef DATA_SPAN_H
+#define DATA_SPAN_H
+
+/**
+ * @file span.h
+ * @author Edwin Solis (edwinsolisf12@gmail.com)
+ * @brief A lightweight view over elements laid out at a constant stride in memory
+ * @version 0.1
+ * @date 2021-11-10
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <stdlib.h>
+
+/**
+ * @details Usage
+ * 
+ * The containers return spans over their contiguous storage (span_array_list, span_astack, span_vector,
+ * row_span_matrix, ...), so hot loops can walk the elements with a pointer and a stride instead of calling an
+ * accessor with a bounds check and a multiply per element.
+ * 
+ * A span is only valid until the container it views is modified.
+ * 
+ * Containers that are not always contiguous (the ordered containers with the B+tree storage) return the run of
+ * elements that starts at a given index, and the loop moves to the next run after count_ elements:
+ * 
+ *     span_t run;
+ *     for (size_t i = 0; i < set.size_; i += run.count_)
+ *     {
+ *         run = span_ordered_set(&set, i);
+ *         for (size_t j = 0; j < run.count_; ++j)
+ *             use(at_span(&run, j));
+ *     }
+ * 
+ */
+
+/**
+ * @brief Struct representing a view over count_ elements, stride_ bytes apart
+ * 
+ * @var begin_ stores the pointer to the first element
+ * @var stride_ stores the distance in bytes between consecutive elements
+ * @var count_ stores the number of elements in the view
+ */
+typedef struct data_span_st
+{
+    void* begin_;
+    size_t stride_;
+    size_t count_;
+} span_t;
+
+/**
+ * @brief Creates a span with the given parameters
+ * 
+ * @param begin pointer to the first element
+ * @param stride distance in bytes between consecutive elements
+ * @param count number of elements
+ * @return span_t
+ */
+static inline span_t create_span(void* begin, size_t stride, size_t count)
+{
+    span_t out;
+
+    out.begin_ = begin;
+    out.stride_ = stride;
+    out.count_ = count;
+
+    return out;
+}
+
+/**
+ * @brief Gets the address of the element at the given index of the span, without bounds checks
+ * 
+ * @param span span to be accessed
+ * @param index index of the element
+ * @return void* pointer to the element
+ */
+static inline void* at_span(const span_t* span, size_t index)
+{
+    return span->begin_ + index * span->stride_;
+}
+
+/**
+ * @brief Gets the address one stride past the last element of the span
+ * 
+ * @param span span to be accessed
+ * @return void* pointer past the end
+ */
+static inline void* end_span(const span_t* span)
+{
+    return span->begin_ + span->count_ * span->stride_;
+}
+
+/**
+ * @brief Returns the span over the elements [first, first + count) of the given span.
+ *        The range is clamped to the elements of the span.
+ * 
+ * @param span span to be divided
+ * @param first index of the first element of the subspan
+ * @param count number of elements of the subspan
+ * @return span_t
+ */
+static inline span_t subspan(const span_t* span, size_t first, size_t count)
+{
+    if (first > span->count_)
+        first = span->count_;
+    if (count > span->count_ - first)
+        count = span->count_ - first;
+    return create_span(at_span(span, first), span->stride_, count);
+}
+
+#endif /* DATA_SPAN_H */
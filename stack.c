@@ -67,6 +67,11 @@ const void* top_astack(const array_stack_t* stack)
     return NULL;
 }
 
+span_t span_astack(const array_stack_t* stack)
+{
+    return create_span(stack->data_, stack->element_size_, stack->size_);
+}
+
 void push_astack(array_stack_t* stack, const void* data)
 {
     if (stack->size_ == stack->capacity_)
@@ -86,31 +91,4 @@ void pop_astack(array_stack_t* stack, void* data)
 int contains_astack(const array_stack_t* stack, const void* element, EQUALS_FUNC equal_func)
 {
     return array_contains(element, stack->data_, stack->size_, stack->element_size_, equal_func);
-}
-
-array_stack_t create_int_astack(size_t capacity)
-{
-    return create_astack(capacity, sizeof(int));
-}
-
-int get_int_astack(const array_stack_t* stack, size_t index)
-{
-    return *(int*)get_element_astack(stack, index);
-}
-
-void set_int_astack(array_stack_t* stack, size_t index, int value)
-{
-    set_element_astack(stack, index, &value);
-}
-
-void push_int_astack(array_stack_t* stack, int value)
-{
-    push_astack(stack, &value);
-}
-
-int pop_int_astack(array_stack_t* stack)
-{
-    int temp;
-    pop_astack(stack, &temp);
-    return temp;
 }
\ No newline at end of file
@@ -15,6 +15,7 @@
 #include <stdlib.h>
 
 #include "algorithm.h"
+#include "span.h"
 
 /**
  * @brief Struct representing an array stack
@@ -99,6 +100,14 @@ void set_element_astack(array_stack_t* stack, size_t index, const void* data);
  */
 const void* top_astack(const array_stack_t* stack);
 
+/**
+ * @brief Returns a span over the elements of the stack from the bottom to the top, valid until the stack is modified
+ * 
+ * @param stack stack to be viewed
+ * @return span_t span of size_ elements
+ */
+span_t span_astack(const array_stack_t* stack);
+
 /**
  * @brief Adds the given element to the stack
  * 
@@ -126,45 +135,58 @@ void pop_astack(array_stack_t* stack, void* data);
 int contains_astack(const array_stack_t* stack, const void* element, EQUALS_FUNC equal_func);
 
 /**
- * @brief Wrapper for creating an int specialized array stack
- * 
- * @param capacity the initial capacity for the stack
- * @return array_stack_t
- */
-array_stack_t create_int_astack(size_t capacity);
-
-/**
- * @brief Getter wrapper for an int specialized array stack
- * 
- * @param stack stack from which the element is retrieved
- * @param index index of the element to be retrieved
- * @return int element retrieved
- */
-int get_int_astack(const array_stack_t* stack, size_t index);
-
-/**
- * @brief Setter wrapper for an int specialized array stack
- * 
- * @param stack stack where the element is set
- * @param index index of the element that will be set
- * @param value new value for the element
- */
-void set_int_astack(array_stack_t* stack, size_t index, int value);
-
-/**
- * @brief Wrapper for pushing an element into an int specialized array stack
- * 
- * @param stack stack in which the element is pushed
- * @param value value that will be pushed into the stack
- */
-void push_int_astack(array_stack_t* stack, int value);
-
-/**
- * @brief Wrapper for removing an element from an int specialized array stack
- * 
- * @param stack stack from which the element is removed
- * @return int value that was removed
- */
-int pop_int_astack(array_stack_t* stack);
+ * @brief Stamps out a typed specialization of the array stack for the element type T.
+ *        The generated functions work on a regular array_stack_t with element_size_ == sizeof(T), so a stack
+ *        can be passed to both the typed and the generic functions, and copy elements with plain assignments.
+ * 
+ * Generated functions, with xxx the given tag:
+ * create_xxx_astack(capacity)
+ * push_xxx_astack(stack, value)
+ * pop_xxx_astack(stack): returns the removed value, or a zeroed T if the stack is empty
+ * top_xxx_astack(stack), get_xxx_astack(stack, index), set_xxx_astack(stack, index, value): without bounds checks
+ * 
+ * @param tag name of the specialization used in the generated function names
+ * @param T type of the elements
+ */
+#define DEFINE_TYPED_ASTACK(tag, T)                                                                             \
+static inline array_stack_t create_##tag##_astack(size_t capacity)                                              \
+{                                                                                                               \
+    return create_astack(capacity, sizeof(T));                                                                  \
+}                                                                                                               \
+                                                                                                                \
+static inline T get_##tag##_astack(const array_stack_t* stack, size_t index)                                    \
+{                                                                                                               \
+    return ((const T*)stack->data_)[index];                                                                     \
+}                                                                                                               \
+                                                                                                                \
+static inline void set_##tag##_astack(array_stack_t* stack, size_t index, T value)                              \
+{                                                                                                               \
+    ((T*)stack->data_)[index] = value;                                                                          \
+}                                                                                                               \
+                                                                                                                \
+static inline T top_##tag##_astack(const array_stack_t* stack)                                                  \
+{                                                                                                               \
+    return ((const T*)stack->data_)[stack->size_ - 1];                                                          \
+}                                                                                                               \
+                                                                                                                \
+static inline void push_##tag##_astack(array_stack_t* stack, T value)                                           \
+{                                                                                                               \
+    if (stack->size_ == stack->capacity_)                                                                       \
+        reserve_astack(stack, next_capacity_astack(stack->capacity_));                                          \
+    ((T*)stack->data_)[stack->size_++] = value;                                                                 \
+}                                                                                                               \
+                                                                                                                \
+static inline T pop_##tag##_astack(array_stack_t* stack)                                                        \
+{                                                                                                               \
+    T out = {0};                                                                                                \
+    if (stack->size_ != 0)                                                                                      \
+        out = ((T*)stack->data_)[--stack->size_];                                                               \
+    return out;                                                                                                 \
+}
+
+/**
+ * @brief int specialization of the array stack (create_int_astack, push_int_astack, pop_int_astack, ...)
+ */
+DEFINE_TYPED_ASTACK(int, int)
 
 #endif /* DATA_STACK_H */
\ No newline at end of file
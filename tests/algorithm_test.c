@@ -0,0 +1,86 @@
+/*
+ * Behavior tests of the searches of the built-in key kinds against a linear reference, for packed keys (the
+ * vectorized scan when the CPU supports AVX2) and for keys followed by other bytes.
+ */
+
+#include "algorithm.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "test.h"
+
+#define MAX_COUNT 48
+#define WIDE_STRIDE 24
+
+static size_t reference_bound(const void* element, const void* array, size_t count, size_t stride, key_kind_t kind, int upper)
+{
+    size_t before = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const void* value = array + i * stride;
+        before += upper ? !less_than_kind(element, value, kind, NULL) : less_than_kind(value, element, kind, NULL);
+    }
+    return before;
+}
+
+static void check_bounds(const void* keys, size_t count, size_t key_size, key_kind_t kind, const void* probes, size_t probe_count)
+{
+    unsigned char wide[MAX_COUNT * WIDE_STRIDE];
+    memset(wide, 0xA5, sizeof(wide));
+    for (size_t i = 0; i < count; ++i)
+        memcpy(wide + i * WIDE_STRIDE, keys + i * key_size, key_size);
+
+    for (size_t p = 0; p < probe_count; ++p)
+    {
+        const void* probe = probes + p * key_size;
+        CHECK(lower_bound_kind(probe, keys, count, key_size, kind, NULL) == reference_bound(probe, keys, count, key_size, kind, 0));
+        CHECK(upper_bound_kind(probe, keys, count, key_size, kind, NULL) == reference_bound(probe, keys, count, key_size, kind, 1));
+        CHECK(lower_bound_kind(probe, wide, count, WIDE_STRIDE, kind, NULL) == reference_bound(probe, wide, count, WIDE_STRIDE, kind, 0));
+        CHECK(upper_bound_kind(probe, wide, count, WIDE_STRIDE, kind, NULL) == reference_bound(probe, wide, count, WIDE_STRIDE, kind, 1));
+        CHECK(sorted_array_contains_kind(probe, keys, count, key_size, kind, NULL)
+            == (reference_bound(probe, keys, count, key_size, kind, 1) != reference_bound(probe, keys, count, key_size, kind, 0)));
+    }
+}
+
+/* Sorted runs with duplicates around the sign bit, where the unsigned kinds differ from the signed ones */
+#define DEFINE_KIND_TEST(type, name, kind, low, step)                                                           \
+static void test_##name(uint64_t* state)                                                                        \
+{                                                                                                               \
+    type keys[MAX_COUNT];                                                                                       \
+    type probes[MAX_COUNT + 2];                                                                                 \
+    for (size_t count = 0; count <= MAX_COUNT; ++count)                                                         \
+    {                                                                                                           \
+        type value = (type)(low);                                                                               \
+        for (size_t i = 0; i < count; ++i)                                                                      \
+        {                                                                                                       \
+            keys[i] = value;                                                                                    \
+            probes[i] = (type)(value + (type)(next_random_test(state) % 2));                                    \
+            if (next_random_test(state) % 3 != 0)                                                               \
+                value = (type)(value + (type)(step));                                                           \
+        }                                                                                                       \
+        probes[count] = (type)(low) - (type)(step);                                                             \
+        probes[count + 1] = value + (type)(step);                                                               \
+        check_bounds(keys, count, sizeof(type), kind, probes, count + 2);                                       \
+    }                                                                                                           \
+}
+
+DEFINE_KIND_TEST(uint32_t, u32, KEY_KIND_UINT32, 0x7FFFFFF0u, 1)
+DEFINE_KIND_TEST(int32_t, i32, KEY_KIND_INT32, -20, 1)
+DEFINE_KIND_TEST(uint64_t, u64, KEY_KIND_UINT64, 0x7FFFFFFFFFFFFFF0ull, 1)
+DEFINE_KIND_TEST(int64_t, i64, KEY_KIND_INT64, -20, 1)
+DEFINE_KIND_TEST(double, f64, KEY_KIND_DOUBLE, -10.0, 0.5)
+
+int main(void)
+{
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (int round = 0; round < 20; ++round)
+    {
+        test_u32(&state);
+        test_i32(&state);
+        test_u64(&state);
+        test_i64(&state);
+        test_f64(&state);
+    }
+    return 0;
+}
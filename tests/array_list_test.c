@@ -0,0 +1,137 @@
+/*
+ * Behavior tests of the array_list: generic and typed insertions, and mapped lists that are reopened from their
+ * file or cannot grow (opened read-only, or their file is limited in size).
+ */
+
+#include "array_list.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include "test.h"
+
+DEFINE_TYPED_ARRAY_LIST(u32, uint32_t)
+
+static const char* MAPPED_PATH = "array_list_test.bin";
+
+static void insertions(void)
+{
+    array_list_t list = create_array_list(0, sizeof(int));
+    for (int i = 0; i < 100; ++i)
+        push_back_array_list(&list, &i);
+    int front = -1;
+    push_front_array_list(&list, &front);
+    int middle = 1000;
+    insert_array_list(&list, 50, &middle);
+
+    CHECK(list.size_ == 102);
+    CHECK(*(int*)get_element_array_list(&list, 0) == -1);
+    CHECK(*(int*)get_element_array_list(&list, 50) == 1000);
+    CHECK(*(int*)get_element_array_list(&list, 49) == 48);
+    CHECK(*(int*)get_element_array_list(&list, 51) == 49);
+    CHECK(*(int*)get_element_array_list(&list, 101) == 99);
+
+    resize_array_list(&list, 1000);
+    CHECK(list.size_ == 1000 && list.capacity_ >= 1000);
+    destroy_array_list(&list);
+
+    array_list_t typed = create_u32_alist(0);
+    for (uint32_t i = 0; i < 100; ++i)
+        push_back_u32_alist(&typed, i);
+    push_front_u32_alist(&typed, 500);
+    insert_u32_alist(&typed, 10, 600);
+    CHECK(typed.size_ == 102);
+    CHECK(get_u32_alist(&typed, 0) == 500 && get_u32_alist(&typed, 10) == 600 && back_u32_alist(&typed) == 99);
+    CHECK(pop_front_u32_alist(&typed) == 500 && remove_u32_alist(&typed, 9) == 600);
+    for (uint32_t i = 0; i < 100; ++i)
+        CHECK(get_u32_alist(&typed, i) == i);
+    destroy_array_list(&typed);
+}
+
+static void mapped_reopen(void)
+{
+    array_list_t list = create_mapped_array_list(MAPPED_PATH, 4, sizeof(uint32_t));
+    CHECK(list.data_ != NULL);
+    for (uint32_t i = 0; i < 10000; ++i)
+        push_back_u32_alist(&list, i * 3);
+    CHECK(list.size_ == 10000);
+    sync_array_list(&list);
+    CHECK(verify_mapped_array_list(&list));
+    destroy_array_list(&list);
+
+    list = open_mapped_array_list(MAPPED_PATH, 0);
+    CHECK(list.data_ != NULL && list.size_ == 10000 && list.element_size_ == sizeof(uint32_t));
+    CHECK(verify_mapped_array_list(&list));
+    for (uint32_t i = 0; i < 10000; ++i)
+        CHECK(get_u32_alist(&list, i) == i * 3);
+    uint32_t value = 7;
+    push_front_array_list(&list, &value);
+    destroy_array_list(&list);
+
+    list = open_mapped_array_list(MAPPED_PATH, 1);
+    CHECK(list.size_ == 10001 && get_u32_alist(&list, 0) == 7 && get_u32_alist(&list, 10000) == 29997);
+
+    /* A list opened read-only cannot grow, the insertions past its capacity are refused */
+    size_t capacity = list.capacity_;
+    CHECK(!reserve_array_list(&list, capacity + 1));
+    list.size_ = capacity;
+    push_back_array_list(&list, &value);
+    push_front_array_list(&list, &value);
+    insert_array_list(&list, 1, &value);
+    push_back_u32_alist(&list, value);
+    insert_u32_alist(&list, 1, value);
+    CHECK(list.size_ == capacity && list.capacity_ == capacity);
+    list.size_ = 10001;
+    destroy_array_list(&list);
+
+    CHECK(open_mapped_array_list("array_list_test_missing.bin", 1).data_ == NULL);
+}
+
+static void mapped_file_limit(void)
+{
+    /* The file cannot grow past the limit, so the list stops growing and refuses the elements it cannot hold */
+    struct rlimit old_limit;
+    getrlimit(RLIMIT_FSIZE, &old_limit);
+    struct rlimit limit = old_limit;
+    limit.rlim_cur = 4096;
+    signal(SIGXFSZ, SIG_IGN);
+    CHECK(setrlimit(RLIMIT_FSIZE, &limit) == 0);
+
+    array_list_t list = create_mapped_array_list(MAPPED_PATH, 16, sizeof(uint32_t));
+    CHECK(list.data_ != NULL);
+    for (uint32_t i = 0; i < 5000; ++i)
+    {
+        if (i % 2)
+            push_back_u32_alist(&list, i);
+        else
+            push_back_array_list(&list, &i);
+    }
+    CHECK(list.size_ <= list.capacity_);
+    CHECK(list.size_ < 5000);
+    for (uint32_t i = 0; i < list.size_; ++i)
+        CHECK(get_u32_alist(&list, i) == i);
+
+    size_t size = list.size_;
+    uint32_t value = 0;
+    push_front_array_list(&list, &value);
+    insert_array_list(&list, 1, &value);
+    insert_u32_alist(&list, 1, value);
+    resize_array_list(&list, list.capacity_ + 1);
+    CHECK(list.size_ == size);
+
+    destroy_array_list(&list);
+    setrlimit(RLIMIT_FSIZE, &old_limit);
+    signal(SIGXFSZ, SIG_DFL);
+}
+
+int main(void)
+{
+    insertions();
+    mapped_reopen();
+    mapped_file_limit();
+    unlink(MAPPED_PATH);
+    return 0;
+}
@@ -0,0 +1,206 @@
+/*
+ * Behavior tests of the B+tree and of the ordered set and map on both backends: order, rank and cursors against
+ * a reference under random insertions and removals.
+ */
+
+#include "btree.h"
+#include "ordered_set.h"
+#include "ordered_map.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "test.h"
+
+#define KEY_RANGE 5000
+
+typedef struct test_record_st
+{
+    uint32_t key;
+    uint32_t value;
+} test_record_t;
+
+static int uint32_less(const void* left, const void* right)
+{
+    return *(const uint32_t*)left < *(const uint32_t*)right;
+}
+
+/* Expected rank of every present key, SIZE_MAX for the missing ones */
+static size_t reference_ranks(const unsigned char* present, size_t* ranks)
+{
+    size_t rank = 0;
+    for (uint32_t key = 0; key < KEY_RANGE; ++key)
+        ranks[key] = present[key] ? rank++ : SIZE_MAX;
+    return rank;
+}
+
+static void check_btree(const btree_t* tree, const unsigned char* present, const uint32_t* values)
+{
+    static size_t ranks[KEY_RANGE];
+    size_t count = reference_ranks(present, ranks);
+    CHECK(tree->size_ == count);
+
+    for (uint32_t key = 0; key < KEY_RANGE; ++key)
+    {
+        const test_record_t* record = (const test_record_t*)find_btree(tree, &key);
+        CHECK((record != NULL) == present[key]);
+        CHECK(index_of_btree(tree, &key) == ranks[key]);
+        if (record != NULL)
+        {
+            CHECK(record->key == key && record->value == values[key]);
+            CHECK(at_index_btree(tree, ranks[key]) == record);
+        }
+    }
+    CHECK(at_index_btree(tree, count) == NULL);
+
+    /* The cursor walks the records in key order, run by run */
+    size_t walked = 0;
+    uint32_t last = 0;
+    btree_cursor_t cursor = begin_btree(tree);
+    for (const test_record_t* record; (record = (const test_record_t*)get_btree_cursor(tree, &cursor)) != NULL; next_btree_cursor(&cursor))
+    {
+        CHECK(run_btree_cursor(&cursor) != 0);
+        CHECK(walked == 0 || record->key > last);
+        last = record->key;
+        ++walked;
+    }
+    CHECK(walked == count);
+
+    for (uint32_t key = 0; key < KEY_RANGE; key += 97)
+    {
+        btree_cursor_t bound = lower_bound_btree(tree, &key);
+        const test_record_t* record = (const test_record_t*)get_btree_cursor(tree, &bound);
+        uint32_t expected = key;
+        while (expected < KEY_RANGE && !present[expected])
+            ++expected;
+        CHECK(expected == KEY_RANGE ? record == NULL : (record != NULL && record->key == expected));
+    }
+}
+
+static void btree_random(uint64_t seed)
+{
+    btree_t tree = create_btree(sizeof(test_record_t), sizeof(uint32_t), uint32_less);
+    static unsigned char present[KEY_RANGE];
+    static uint32_t values[KEY_RANGE];
+    memset(present, 0, sizeof(present));
+    uint64_t state = seed;
+
+    for (size_t i = 0; i < 20000; ++i)
+    {
+        test_record_t record = { (uint32_t)(next_random_test(&state) % KEY_RANGE), (uint32_t)i };
+        /* Mostly insertions first, then mostly removals, so the tree both splits and merges its nodes */
+        if (next_random_test(&state) % 10 < (i < 10000 ? 7u : 3u))
+        {
+            CHECK(insert_btree(&tree, &record) == !present[record.key]);
+            if (!present[record.key])
+                values[record.key] = record.value;
+            present[record.key] = 1;
+        }
+        else
+        {
+            test_record_t removed;
+            CHECK(remove_btree(&tree, &record.key, &removed) == present[record.key]);
+            if (present[record.key])
+                CHECK(removed.key == record.key && removed.value == values[record.key]);
+            present[record.key] = 0;
+        }
+
+        if (i % 2500 == 0)
+            check_btree(&tree, present, values);
+    }
+    check_btree(&tree, present, values);
+
+    clear_btree(&tree);
+    memset(present, 0, sizeof(present));
+    check_btree(&tree, present, values);
+    destroy_btree(&tree);
+}
+
+static void check_ordered(const ordered_set_t* set, const ordered_map_t* map, const unsigned char* present)
+{
+    static size_t ranks[KEY_RANGE];
+    size_t count = reference_ranks(present, ranks);
+    CHECK(set->size_ == count && map->size_ == count);
+
+    for (uint32_t key = 0; key < KEY_RANGE; ++key)
+    {
+        CHECK(contains_ordered_set(set, &key) == present[key]);
+        CHECK(contains_ordered_map(map, &key) == present[key]);
+        if (present[key])
+        {
+            CHECK(index_of_ordered_set(set, &key) == ranks[key]);
+            CHECK(key_index_ordered_map(map, &key) == ranks[key]);
+            CHECK(*(const uint32_t*)get_element_ordered_set(set, ranks[key]) == key);
+            CHECK(*(const uint32_t*)get_key_ordered_map(map, ranks[key]) == key);
+            CHECK(*(const uint64_t*)get_ordered_map(map, &key) == (uint64_t)key * 3);
+        }
+    }
+
+    /* The spans of keys and values cover every element once, in order */
+    size_t index = 0;
+    for (span_t keys; index < count && (keys = keys_span_ordered_map(map, index)).count_ != 0; index += keys.count_)
+    {
+        span_t values = values_span_ordered_map(map, index);
+        span_t elements = span_ordered_set(set, index);
+        CHECK(values.count_ == keys.count_ && elements.count_ != 0);
+        for (size_t i = 0; i < keys.count_; ++i)
+        {
+            uint32_t key = *(const uint32_t*)at_span(&keys, i);
+            CHECK(ranks[key] == index + i);
+            CHECK(*(const uint64_t*)at_span(&values, i) == (uint64_t)key * 3);
+        }
+    }
+    CHECK(index == count);
+}
+
+static void ordered_random(ordered_backend_t backend, uint64_t seed)
+{
+    ordered_set_t set = create_ordered_set(0, sizeof(uint32_t), uint32_less);
+    ordered_map_t map = create_ordered_map(sizeof(uint32_t), sizeof(uint64_t), 0, uint32_less);
+    set_backend_ordered_set(&set, backend);
+    set_backend_ordered_map(&map, backend);
+    static unsigned char present[KEY_RANGE];
+    memset(present, 0, sizeof(present));
+    uint64_t state = seed;
+
+    for (size_t i = 0; i < 12000; ++i)
+    {
+        uint32_t key = (uint32_t)(next_random_test(&state) % KEY_RANGE);
+        uint64_t value = (uint64_t)key * 3;
+        if (next_random_test(&state) % 10 < (i < 6000 ? 7u : 3u))
+        {
+            insert_element_ordered_set(&set, &key);
+            insert_pair_ordered_map(&map, &key, &value);
+            present[key] = 1;
+        }
+        else
+        {
+            remove_element_ordered_set(&set, &key);
+            remove_pair_ordered_map(&map, &key);
+            present[key] = 0;
+        }
+
+        if (i % 3000 == 0)
+            check_ordered(&set, &map, present);
+    }
+    check_ordered(&set, &map, present);
+
+    /* Switching the backend keeps the elements */
+    set_backend_ordered_set(&set, backend == ORDERED_BTREE_BACKEND ? ORDERED_ARRAY_BACKEND : ORDERED_BTREE_BACKEND);
+    set_backend_ordered_map(&map, backend == ORDERED_BTREE_BACKEND ? ORDERED_ARRAY_BACKEND : ORDERED_BTREE_BACKEND);
+    check_ordered(&set, &map, present);
+
+    destroy_ordered_set(&set);
+    destroy_ordered_map(&map);
+}
+
+int main(void)
+{
+    for (uint64_t seed = 1; seed <= 4; ++seed)
+    {
+        btree_random(seed);
+        ordered_random(ORDERED_ARRAY_BACKEND, seed);
+        ordered_random(ORDERED_BTREE_BACKEND, seed);
+    }
+    return 0;
+}
@@ -0,0 +1,277 @@
+/*
+ * Behavior tests of the adjacency graph and the graph files against an adjacency matrix: the index of incoming
+ * edges under random edits, node deletion and id recycling, compaction, and the round trip through a graph file
+ * read back as an adjacency graph and mapped as a CSR graph.
+ */
+
+#include "adjacency_graph.h"
+#include "csr_graph.h"
+#include "graph_file.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "test.h"
+
+#define MAX_NODES 160
+
+static const char* GRAPH_PATH = "graph_test.bin";
+
+typedef struct reference_graph_st
+{
+    size_t nodes;
+    unsigned char valid[MAX_NODES];
+    uint32_t labels[MAX_NODES];
+    unsigned char edges[MAX_NODES][MAX_NODES];
+} reference_graph_t;
+
+static uint64_t edge_value(uint32_t source_label, uint32_t destination_label)
+{
+    return (uint64_t)source_label * 1000003 + destination_label;
+}
+
+static void check_adj_graph(const adjacency_graph_t* graph, const reference_graph_t* reference)
+{
+    CHECK(graph->nodes_ == reference->nodes);
+    for (uint32_t source = 0; source < reference->nodes; ++source)
+    {
+        CHECK(is_valid_node_adj(graph, source) == reference->valid[source]);
+        if (!reference->valid[source])
+        {
+            CHECK(get_edgelist_adj_graph(graph, source)->size_ == 0);
+            continue;
+        }
+        CHECK(*(const uint32_t*)get_node_adj_graph(graph, source) == reference->labels[source]);
+
+        size_t out_degree = 0;
+        size_t in_degree = 0;
+        for (uint32_t other = 0; other < reference->nodes; ++other)
+        {
+            const uint64_t* data = (const uint64_t*)get_edge_adj_graph(graph, source, other);
+            CHECK((data != NULL) == reference->edges[source][other]);
+            if (data != NULL)
+                CHECK(*data == edge_value(reference->labels[source], reference->labels[other]));
+            out_degree += reference->edges[source][other];
+            in_degree += reference->edges[other][source];
+        }
+        CHECK(get_edgelist_adj_graph(graph, source)->size_ == out_degree);
+        CHECK(in_degree_adj_graph(graph, source) == in_degree);
+
+        const ordered_set_t* in_edges = get_in_edges_adj_graph(graph, source);
+        if (graph->in_edges_ != NULL)
+        {
+            CHECK(in_edges->size_ == in_degree);
+            for (size_t i = 0; i < in_edges->size_; ++i)
+            {
+                uint32_t predecessor = *(const uint32_t*)get_element_ordered_set(in_edges, i);
+                CHECK(predecessor < reference->nodes && reference->edges[predecessor][source]);
+            }
+        }
+        else
+            CHECK(in_edges == NULL);
+    }
+}
+
+static void check_csr_graph(const csr_graph_t* graph, const reference_graph_t* reference)
+{
+    CHECK(graph->nodes_ == reference->nodes);
+    for (uint32_t source = 0; source < reference->nodes; ++source)
+    {
+        CHECK(is_valid_node_csr(graph, source) == reference->valid[source]);
+        if (reference->valid[source])
+            CHECK(*(const uint32_t*)get_node_csr_graph(graph, source) == reference->labels[source]);
+
+        size_t degree = 0;
+        for (uint32_t other = 0; other < reference->nodes; ++other)
+        {
+            const uint64_t* data = (const uint64_t*)get_edge_csr_graph(graph, source, other);
+            CHECK((data != NULL) == reference->edges[source][other]);
+            if (data != NULL)
+                CHECK(*data == edge_value(reference->labels[source], reference->labels[other]));
+            degree += reference->edges[source][other];
+        }
+        CHECK(degree_csr_graph(graph, source) == degree);
+    }
+}
+
+static void add_edge(adjacency_graph_t* graph, reference_graph_t* reference, uint32_t source, uint32_t destination)
+{
+    uint64_t data = edge_value(reference->labels[source], reference->labels[destination]);
+    add_edge_adj_graph(graph, source, destination, &data);
+    reference->edges[source][destination] = 1;
+}
+
+static void delete_node(adjacency_graph_t* graph, reference_graph_t* reference, uint32_t id)
+{
+    delete_node_adj_agraph(graph, id);
+    reference->valid[id] = 0;
+    for (uint32_t other = 0; other < reference->nodes; ++other)
+    {
+        reference->edges[id][other] = 0;
+        reference->edges[other][id] = 0;
+    }
+}
+
+static void random_edits(adjacency_graph_t* graph, reference_graph_t* reference, uint64_t* state, size_t operations)
+{
+    static uint32_t next_label = 1;
+    for (size_t i = 0; i < operations; ++i)
+    {
+        uint32_t source = (uint32_t)(next_random_test(state) % reference->nodes);
+        uint32_t destination = (uint32_t)(next_random_test(state) % reference->nodes);
+        uint64_t choice = next_random_test(state) % 100;
+        if (choice < 90 && (!reference->valid[source] || !reference->valid[destination]))
+            continue;
+
+        if (choice < 60)
+            add_edge(graph, reference, source, destination);
+        else if (choice < 85)
+        {
+            delete_edge_adj_graph(graph, source, destination);
+            reference->edges[source][destination] = 0;
+        }
+        else if (choice < 90)
+        {
+            disconnect_allto_adj_graph(graph, destination);
+            for (uint32_t other = 0; other < reference->nodes; ++other)
+                reference->edges[other][destination] = 0;
+        }
+        else if (choice < 95)
+        {
+            if (reference->valid[source])
+                delete_node(graph, reference, source);
+        }
+        else if (reference->nodes < MAX_NODES || graph->free_nodes_.size_ != 0)
+        {
+            /* A new node takes the id of the last deleted node before the graph grows */
+            uint32_t label = next_label++;
+            uint32_t expected = graph->free_nodes_.size_ != 0
+                ? ((const uint32_t*)graph->free_nodes_.data_)[graph->free_nodes_.size_ - 1] : (uint32_t)reference->nodes;
+            uint32_t id = add_node_adj_graph(graph, &label);
+            CHECK(id == expected);
+            if (id == reference->nodes)
+                ++reference->nodes;
+            reference->valid[id] = 1;
+            reference->labels[id] = label;
+        }
+    }
+}
+
+static void compact(adjacency_graph_t* graph, reference_graph_t* reference)
+{
+    array_list_t new_ids = compact_adj_graph(graph);
+    CHECK(new_ids.size_ == reference->nodes);
+
+    static reference_graph_t compacted;
+    memset(&compacted, 0, sizeof(compacted));
+    uint32_t next = 0;
+    for (uint32_t id = 0; id < reference->nodes; ++id)
+    {
+        uint32_t new_id = *(const uint32_t*)get_element_array_list(&new_ids, id);
+        /* The valid nodes keep their order, the deleted ones disappear */
+        CHECK(new_id == (reference->valid[id] ? next : INVALID_ADJGRAPH_NODE));
+        if (!reference->valid[id])
+            continue;
+        compacted.valid[next] = 1;
+        compacted.labels[next] = reference->labels[id];
+        ++next;
+    }
+    compacted.nodes = next;
+    for (uint32_t source = 0; source < reference->nodes; ++source)
+    {
+        for (uint32_t destination = 0; destination < reference->nodes; ++destination)
+        {
+            if (reference->edges[source][destination])
+            {
+                uint32_t new_source = *(const uint32_t*)get_element_array_list(&new_ids, source);
+                uint32_t new_destination = *(const uint32_t*)get_element_array_list(&new_ids, destination);
+                compacted.edges[new_source][new_destination] = 1;
+            }
+        }
+    }
+    destroy_array_list(&new_ids);
+    *reference = compacted;
+    CHECK(graph->free_nodes_.size_ == 0);
+}
+
+static void round_trip(const adjacency_graph_t* graph, const reference_graph_t* reference)
+{
+    const graph_file_encoding_t encodings[] = { GRAPH_FILE_VARINT_DESTINATIONS, GRAPH_FILE_RAW_DESTINATIONS };
+    for (size_t e = 0; e < 2; ++e)
+    {
+        CHECK(save_adj_graph(graph, GRAPH_PATH, encodings[e]));
+        adjacency_graph_t loaded = load_adj_graph(GRAPH_PATH);
+        CHECK(loaded.data_ != NULL);
+        check_adj_graph(&loaded, reference);
+        destroy_adj_graph(&loaded);
+
+        csr_graph_t mapped = open_mapped_csr_graph(GRAPH_PATH);
+        CHECK(mapped.mapping_ != NULL);
+        CHECK(verify_mapped_csr_graph(&mapped));
+        check_csr_graph(&mapped, reference);
+
+        /* A CSR graph written again reads back the same */
+        CHECK(save_csr_graph(&mapped, "graph_test_csr.bin", encodings[1 - e]));
+        destroy_csr_graph(&mapped);
+        csr_graph_t copy = open_mapped_csr_graph("graph_test_csr.bin");
+        CHECK(copy.mapping_ != NULL);
+        check_csr_graph(&copy, reference);
+        destroy_csr_graph(&copy);
+    }
+
+    csr_graph_t frozen = freeze_adj_graph(graph);
+    check_csr_graph(&frozen, reference);
+    destroy_csr_graph(&frozen);
+}
+
+static void random_graph(int in_edge_index, uint64_t seed)
+{
+    static reference_graph_t reference;
+    memset(&reference, 0, sizeof(reference));
+    adjacency_graph_t graph = create_adj_graph(0, sizeof(uint32_t), sizeof(uint64_t));
+    set_in_edge_index_adj_graph(&graph, in_edge_index);
+    uint64_t state = seed;
+
+    for (uint32_t id = 0; id < MAX_NODES / 2; ++id)
+    {
+        uint32_t label = 100000 + id;
+        CHECK(add_node_adj_graph(&graph, &label) == id);
+        reference.valid[id] = 1;
+        reference.labels[id] = label;
+    }
+    reference.nodes = MAX_NODES / 2;
+
+    for (int round = 0; round < 6; ++round)
+    {
+        random_edits(&graph, &reference, &state, 3000);
+        check_adj_graph(&graph, &reference);
+        round_trip(&graph, &reference);
+
+        /* Turning the index on (or off) rebuilds it from the current edges */
+        if (round == 2)
+        {
+            set_in_edge_index_adj_graph(&graph, !in_edge_index);
+            check_adj_graph(&graph, &reference);
+        }
+        if (round % 2 == 1)
+        {
+            compact(&graph, &reference);
+            check_adj_graph(&graph, &reference);
+            round_trip(&graph, &reference);
+        }
+    }
+    destroy_adj_graph(&graph);
+}
+
+int main(void)
+{
+    for (uint64_t seed = 1; seed <= 3; ++seed)
+    {
+        random_graph(0, seed);
+        random_graph(1, seed);
+    }
+    unlink(GRAPH_PATH);
+    unlink("graph_test_csr.bin");
+    return 0;
+}
@@ -0,0 +1,141 @@
+/*
+ * Behavior tests of the hash_map: lookups against a reference under random insertions and removals, with the
+ * built-in hash and with degenerate user hashes whose probe sequences run past the saturated control byte.
+ */
+
+#include "hash_map.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "test.h"
+
+/* Half the keys are present on average, close to the load limit of a 1024 slot table */
+#define KEY_RANGE 1780
+
+/* Arbitrary hash values, so the home slots of the groups of keys are close enough for their probes to interleave */
+static size_t two_values_hash(const void* key)
+{
+    static const size_t values[] = { 349, 509 };
+    return values[*(const uint32_t*)key % 2];
+}
+
+static size_t three_values_hash(const void* key)
+{
+    static const size_t values[] = { 934, 86, 547 };
+    return values[*(const uint32_t*)key % 3];
+}
+
+static int uint32_equal(const void* left, const void* right)
+{
+    return *(const uint32_t*)left == *(const uint32_t*)right;
+}
+
+static void check_against_reference(const hash_map_t* map, const unsigned char* present, const uint64_t* values)
+{
+    size_t count = 0;
+    for (uint32_t key = 0; key < KEY_RANGE; ++key)
+    {
+        const void* value = get_hash_map(map, &key);
+        CHECK((value != NULL) == present[key]);
+        CHECK(contains_hash_map(map, &key) == present[key]);
+        if (value != NULL)
+            CHECK(memcmp(value, &values[key], sizeof(uint64_t)) == 0);
+        count += present[key];
+    }
+    CHECK(map->size_ == count);
+
+    size_t iterated = 0;
+    for (size_t slot = next_slot_hash_map(map, 0); slot != SIZE_MAX; slot = next_slot_hash_map(map, slot + 1))
+    {
+        uint32_t key = *(const uint32_t*)get_key_hash_map(map, slot);
+        CHECK(key < KEY_RANGE && present[key]);
+        ++iterated;
+    }
+    CHECK(iterated == count);
+}
+
+static void random_operations(HASH_FUNC hash, EQUALS_FUNC equal, uint64_t seed, size_t operations)
+{
+    hash_map_t map = create_hash_map(sizeof(uint32_t), sizeof(uint64_t), 0, hash, equal);
+    unsigned char present[KEY_RANGE];
+    uint64_t values[KEY_RANGE];
+    memset(present, 0, sizeof(present));
+    uint64_t state = seed;
+
+    for (size_t i = 0; i < operations; ++i)
+    {
+        uint32_t key = (uint32_t)(next_random_test(&state) % KEY_RANGE);
+        uint64_t value = next_random_test(&state);
+        switch (next_random_test(&state) % 4)
+        {
+        case 0:
+        case 1:
+            insert_pair_hash_map(&map, &key, &value);
+            if (!present[key])
+                values[key] = value;
+            present[key] = 1;
+            break;
+        case 2:
+            remove_pair_hash_map(&map, &key);
+            present[key] = 0;
+            break;
+        default:
+        {
+            uint64_t extracted = 0;
+            extract_pair_hash_map(&map, &key, &extracted);
+            if (present[key])
+                CHECK(extracted == values[key]);
+            present[key] = 0;
+            break;
+        }
+        }
+
+        if (i % 256 == 0)
+            check_against_reference(&map, present, values);
+    }
+    check_against_reference(&map, present, values);
+
+    /* The table only grows with its load, even when every key shares one of a few hashes */
+    CHECK(map.capacity_ <= 2 * KEY_RANGE);
+
+    for (uint32_t key = 0; key < KEY_RANGE; ++key)
+    {
+        remove_pair_hash_map(&map, &key);
+        present[key] = 0;
+    }
+    check_against_reference(&map, present, values);
+    destroy_hash_map(&map);
+}
+
+static void wide_values(void)
+{
+    /* Values much larger than a stack frame of scratch space */
+    const size_t value_size = 1 << 20;
+    hash_map_t map = create_hash_map(sizeof(uint32_t), value_size, 0, NULL, NULL);
+    unsigned char* value = (unsigned char*)malloc(value_size);
+    for (uint32_t key = 0; key < 16; ++key)
+    {
+        memset(value, (int)key, value_size);
+        insert_pair_hash_map(&map, &key, value);
+    }
+    for (uint32_t key = 0; key < 16; ++key)
+    {
+        const unsigned char* stored = (const unsigned char*)get_hash_map(&map, &key);
+        CHECK(stored != NULL && stored[0] == key && stored[value_size - 1] == key);
+    }
+    free(value);
+    destroy_hash_map(&map);
+}
+
+int main(void)
+{
+    for (uint64_t seed = 1; seed <= 20; ++seed)
+    {
+        random_operations(NULL, NULL, seed, 4000);
+        random_operations(two_values_hash, uint32_equal, seed, 4000);
+        random_operations(three_values_hash, uint32_equal, seed, 4000);
+    }
+    wide_values();
+    return 0;
+}
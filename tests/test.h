@@ -0,0 +1,32 @@
+#ifndef DATA_TEST_H
+#define DATA_TEST_H
+
+/*
+ * Minimal checks for the behavior tests: a failed check prints its location and ends the test with a failure.
+ * The tests are built in release mode too, so they do not rely on assert.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CHECK(condition)                                                                        \
+    do                                                                                          \
+    {                                                                                           \
+        if (!(condition))                                                                       \
+        {                                                                                       \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);       \
+            exit(EXIT_FAILURE);                                                                 \
+        }                                                                                       \
+    } while (0)
+
+/* Small deterministic generator so a failure can be reproduced from its seed */
+static inline uint64_t next_random_test(uint64_t* state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+#endif /* DATA_TEST_H */
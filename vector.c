@@ -68,6 +68,11 @@ void fill_vector(vector_t* vector, const void* data)
         set_element_vector(vector, i, data);
 }
 
+span_t span_vector(const vector_t* vector)
+{
+    return create_span(vector->data_, vector->element_size_, vector->dimensions_);
+}
+
 vector_t create_int_vector(size_t dimensions, const int* data)
 {
     return create_vector(dimensions, sizeof(int), data);
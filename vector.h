@@ -3,6 +3,8 @@
 
 #include <stdlib.h>
 
+#include "span.h"
+
 typedef struct data_vector_st
 {
     size_t dimensions_;
@@ -22,6 +24,8 @@ void set_element_vector(vector_t* vector, size_t index, const void* data);
 
 void fill_vector(vector_t* vector, const void* data);
 
+span_t span_vector(const vector_t* vector);
+
 vector_t create_int_vector(size_t dimensions, const int* data);
 int get_int_vector(const vector_t* vector, size_t index);
 void set_int_vector(vector_t* vector, size_t index, int value);